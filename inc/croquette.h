@@ -24,9 +24,13 @@
 #ifndef CROQUETTE_H
 #define CROQUETTE_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 // Default Values
 #define CROQUETTE_DEFAULT_INITIAL_SIZE 11
-#define MAX_KEY_SIZE 255    // Max characters per Key
+#define CROQUETTE_DEFAULT_SEED 0    // Seed used for croquette_hash() when a fixed seed is requested
+#define MAX_KEY_SIZE 255    // Max characters per Key (longer Keys are C_Invalid_Key)
 
 typedef enum croquette_action {
   C_Insert = 0,
@@ -39,9 +43,58 @@ enum croquette_returns {
 };
 
 enum croquette_defaults {
-  C_Default_Capacity = 0
+  C_Default_Capacity = 0,
+  C_Default_Max_Load = 75,   ///< Percent load that doubles a Separate Chaining table
+  C_Default_Min_Load = 25,   ///< Percent load that halves a Separate Chaining table
+  C_Max_Small_Size = 64,     ///< Most Keys a small map holds before upgrading
+  C_Max_Segments = 1024      ///< Most Segments of a segmented Croquette
 };
 
+typedef enum croquette_capacity_mode {
+  C_Capacity_Exact = 0,   ///< Capacity as given, Index is hash % capacity
+  C_Capacity_Pow2 = 1     ///< Capacity rounded up to a Power of Two, Index is a mask of the hash
+} Croquette_Capacity_Mode_e;
+
+typedef enum croquette_allocator {
+  C_Alloc_Malloc = 0,     ///< Each Entry and Key is allocated with malloc()
+  C_Alloc_Slab = 1        ///< Entries and Keys come from private slabs; clear/destroy release whole slabs
+} Croquette_Allocator_e;
+
+/**
+ * @brief Table engine of a Croquette; every engine is behind the same API.
+ *
+ * Only C_Backend_Chained supports rehash_step, max_load, min_load and lock_free_reads.
+ */
+typedef enum croquette_backend_kind {
+  /** Separate Chaining: a linked chain of Entries per Index. */
+  C_Backend_Chained = 0,
+  /** Open Addressing: Robin Hood linear probing over one contiguous slot array.
+   *  Keeps Power of Two capacities and runs at load factors up to 0.9. */
+  C_Backend_RobinHood = 1,
+  /** Open Addressing: SwissTable style, 16 control bytes matched at once (SSE2).
+   *  The control bytes hold 7 bits of each hash, so most misses never read a Key. */
+  C_Backend_Swiss = 2,
+  /** Cuckoo Hashing: two 4-way buckets per Key, so a lookup reads at most two 64 byte buckets.
+   *  Grows only when an insert cannot displace its way to a free slot (an insert failure in
+   *  croquette_h_stats()) and the buckets are at least half full.  Otherwise (e.g. many Keys
+   *  with one hash) the Entry goes to a stash that lookups scan after the two buckets. */
+  C_Backend_Cuckoo = 3,
+  /** Bucketized Chaining: chains of 64 byte lines holding 7 (hash tag, Entry) pairs each, so a
+   *  short chain is one line read.  Doubles past 4 Keys per Index on average. */
+  C_Backend_Bucketized = 4,
+  /** Compact: dense Entries in insertion order (the order of croquette_foreach()) plus a sparse
+   *  8/16/32 bit index.  Keys live in one arena, so nothing is allocated per Entry and the
+   *  allocator setting does not apply. */
+  C_Backend_Compact = 5,
+  /** Split-Ordered List: one lock-free list sorted by reversed hash bits; each bucket is a
+   *  shortcut into it, added on first use.  Non-blocking: every function works without any
+   *  lock from any number of threads (thread_safe is implied), and doubling the buckets moves
+   *  no Entry.  Never shrinks (shrink_to_fit does nothing, clear() keeps the buckets); removed
+   *  Entries and replaced Values (do_free) are reclaimed by epochs.  The allocator setting does
+   *  not apply, and small_size is not supported. */
+  C_Backend_SplitOrdered = 6
+} Croquette_Backend_e;
+
 enum croquette_dofree {
   C_No_Free = 0,
   C_Do_Free = 1,
@@ -62,10 +115,116 @@ typedef enum croquette_error_codes {
   C_FreeValue_Missing,
   C_ValueCompare_Missing,
   C_Exists,
+  C_Invalid_Config,
   C_No_Such_Error,
   C_Num_Errors
 } Croquette_Error_Code_e;
 
+/**
+ * @brief Handle to an independent Croquette instance.
+ *
+ * The structure is private to croquette.c; use croquette_new() and croquette_delete().
+ */
+typedef struct croquette_struct croquette_t;
+
+/**
+ * @brief Function to hash a Key of len bytes with a seed.
+ *
+ * Keys that are equal under the key_equal function must produce equal hashes.
+ */
+typedef uint64_t (*Croquette_Hash_f)(const char *key, size_t len, uint64_t seed);
+
+/**
+ * @brief Function to compare two Keys, returns True (non-zero) if the Keys are equal.
+ */
+typedef int (*Croquette_KeyEqual_f)(const char *key1, size_t len1, const char *key2, size_t len2);
+
+/**
+ * @brief Function called for each Entry by croquette_foreach(); returns non-zero to stop early.
+ */
+typedef int (*Croquette_Visit_f)(const char *key, size_t len, void *value, void *arg);
+
+/**
+ * @struct Croquette_Config_s
+ *
+ * @brief Configuration for creating a Croquette (see croquette_config_init())
+ *
+ * Start from croquette_config_init() and change only the options needed.  Each field notes
+ * its constraints; croquette_new_config() fails with C_Invalid_Config on any it breaks.
+ */
+typedef struct croquette_config {
+  int initial_capacity;                     ///< Initial Capacity or 0 for Default Capacity.
+  int do_free;                              ///< C_Do_Free or C_No_Free for removed Values.
+  void (*free_value)(void *value);          ///< Function to free a Value if do_free is set.
+  int (*value_compare)(const void *value1, const void *value2); ///< Function to compare two Values (required).
+  Croquette_Hash_f hash_fn;                 ///< Function to hash Keys, NULL for croquette_hash().
+  Croquette_KeyEqual_f key_equal;           ///< Function to compare Keys, NULL for byte-wise compare.
+  uint64_t seed;                            ///< Seed passed to the hash function if fixed_seed is set.
+  /** Boolean: hash with seed as given (reproducible benchmarks).  By default every instance
+   *  hashes with a fresh random seed (from getrandom()), so colliding Keys cannot be precomputed. */
+  int fixed_seed;
+  Croquette_Capacity_Mode_e capacity_mode;  ///< C_Capacity_Exact (default) or C_Capacity_Pow2.
+  /** Indices migrated per operation for Incremental Rehash (0 = all at once, the default).
+   *  Above 0, the old and new tables coexist during a resize, lookups consult both, and every
+   *  get/put/remove migrates up to rehash_step Indices.  C_Backend_Chained only; not with
+   *  lock_free_reads. */
+  int rehash_step;
+  /** C_Alloc_Malloc (default) or C_Alloc_Slab.  Slabs pack Entries and Keys with free lists for
+   *  reuse, so clear() and destroy release whole slabs instead of freeing Entry by Entry.  Does
+   *  not apply to C_Backend_Compact or C_Backend_SplitOrdered. */
+  Croquette_Allocator_e allocator;
+  Croquette_Backend_e backend;              ///< Table engine, C_Backend_Chained by default (see Croquette_Backend_e).
+  /** Percent load that doubles the table (C_Default_Max_Load).  C_Backend_Chained only; other
+   *  Backends keep their own loads. */
+  int max_load;
+  /** Percent load that halves the table (C_Default_Min_Load).  Must be under half of max_load,
+   *  so the load right after a resize is between the two and one resize never immediately
+   *  triggers the opposite one.  Sizes that keep swinging by more than the gap still resize on
+   *  every swing.  C_Backend_Chained only. */
+  int min_load;
+  int auto_shrink;                          ///< Boolean: removals halve the table (default 1); if 0, call croquette_shrink_to_fit().
+  /** Keys kept in a flat array scanned linearly before using backend (0 = off, up to
+   *  C_Max_Small_Size).  The map is one allocation with no Index until the next insert past
+   *  small_size upgrades it to backend for good; capacity reads small_size until then.  Suited
+   *  to the many maps that only ever hold a handful of Keys.  Not with lock_free_reads or
+   *  C_Backend_SplitOrdered. */
+  int small_size;
+  /** Boolean: guard every function with a reader-writer lock (default 0).  Lookups, size and
+   *  foreach share it; changes hold it alone.  A Value returned by a lookup may still be freed by
+   *  a concurrent removal (do_free) or update, and foreach visitors must not call back into the
+   *  same Croquette. */
+  int thread_safe;
+  /** Lock striped Segments, a Power of Two up to C_Max_Segments (0 = one table).  Each Segment
+   *  is a thread safe table with its own lock and its own resizing, picked by the top bits of a
+   *  remix of the Key's hash (so Backends reading any bits of the hash still see them vary
+   *  within a Segment).  Changes to Keys in different Segments proceed in parallel.  Whole-map
+   *  functions (size, clear, foreach, reserve...) visit the Segments one at a time, so they are
+   *  not a single snapshot while other threads change the map.  croquette_sharded_new() creates
+   *  the same from a shard count; croquette_h_shard_stats() reports each shard. */
+  int segments;
+  /** Boolean: get, getOrDefault and containsKey take no lock while writers change the table
+   *  (default 0, implies thread_safe).  Removed Entries and replaced tables are reclaimed only
+   *  once every reader that might still see them has finished (epoch based reclamation), and a
+   *  resize copies the Entries instead of relinking them.  Other functions still lock.
+   *  C_Backend_Chained only; not with rehash_step or small_size. */
+  int lock_free_reads;
+} Croquette_Config_s;
+
+/**
+ * @struct Croquette_Stats_s
+ *
+ * @brief Occupancy and insert counters of a Croquette (see croquette_h_stats())
+ *
+ * Loads are reported in permille (size * 1000 / capacity) to stay integer-only.
+ */
+typedef struct croquette_stats {
+  int size;                                 ///< Number of Keys.
+  int capacity;                             ///< Number of Indices or slots.
+  int load_permille;                        ///< Load factor in thousandths.
+  long inserts;                             ///< New Keys inserted since creation.
+  long insert_failures;                     ///< Inserts that could not be placed in either bucket (Cuckoo; resized or stashed).
+} Croquette_Stats_s;
+
 
 // Shared Prototypes
 /**
@@ -74,8 +233,8 @@ typedef enum croquette_error_codes {
  * Creates a new Croquette to store generic Values with String based Keys.
  * If do_free is True, then free_value is needed.  If not, it should be set to NULL.
  * Rules for Croquette
- * - Doubles when size > (initial_capacity>>1 + initial_capacity>>2)
- * - Halves when size < (initial_capcity>>2);
+ * - Doubles when size > 75% of capacity
+ * - Halves when size < 25% of capacity
  * - Resets to initial_capacity on clear()
  *
  * @param initial_capacity Initial Capacity or 0 for Default Capacity for Croquette.
@@ -136,6 +295,17 @@ int croquette_containsValue(void *value);
  * @return NULL if No Such Key or any Errors (Error String Available)
  */
 void *croquette_get(const char *key);
+/**
+ * @brief Gets the value for a given key of known length. Will not Free the Value Returned.
+ *
+ * Length-aware variant for Keys whose length is already known; the Key is never scanned.
+ *
+ * @param key Key bytes to get the value of (need not be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @return void *value if Key Exists
+ * @return NULL if No Such Key or any Errors (Error String Available)
+ */
+void *croquette_get_n(const char *key, size_t len);
 /**
  * @brief Gets the value for a given key. Will not Free the Value Returned.
  *
@@ -154,6 +324,18 @@ void *croquette_getOrDefault(const char *key, void *default_value);
  * @return C_Error on Error (Error String Available)
  */
 int croquette_put(const char *key, void *value);
+/**
+ * @brief Add a new Value to Croquette by a Key of known length
+ *
+ * Length-aware variant for Keys whose length is already known; the Key is never scanned.
+ *
+ * @param key Key bytes to add to the croquette (need not be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Update/Add
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_put_n(const char *key, size_t len, void *value);
 /**
  * @brief Add a new Value to Croquette by Key only if Key has no Value
  *
@@ -190,10 +372,77 @@ int croquette_clear();
  * @return C_Error on any Failure (Error string set).
  */
 int croquette_remove(const char *key);
+/**
+ * @brief Removes an Entry in Croquette by a Key of known length, will Rehash if needed after.
+ *
+ * Length-aware variant for Keys whose length is already known; the Key is never scanned.
+ *
+ * @param key Key bytes to identify which entry to remove (need not be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_remove_n(const char *key, size_t len);
 /**
  * @brief [Convenience Function] Prints all Keys (and their Indices)
  */
 void croquette_print_keys();
+/**
+ * @brief Grows the default Croquette once so n Keys fit without another resize
+ *
+ * Never shrinks.  Removals may still shrink the table again unless the capacity is pinned.
+ *
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_reserve(int n);
+/**
+ * @brief Pins the current capacity as the floor: removals never shrink below it, clear() keeps it
+ *
+ * Capacity reserved while pinned raises the floor.  Use croquette_unpin_capacity() to release it.
+ *
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_pin_capacity();
+/**
+ * @brief Releases a pinned capacity; the table may shrink again and clear() resets to the base capacity
+ *
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_unpin_capacity();
+/**
+ * @brief Shrinks the default Croquette to the smallest capacity that holds its Keys
+ *
+ * The smallest capacity within the load limits, never below the base (or pinned) capacity.
+ * Use with auto_shrink = 0 to decide when to shrink instead of shrinking on removals.
+ *
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_shrink_to_fit();
+/**
+ * @brief Calls visit on every Entry (Key, length, Value and arg) until it returns non-zero
+ *
+ * The order depends on the Backend (C_Backend_Compact visits in insertion order).
+ * visit must not modify the Croquette.
+ *
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return C_Success on Success (including stopping early)
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_foreach(Croquette_Visit_f visit, void *arg);
+/**
+ * @brief Gets the Occupancy and insert counters
+ *
+ * @param stats Filled in with the current values.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_stats(Croquette_Stats_s *stats);
 
 /**
  * @brief [Convenience Function] Prints a Description for the given Croquette Error.
@@ -214,4 +463,185 @@ void croquette_set_error(Croquette_Error_Code_e error);
  */
 Croquette_Error_Code_e croquette_get_error();
 
+/**
+ * @brief Computes the 64-bit Hash Code Croquette uses for Keys
+ *
+ * A wyhash-family hash that consumes the key a word at a time and mixes with full-width
+ * multiplies, so long keys sharing a prefix or suffix still spread over all buckets.
+ *
+ * @param key The key bytes to hash (does not need to be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @param seed Seed to perturb the hash with.  Each instance hashes its Keys with its own random
+ *   seed, or with config seed if fixed_seed is set (such as CROQUETTE_DEFAULT_SEED).
+ * @return The 64-bit Hash Code of the Key
+ */
+uint64_t croquette_hash(const char *key, size_t len, uint64_t seed);
+
+// Handle Prototypes (Multiple Instances)
+/**
+ * @brief Creates a new, independent Croquette instance
+ *
+ * Same rules and parameters as croquette_create(), but any number of instances may exist.
+ * Instances share no state, so each may be sized for its own workload and used privately
+ * by a single thread without synchronization.  The error state is tracked per thread.
+ *
+ * @param initial_capacity Initial Capacity or 0 for Default Capacity for Croquette.
+ * @param do_free Croquette_NoFree_Value or Croquette_Free_Value to select if it should free on removal.
+ * @param free_value Function to free the value if @p do_free is Croquette_Free_Value.
+ * @param value_compare Function to compare values: Returns 0 if equal, <0 if v1 < v2, >0 is v1 > v2
+ * @return Handle to the new Croquette on Success
+ * @return NULL on Error (Error String Available)
+ */
+croquette_t *croquette_new(int initial_capacity, 
+                           int do_free, 
+                           void (*free_value)(void *value),
+                           int (*value_compare)(const void *value1, const void *value2));
+/**
+ * @brief Sets a Croquette Configuration to the Defaults
+ *
+ * @param config The Configuration to initialize; value_compare must still be set before use.
+ */
+void croquette_config_init(Croquette_Config_s *config);
+/**
+ * @brief Creates a new, independent Croquette instance from a Configuration
+ *
+ * @param config The Configuration (see croquette_config_init()).
+ * @return Handle to the new Croquette on Success
+ * @return NULL on Error (Error String Available)
+ */
+croquette_t *croquette_new_config(const Croquette_Config_s *config);
+/**
+ * @brief Creates a sharded Croquette: shards independent tables, each Key routed by a remix of its hash
+ *
+ * The same as croquette_new_config() with config->segments set to shards (routing as described
+ * for segments in Croquette_Config_s, so Backend hash tags stay selective).  Every shard has its
+ * own lock, allocator and resizing, so one resize touches only one shard's Entries; the handle
+ * works with every croquette_h_ function, and whole-map ones (size, clear, containsValue...)
+ * visit each shard in turn.
+ *
+ * @param shards Number of shards, a Power of Two from 1 to C_Max_Segments.
+ * @param config The Configuration for every shard (see croquette_config_init()); its segments is ignored.
+ * @return Handle to the new Croquette on Success
+ * @return NULL on Error (Error String Available)
+ */
+croquette_t *croquette_sharded_new(int shards, const Croquette_Config_s *config);
+/**
+ * @brief Initialize the default Croquette from a Configuration
+ *
+ * @param config The Configuration (see croquette_config_init()).
+ * @return C_Success on Success
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_create_config(const Croquette_Config_s *config);
+/**
+ * @brief Clears and Frees all Entries in a Croquette instance, then Frees the instance
+ *
+ * @param croquette Handle to the Croquette to delete (NULL is ignored).
+ */
+void croquette_delete(croquette_t *croquette);
+/**
+ * @brief Checks if a Croquette instance is Empty (see croquette_isEmpty())
+ */
+int croquette_h_isEmpty(croquette_t *croquette);
+/**
+ * @brief Gets the number of K,V entries in a Croquette instance (see croquette_size())
+ */
+int croquette_h_size(croquette_t *croquette);
+/**
+ * @brief Gets the current number of Indices in a Croquette instance (see croquette_capacity())
+ */
+int croquette_h_capacity(croquette_t *croquette);
+/**
+ * @brief Checks if a Croquette instance contains a Key (see croquette_containsKey())
+ */
+int croquette_h_containsKey(croquette_t *croquette, const char *key);
+/**
+ * @brief Checks if a Croquette instance contains a Value (see croquette_containsValue())
+ */
+int croquette_h_containsValue(croquette_t *croquette, void *value);
+/**
+ * @brief Gets the value for a given key in a Croquette instance (see croquette_get())
+ */
+void *croquette_h_get(croquette_t *croquette, const char *key);
+/**
+ * @brief Gets the value for a given key of known length in a Croquette instance (see croquette_get_n())
+ */
+void *croquette_h_get_n(croquette_t *croquette, const char *key, size_t len);
+/**
+ * @brief Gets the value or a default for a given key in a Croquette instance (see croquette_getOrDefault())
+ */
+void *croquette_h_getOrDefault(croquette_t *croquette, const char *key, void *default_value);
+/**
+ * @brief Add a new Value to a Croquette instance by Key (see croquette_put())
+ */
+int croquette_h_put(croquette_t *croquette, const char *key, void *value);
+/**
+ * @brief Add a new Value to a Croquette instance by a Key of known length (see croquette_put_n())
+ */
+int croquette_h_put_n(croquette_t *croquette, const char *key, size_t len, void *value);
+/**
+ * @brief Add a new Value to a Croquette instance only if Key has no Value (see croquette_putIfAbsent())
+ */
+void *croquette_h_putIfAbsent(croquette_t *croquette, const char *key, void *value);
+/**
+ * @brief Resets a Croquette instance to Initial State (see croquette_clear())
+ */
+int croquette_h_clear(croquette_t *croquette);
+/**
+ * @brief Removes an Entry in a Croquette instance (see croquette_remove())
+ */
+int croquette_h_remove(croquette_t *croquette, const char *key);
+/**
+ * @brief Removes an Entry in a Croquette instance by a Key of known length (see croquette_remove_n())
+ */
+int croquette_h_remove_n(croquette_t *croquette, const char *key, size_t len);
+/**
+ * @brief [Convenience Function] Prints all Keys (and their Indices) of a Croquette instance
+ */
+void croquette_h_print_keys(croquette_t *croquette);
+/**
+ * @brief Grows a Croquette instance once so n Keys fit (see croquette_reserve())
+ */
+int croquette_h_reserve(croquette_t *croquette, int n);
+/**
+ * @brief Pins the capacity of a Croquette instance as its floor (see croquette_pin_capacity())
+ */
+int croquette_h_pin_capacity(croquette_t *croquette);
+/**
+ * @brief Releases a pinned capacity of a Croquette instance (see croquette_unpin_capacity())
+ */
+int croquette_h_unpin_capacity(croquette_t *croquette);
+/**
+ * @brief Shrinks a Croquette instance to fit its Keys (see croquette_shrink_to_fit())
+ */
+int croquette_h_shrink_to_fit(croquette_t *croquette);
+/**
+ * @brief Calls visit on every Entry of a Croquette instance (see croquette_foreach())
+ */
+int croquette_h_foreach(croquette_t *croquette, Croquette_Visit_f visit, void *arg);
+/**
+ * @brief Gets the Occupancy and insert counters of a Croquette instance (see croquette_stats())
+ */
+int croquette_h_stats(croquette_t *croquette, Croquette_Stats_s *stats);
+/**
+ * @brief Gets the number of shards of a Croquette instance (1 if it is not sharded)
+ *
+ * @param croquette Handle to the Croquette.
+ * @return Number of shards
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_h_shard_count(croquette_t *croquette);
+/**
+ * @brief Gets the Occupancy and insert counters of one shard of a Croquette instance
+ *
+ * Shard 0 of a Croquette that is not sharded is the whole Croquette.
+ *
+ * @param croquette Handle to the Croquette.
+ * @param shard Shard number, under croquette_h_shard_count().
+ * @param stats Filled in with the shard's current values.
+ * @return C_Success on Success
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_h_shard_stats(croquette_t *croquette, int shard, Croquette_Stats_s *stats);
+
 #endif
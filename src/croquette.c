@@ -19,16 +19,24 @@
  * @brief A non-FP based, C Implementation of a Dictionary 
  * - Key: String, Value: Anything
  * - Supports Removal with or without Freeing the Value.
- * - Only a single instance of Croquette is supported.
+ * - Any number of independent instances are supported via croquette_t handles.
+ * - The original croquette_* functions operate on a single default instance.
  * - An optional function to free the value is passed in on creation of the croquette.
  * - The Value will NOT be freed or removed from Croquette on GET.  (Pointer to Value)
  *
  * @author Kevin Andrea (kandrea)
  */
+#include <sched.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/random.h>
+#endif
 #include "croquette.h"
+#include "croquette_internal.h"
 
 /** 
  * @enum croquette_clear_options
@@ -43,6 +51,10 @@ enum croquette_clear_options {
 };
 
 
+// Short Keys (up to CARRIER_SHORT_KEY bytes) get a fixed, zero padded Key area in the Carrier
+#define CARRIER_SHORT_KEY 23
+#define CARRIER_SHORT_SIZE (CARRIER_SHORT_KEY + 1)
+
 /**
  * @struct Carrier_s
  *
@@ -50,38 +62,88 @@ enum croquette_clear_options {
  *
  * This is a node in a doubly-linked list for separate chaining.
  * The key is a String and value is void * to accept any generic usage.
+ * The Key bytes follow the node in the same allocation, so a Key compare reads the
+ * cache line already loaded for the hash; a Carrier with a short Key fits in 64 bytes.
  */
 typedef struct carrier_struct {
-  char *key;                      ///< Key for Croquette.
+  uint64_t hash;                  ///< Cached full hash of the Key.
+  size_t key_len;                 ///< Number of bytes in the Key.
   void *value;                    ///< Value for Croquette to Store.
   struct carrier_struct *next;    ///< Next pointer for Separate Chaining.
   struct carrier_struct *prev;    ///< Previous pointer for Separate Chaining.
+  char key[];                     ///< Key for Croquette (NUL terminated copy, zero padded if short).
 } Carrier_s;
 
+// Tree Bins: a chain longer than CHAIN_TREEIFY gets an AVL tree index (as in Java 8's HashMap)
+#define CHAIN_TREEIFY 8           // Chain length that converts an Index to a Tree Bin
+#define CHAIN_UNTREEIFY 6         // Tree Bin size that converts it back to a plain chain
+
+/**
+ * @struct Tree_Node_s
+ *
+ * @brief AVL tree node indexing one Carrier of a long chain, ordered by hash, then Key
+ */
+typedef struct tree_node {
+  Carrier_s *entry;               ///< The indexed Entry (still linked in its chain).
+  struct tree_node *left;         ///< Entries ordered before this one.
+  struct tree_node *right;        ///< Entries ordered after this one.
+  int height;                     ///< Height of this subtree (leaf is 1).
+} Tree_Node_s;
+
+/**
+ * @struct Tree_Bin_s
+ *
+ * @brief Tree index over the chain at one Index of the table
+ *
+ * The chain stays the authoritative list (iteration, rehash and clear walk it);
+ * the tree bounds Key lookups in the chain to O(log n), even when every Key collides.
+ */
+typedef struct tree_bin {
+  Tree_Node_s *root;              ///< Root of the AVL tree.
+  int count;                      ///< Number of Entries in the tree.
+} Tree_Bin_s;
+
 /**
- * @struct Croquette_s
+ * @struct Chained_View_s
+ *
+ * @brief The table and its capacity, published as one pointer to lock-free readers
  *
- * @brief Main Structure for Croquette
+ * A reader loading table and capacity separately could pair a new table with an old capacity;
+ * loading the view gives it a matching pair, which stays valid until it exits its epoch.
+ */
+typedef struct chained_view {
+  Carrier_s **table;              ///< Vector of Carrier Pointers.
+  int capacity;                   ///< Number of Indices in table.
+} Chained_View_s;
+
+/**
+ * @enum Croquette_Retire_e
  *
- * This provides the definitions needed for Croquette, along with all of the functions
- *   needed to work with the chosen key and value.
+ * @brief What a block retired by a lock-free reads Croquette is, so it is freed the right way
  */
-typedef struct croquette_struct {
-  int do_free;                                      ///< Boolean: Free nodes on removal?
-  int size;                                         ///< Number of Keys in Croquette
-  int capacity;                                     ///< Number of Indices in Croquette
-  int base_capacity;                                ///< Base Number of Indices in Croquette 
-  struct carrier_struct **table;                    ///< Vector of Carrier Pointers 
-  void (*free_value)(void *value);                  ///< Function to call to free the Value
-  int (*value_compare)(const void *value1, const void *value2); ///< Function to compare two values (v1 vs. v2)
-} Croquette_s;
+typedef enum croquette_retire {
+  C_Retire_Entry,                 ///< A removed Entry (its Value is freed too if do_free).
+  C_Retire_Node,                  ///< An Entry replaced by a copy (its Value lives on in the copy).
+  C_Retire_Block                  ///< A table or view (free()).
+} Croquette_Retire_e;
 
 // Macro 'Functions'
 #define min(x,y) (x) < (y)?(x):(y)
 
+// Hash Constants (odd, well mixed 64-bit primes used by the wyhash family)
+#define HASH_P0 0xa0761d6478bd642full
+#define HASH_P1 0xe7037ed1a0b428dbull
+#define HASH_P2 0x8ebc6af09c88c6e3ull
+#define HASH_P3 0x589965cc75374cc3ull
+#define SEGMENT_MIX 0x9e3779b97f4a7c15ull   // 2^64 / golden ratio: remixes a hash before picking a Segment
+
+// 128-bit product for the hash mixing (GCC/Clang extension)
+__extension__ typedef unsigned __int128 croquette_u128;
+
 // Private Globals (Private to this Source File Only)
-static Croquette_s *croquette = NULL;
-static int croquette_error = 0;
+static Croquette_s *default_croquette = NULL;   // Instance used by the non-handle API
+static __thread int croquette_error = 0;        // Per-Thread, so private instances share nothing
+
 
 // Strings for the Errors 
 static const char *error_str[C_Num_Errors + 1] = {
@@ -98,174 +160,497 @@ static const char *error_str[C_Num_Errors + 1] = {
   [C_FreeValue_Missing] = "No Function was Given to Free a Value",
   [C_ValueCompare_Missing] = "No Function was Given to Compare two Values",
   [C_Exists] = "The Croquette Already Exists",
+  [C_Invalid_Config] = "The Configuration Given is not Valid",
   [C_No_Such_Error] = "No Such Error Exists",
   [C_Num_Errors] = "This is a Code to Hold the Number of Errors"
 };
 
 // Internal Prototypes - (Private to this Source File Only)
-static Carrier_s *croquette_find_key(const char *key);
-static Carrier_s *croquette_find_value(const void *value);
-static int perform_rehash(int new_capacity);
-static int rehash();
-static long hash_code(const char *key);
-static Carrier_s *carrier_create(const char *key, void *value);
-static int insert_at_index(int index, Carrier_s *entry);
-static long get_index(const char *key);
-static int is_key(Carrier_s *entry, const char *key);
-static int is_value(Carrier_s *entry, const void *value);
-static int remove_entry(Carrier_s *entry);
-static void free_entry(Carrier_s *entry);
-
-/**
- * @brief Initialize a new Croquette
+static void *croquette_lookup(Croquette_s *croquette, const char *key, size_t len, void *default_value);
+static Carrier_s *croquette_find_key(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int croquette_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static Carrier_s *croquette_find_value(Croquette_s *croquette, const void *value);
+static int perform_rehash(Croquette_s *croquette, int new_capacity);
+static int rehash(Croquette_s *croquette, Croquette_Action_e operation);
+static int start_rehash(Croquette_s *croquette, int new_capacity);
+static void rehash_migrate(Croquette_s *croquette, int budget);
+static void relink_chain(Croquette_s *croquette, Carrier_s *chain);
+static int rehash_copy(Croquette_s *croquette, int new_capacity);
+static void **chained_read(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void publish_view(Croquette_s *croquette, Chained_View_s *view);
+static void retire(Croquette_s *croquette, void *block, Croquette_Retire_e kind);
+static void reclaim(Croquette_s *croquette, int all);
+static void release_retired(Croquette_s *croquette, const Croquette_Retired_s *item);
+static inline void link_store(Carrier_s **link, Carrier_s *entry);
+static uint64_t hash_code(Croquette_s *croquette, const char *key, size_t len);
+static croquette_t *segmented_new(const Croquette_Config_s *config);
+static inline Croquette_s *segment_for(Croquette_s *croquette, uint64_t hash);
+static uint64_t random_seed(const void *salt);
+static size_t key_length(const char *key);
+static int is_valid_key(const char *key, size_t len);
+static Carrier_s *carrier_create(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static int insert_at_index(Croquette_s *croquette, int index, Carrier_s *entry);
+static inline long get_index(Croquette_s *croquette, uint64_t hash);
+static inline void lock_read(Croquette_s *croquette);
+static inline void lock_write(Croquette_s *croquette);
+static inline void lock_release(Croquette_s *croquette);
+static inline void lock_settings(Croquette_s *croquette);
+static inline void unlock_settings(Croquette_s *croquette);
+static inline long get_index_in(Croquette_s *croquette, uint64_t hash, int capacity);
+static inline size_t carrier_size(size_t len);
+static int is_key(Croquette_s *croquette, Carrier_s *entry, const char *key, size_t len, const char *probe);
+static int is_value(Croquette_s *croquette, Carrier_s *entry, const void *value);
+static int remove_entry(Croquette_s *croquette, Carrier_s *entry);
+static void free_entry(Croquette_s *croquette, Carrier_s *entry);
+static void release_chain(Croquette_s *croquette, Carrier_s *chain);
+static int chained_init(Croquette_s *croquette, int capacity);
+static void chained_destroy(Croquette_s *croquette);
+static void **chained_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void **chained_find_value(Croquette_s *croquette, const void *value);
+static int chained_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int chained_clear(Croquette_s *croquette);
+static void chained_print_keys(Croquette_s *croquette);
+static int chained_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+static int chained_reserve(Croquette_s *croquette, int n);
+static int chained_shrink_to_fit(Croquette_s *croquette);
+static void bin_add(Croquette_s *croquette, long index, Carrier_s *entry);
+static void bin_remove(Croquette_s *croquette, long index, Carrier_s *entry);
+static void bin_treeify(Croquette_s *croquette, long index);
+static void bins_free(Croquette_s *croquette);
+static int chain_longer_than(const Carrier_s *chain, int limit);
+static int tree_order(const Carrier_s *entry, uint64_t hash, const char *key, size_t len);
+static Carrier_s *tree_find(Croquette_s *croquette, Tree_Node_s *node, const char *key, size_t len, uint64_t hash);
+static Tree_Node_s *tree_insert(Tree_Node_s *node, Tree_Node_s *fresh);
+static Tree_Node_s *tree_delete(Tree_Node_s *node, const Carrier_s *entry, int *found);
+static Tree_Node_s *tree_balance(Tree_Node_s *node);
+static void tree_free(Tree_Node_s *node);
+
+// Separate Chaining Backend (the default)
+static const Croquette_Backend_s croquette_chained_backend = {
+  .name = "chained",
+  .init = chained_init,
+  .destroy = chained_destroy,
+  .find = chained_find,
+  .find_value = chained_find_value,
+  .insert = croquette_insert,
+  .remove = chained_remove,
+  .clear = chained_clear,
+  .print_keys = chained_print_keys,
+  .reserve = chained_reserve,
+  .shrink_to_fit = chained_shrink_to_fit,
+  .foreach = chained_foreach
+};
+
+/**
+ * @brief Sets a Croquette Configuration to the Defaults
+ *
+ * Defaults match croquette_new(C_Default_Capacity, C_No_Free, NULL, NULL); value_compare
+ * must still be set before use.  The built-in croquette_hash() and byte-wise key comparison
+ * are used unless hash_fn or key_equal are set.
+ *
+ * @param config The Configuration to initialize.
+ */
+void croquette_config_init(Croquette_Config_s *config) {
+  if(config == NULL) {
+    return;
+  }
+  memset(config, 0, sizeof(Croquette_Config_s));
+  config->initial_capacity = C_Default_Capacity;
+  config->do_free = C_No_Free;
+  config->seed = CROQUETTE_DEFAULT_SEED;
+  config->fixed_seed = 0;
+  config->capacity_mode = C_Capacity_Exact;
+  config->rehash_step = 0;
+  config->allocator = C_Alloc_Malloc;
+  config->backend = C_Backend_Chained;
+  config->max_load = C_Default_Max_Load;
+  config->min_load = C_Default_Min_Load;
+  config->auto_shrink = 1;
+  config->small_size = 0;
+  config->thread_safe = 0;
+  config->segments = 0;
+  config->lock_free_reads = 0;
+}
+
+/**
+ * @brief Creates a new, independent Croquette instance
  *
  * Creates a new Croquette to store generic Values with String based Keys.
  * If do_free is True, then free_value is needed.  If not, it should be set to NULL.
+ * Each instance has its own table, sizes and functions; nothing is shared between instances.
  * Rules for Croquette
- * - Doubles when size > (initial_capacity>>1 + initial_capacity>>2)
- * - Halves when size < (initial_capcity>>2);
+ * - Doubles when size > max_load% of capacity (75% by default)
+ * - Halves when size < min_load% of capacity (25% by default)
  * - Resets to initial_capacity on clear()
  *
  * @param initial_capacity Initial Capacity or 0 for Default Capacity for Croquette.
  * @param do_free Croquette_NoFree_Value or Croquette_Free_Value to select if it should free on removal.
  * @param free_value Function to free the value if @p do_free is Croquette_Free_Value.
  * @param value_compare Function to compare values: Returns 0 if equal, <0 if v1 < v2, >0 is v1 > v2
- * @return C_Success on Success
- * @return C_Error on Error (Error String Available)
+ * @return Handle to the new Croquette on Success
+ * @return NULL on Error (Error String Available)
  */
-int croquette_create(int initial_capacity, 
-                    int do_free, 
-                    void (*free_value)(void *value),
-                    int (*value_compare)(const void *value1, const void *value2)) {
+croquette_t *croquette_new(int initial_capacity, 
+                           int do_free, 
+                           void (*free_value)(void *value),
+                           int (*value_compare)(const void *value1, const void *value2)) {
+  Croquette_Config_s config;
+  croquette_config_init(&config);
+  config.initial_capacity = initial_capacity;
+  config.do_free = do_free;
+  config.free_value = free_value;
+  config.value_compare = value_compare;
+  return croquette_new_config(&config);
+}
+
+/**
+ * @brief Creates a new, independent Croquette instance from a Configuration
+ *
+ * See croquette_new() for the rules; the Configuration additionally selects the Key functions.
+ *
+ * @param config The Configuration (see croquette_config_init()).
+ * @return Handle to the new Croquette on Success
+ * @return NULL on Error (Error String Available)
+ */
+croquette_t *croquette_new_config(const Croquette_Config_s *config) {
   croquette_set_error(C_No_Error); // Reset Internal error tracker.
-  // Only create if it doesn't already exist.
-  if(croquette != NULL) {
-    croquette_set_error(C_Exists);
-    return C_Error;
+  if(config == NULL) {
+    croquette_set_error(C_Invalid_Config);
+    return NULL;
+  }
+  if(config->segments != 0) {
+    return segmented_new(config);
   }
 
   // Option to enter 0 (or < 0) to use a default size
+  int initial_capacity = config->initial_capacity;
   if(initial_capacity <= 0) {
     initial_capacity = CROQUETTE_DEFAULT_INITIAL_SIZE;
   }
+  if((config->capacity_mode != C_Capacity_Exact && config->capacity_mode != C_Capacity_Pow2) ||
+     (config->allocator != C_Alloc_Malloc && config->allocator != C_Alloc_Slab) ||
+     config->rehash_step < 0) {
+    croquette_set_error(C_Invalid_Config);
+    return NULL;
+  }
+  // Halving must land under max_load (and doubling over min_load), or one resize would trigger the opposite one
+  if(config->max_load < 1 || config->min_load < 0 || config->min_load * 2 >= config->max_load ||
+     config->small_size < 0 || config->small_size > C_Max_Small_Size) {
+    croquette_set_error(C_Invalid_Config);
+    return NULL;
+  }
+  // Only Separate Chaining supports Incremental Rehash (open addressing moves Entries in place)
+  const Croquette_Backend_s *backend = NULL;
+  switch(config->backend) {
+    case C_Backend_Chained:
+      backend = &croquette_chained_backend;
+      break;
+    case C_Backend_RobinHood:
+      backend = &croquette_robinhood_backend;
+      break;
+    case C_Backend_Swiss:
+      backend = &croquette_swiss_backend;
+      break;
+    case C_Backend_Cuckoo:
+      backend = &croquette_cuckoo_backend;
+      break;
+    case C_Backend_Bucketized:
+      backend = &croquette_bucket_backend;
+      break;
+    case C_Backend_Compact:
+      backend = &croquette_compact_backend;
+      break;
+    case C_Backend_SplitOrdered:
+      backend = &croquette_splitorder_backend;
+      break;
+    default:
+      break;
+  }
+  if(backend == NULL || (backend != &croquette_chained_backend &&
+     (config->rehash_step > 0 || config->max_load != C_Default_Max_Load || config->min_load != C_Default_Min_Load))) {
+    croquette_set_error(C_Invalid_Config);
+    return NULL;
+  }
+  // Lock-free reads walk chains, so only whole-table rehashes of Separate Chaining allow them
+  if(config->lock_free_reads &&
+     (backend != &croquette_chained_backend || config->rehash_step > 0 || config->small_size > 0)) {
+    croquette_set_error(C_Invalid_Config);
+    return NULL;
+  }
+  // A small map is locked while it upgrades, which a non-blocking Backend cannot offer
+  if(backend->non_blocking && config->small_size > 0) {
+    croquette_set_error(C_Invalid_Config);
+    return NULL;
+  }
+  // Power of Two mode rounds up, so doubling and halving keep every capacity a power of two
+  if(config->capacity_mode == C_Capacity_Pow2) {
+    int rounded = 1;
+    while(rounded < initial_capacity && rounded < (1 << 30)) {
+      rounded <<= 1;
+    }
+    initial_capacity = rounded;
+  }
   
   // Verify the functions exist as needed.
-  if(do_free == Croquette_Free_Value && free_value == NULL) {
+  if(config->do_free == Croquette_Free_Value && config->free_value == NULL) {
     croquette_set_error(C_FreeValue_Missing);
-    return C_Error;
+    return NULL;
   }
-  if(value_compare == NULL) {
+  if(config->value_compare == NULL) {
     croquette_set_error(C_ValueCompare_Missing);
-    return C_Error;
+    return NULL;
   }
 
   // Allocate and Verify Memory for Symbol Table
-  croquette = calloc(1, sizeof(Croquette_s));
+  Croquette_s *croquette = calloc(1, sizeof(Croquette_s));
   if(croquette == NULL) {
     croquette_set_error(C_Insufficient_Memory);
-    return C_Error;
+    return NULL;
   }
 
-  // Initialize the Memory for the Symbol Table
-  // - This is a 1D array of Pointers to Carrier_s objects.
-  croquette->table = calloc(initial_capacity, sizeof(Carrier_s *));
-  if(croquette->table == NULL) {
-    croquette_set_error(C_Insufficient_Memory);
+  // Entries and Keys come from a private Slab if configured
+  if(config->allocator == C_Alloc_Slab) {
+    croquette->slab = croquette_slab_create();
+    if(croquette->slab == NULL) {
+      croquette_set_error(C_Insufficient_Memory);
+      free(croquette);
+      return NULL;
+    }
+  }
+
+  // Initialize the Memory for the Symbol Table (the Backend sets capacity)
+  // - A small map starts as a linear array and creates the Backend when it outgrows it
+  croquette->pow2 = (config->capacity_mode == C_Capacity_Pow2);
+  croquette->lock_free_reads = (config->lock_free_reads != 0);
+  croquette->non_blocking = backend->non_blocking; // Fixed for life: backend itself changes when a small map upgrades
+  croquette->small_size = config->small_size;
+  croquette->large_backend = backend;
+  croquette->large_capacity = initial_capacity;
+  croquette->backend = (config->small_size > 0) ? &croquette_small_backend : backend;
+  if(croquette->backend->init(croquette, initial_capacity) == C_Error) {
+    croquette_slab_destroy(croquette->slab);
     free(croquette);
-    return C_Error;
+    return NULL;
+  }
+
+  // Writers are preferred where supported, so a steady stream of lookups cannot starve them
+  // - Lock-free reads still serialize the writers (and whole-table reads) on the lock
+  // - Non-blocking Backends only lock capacity settings (reserve, pin), never an Entry operation
+  if(config->thread_safe || config->lock_free_reads || backend->non_blocking) {
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    int ret = pthread_rwlock_init(&croquette->lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+    if(ret != 0) {
+      croquette->backend->destroy(croquette);
+      croquette_slab_destroy(croquette->slab);
+      free(croquette);
+      croquette_set_error(C_Insufficient_Memory);
+      return NULL;
+    }
+    croquette->thread_safe = 1;
   }
 
   // Initialize the remaining Values 
-  croquette->do_free = do_free;
-  croquette->capacity = initial_capacity;       // Capacity of Indices for Use
+  croquette->do_free = config->do_free;
   croquette->size = 0;                          // Currently Used Indices
-  croquette->base_capacity = initial_capacity;  // Base Capacity of Indices for Use (post Clear)
+  croquette->base_capacity = croquette->capacity; // Base Capacity of Indices for Use (post Clear)
+  croquette->rehash_step = config->rehash_step; // Incremental Rehash budget (0 = all at once)
+  croquette->max_load = config->max_load;       // Percent load to Double at
+  croquette->min_load = config->min_load;       // Percent load to Halve at
+  croquette->auto_shrink = config->auto_shrink; // Removals may Halve
+  croquette->seed = config->fixed_seed ? config->seed : random_seed(croquette); // Seed for the Key hash
 
   // Initialize the remaining Functions
-  croquette->free_value = free_value;           // Function to free if do_free is True
-  croquette->value_compare = value_compare;     // Function to compare two Values
+  croquette->free_value = config->free_value;         // Function to free if do_free is True
+  croquette->value_compare = config->value_compare;   // Function to compare two Values
+  croquette->hash_fn = config->hash_fn;               // Function to hash Keys (optional)
+  croquette->key_equal = config->key_equal;           // Function to compare Keys (optional)
 
-  return C_Success;
+  return croquette;
+}
+
+/**
+ * @brief Creates a sharded Croquette: shards independent tables, each Key routed by a remix of its hash
+ *
+ * A facade over the Segments of croquette_new_config(): every shard is a thread safe instance
+ * with its own lock, allocator and resizing, and the handle works with every croquette_h_ function.
+ *
+ * @param shards Number of shards, a Power of Two from 1 to C_Max_Segments.
+ * @param config The Configuration for every shard (see croquette_config_init()); its segments is ignored.
+ * @return Handle to the new Croquette on Success
+ * @return NULL on Error (Error String Available)
+ */
+croquette_t *croquette_sharded_new(int shards, const Croquette_Config_s *config) {
+  croquette_set_error(C_No_Error);
+  if(config == NULL || shards < 1) {
+    croquette_set_error(C_Invalid_Config);
+    return NULL;
+  }
+  Croquette_Config_s sharded = *config;
+  sharded.segments = shards;
+  return segmented_new(&sharded);
+}
+
+/**
+ * @brief Clears and Frees all Entries in a Croquette instance, then Frees the instance
+ * - Always Succeeds (no return), NULL is ignored.
+ *
+ * @param croquette Handle to the Croquette to delete.
+ */
+void croquette_delete(croquette_t *croquette) {
+  if(croquette == NULL) {
+    return;
+  }
+  if(croquette->segments != NULL) {
+    int s = 0;
+    for(s = 0; s < croquette->num_segments; s++) {
+      croquette_delete(croquette->segments[s]);
+    }
+    free(croquette->segments);
+    free(croquette);
+    return;
+  }
+
+  int ret = croquette_h_clear(croquette);
+  if(ret == C_Error) {
+    return;
+  }
+
+  croquette->backend->destroy(croquette);
+  croquette_slab_destroy(croquette->slab);
+  if(croquette->thread_safe) {
+    pthread_rwlock_destroy(&croquette->lock);
+  }
+  free(croquette);
 }
 
 /**
- * @brief Checks if Croquette is Empty
+ * @brief Checks if a Croquette instance is Empty
  *
+ * @param croquette Handle to the Croquette.
  * @return 1 if Empty
  * @return 0 if Not-Empty
  * @return C_Error on Error (Error String Available)
  */
-int croquette_isEmpty() {
+int croquette_h_isEmpty(croquette_t *croquette) {
   croquette_set_error(C_No_Error); // Reset Internal error tracker.
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return C_Error;
   }
 
-  return croquette->size==0;
+  if(croquette->segments != NULL) {
+    return croquette_h_size(croquette) == 0;
+  }
+  lock_read(croquette);
+  int empty = (__atomic_load_n(&croquette->size, __ATOMIC_RELAXED) == 0);
+  lock_release(croquette);
+  return empty;
 }
 
 /**
- * @brief Gets the number of K,V entries in Croquette
+ * @brief Gets the number of K,V entries in a Croquette instance
  *
+ * @param croquette Handle to the Croquette.
  * @return Size
  * @return C_Error on Error (Error String Available)
  */
-int croquette_size() {
+int croquette_h_size(croquette_t *croquette) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return C_Error;
   }
-  return croquette->size;
+  if(croquette->segments != NULL) {
+    int size = 0;
+    int s = 0;
+    for(s = 0; s < croquette->num_segments; s++) {
+      size += croquette_h_size(croquette->segments[s]);
+    }
+    return size;
+  }
+  lock_read(croquette);
+  int size = __atomic_load_n(&croquette->size, __ATOMIC_RELAXED); // Non-blocking Backends count concurrently
+  lock_release(croquette);
+  return size;
 }
 
 /**
- * @brief Gets the current number of Indices in Croquette
+ * @brief Gets the current number of Indices in a Croquette instance
  *
+ * @param croquette Handle to the Croquette.
  * @return Capacity 
  * @return C_Error on Error (Error String Available)
  */
-int croquette_capacity() {
+int croquette_h_capacity(croquette_t *croquette) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return C_Error;
   }
-  return croquette->capacity;
+  if(croquette->segments != NULL) {
+    int capacity = 0;
+    int s = 0;
+    for(s = 0; s < croquette->num_segments; s++) {
+      capacity += croquette_h_capacity(croquette->segments[s]);
+    }
+    return capacity;
+  }
+  lock_read(croquette);
+  int capacity = __atomic_load_n(&croquette->capacity, __ATOMIC_RELAXED);
+  lock_release(croquette);
+  return capacity;
 }
 
 /**
- * @brief Checks if Croquette contains a Key
+ * @brief Checks if a Croquette instance contains a Key
  *
+ * @param croquette Handle to the Croquette.
  * @param key String based key to check
  * @return True if Key Exists
  * @return False if No Such Key
  * @return C_Error on Error (Error String Available)
  */
-int croquette_containsKey(const char *key) {
+int croquette_h_containsKey(croquette_t *croquette, const char *key) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return C_Error;
   }
-  if(key == NULL || strlen(key) == 0) {
+  size_t len = key_length(key);
+  if(!is_valid_key(key, len)) {
     croquette_set_error(C_Invalid_Key);
     return C_Error;
   }
 
-  return croquette_find_key(key)!=NULL;
+  uint64_t hash = hash_code(croquette, key, len);
+  croquette = segment_for(croquette, hash);
+  int found = 0;
+  if(croquette->lock_free_reads && croquette_epoch_enter()) {
+    found = (chained_read(croquette, key, len, hash) != NULL);
+    croquette_epoch_exit();
+    return found;
+  }
+  lock_read(croquette);
+  found = (croquette->backend->find(croquette, key, len, hash) != NULL);
+  lock_release(croquette);
+  return found;
 }
 
 /**
- * @brief Checks if Croquette contains a Value
+ * @brief Checks if a Croquette instance contains a Value
  *
- * @param key Value to check for.
+ * @param croquette Handle to the Croquette.
+ * @param value Value to check for.
  * @return True if Value Exists
  * @return False if No Such Value
  * @return C_Error on Error (Error String Available)
  */
-int croquette_containsValue(void *value) {
+int croquette_h_containsValue(croquette_t *croquette, void *value) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
@@ -276,94 +661,243 @@ int croquette_containsValue(void *value) {
     return C_Error;
   }
 
-  return croquette_find_value(value)!=NULL;
+  if(croquette->segments != NULL) {
+    int found = 0;
+    int s = 0;
+    for(s = 0; s < croquette->num_segments && !found; s++) {
+      found = croquette_h_containsValue(croquette->segments[s], value);
+    }
+    return found;
+  }
+  lock_read(croquette);
+  int found = (croquette->backend->find_value(croquette, value) != NULL);
+  lock_release(croquette);
+  return found;
 }
 
 /**
  * @brief Gets the value for a given key. Will not Free the Value Returned.
  *
+ * @param croquette Handle to the Croquette.
  * @param key String based key to get the value of.
  * @return void *value if Key Exists
  * @return NULL if No Such Key or any Errors (Error String Available)
  */
-void *croquette_get(const char *key) {
-  return croquette_getOrDefault(key, NULL);
+void *croquette_h_get(croquette_t *croquette, const char *key) {
+  return croquette_lookup(croquette, key, key_length(key), NULL);
+}
+
+/**
+ * @brief Gets the value for a given key of known length. Will not Free the Value Returned.
+ *
+ * @param croquette Handle to the Croquette.
+ * @param key Key bytes to get the value of (need not be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @return void *value if Key Exists
+ * @return NULL if No Such Key or any Errors (Error String Available)
+ */
+void *croquette_h_get_n(croquette_t *croquette, const char *key, size_t len) {
+  return croquette_lookup(croquette, key, len, NULL);
 }
 
 /**
  * @brief Gets the value for a given key. Will not Free the Value Returned.
  *
+ * @param croquette Handle to the Croquette.
  * @param key String based key to get the value of.
  * @return void *value if Key Exists
  * @return default_value if No Such Key
  * @return NULL on any Errors (Error String Available)
  */
-void *croquette_getOrDefault(const char *key, void *default_value) {
+void *croquette_h_getOrDefault(croquette_t *croquette, const char *key, void *default_value) {
+  return croquette_lookup(croquette, key, key_length(key), default_value);
+}
+
+/**
+ * @brief Gets the value for a given key of known length, or a default.
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to get the value of.
+ * @param len Number of bytes in the key.
+ * @param default_value Value to return if there is no such key.
+ * @return void *value if Key Exists
+ * @return default_value if No Such Key
+ * @return NULL on any Errors (Error String Available)
+ */
+static void *croquette_lookup(Croquette_s *croquette, const char *key, size_t len, void *default_value) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return NULL;
   }
-  if(key == NULL || strlen(key) == 0) {
+  if(!is_valid_key(key, len)) {
     croquette_set_error(C_Invalid_Key);
     return NULL;
   }
 
-  Carrier_s *entry = croquette_find_key(key);
-  return (entry!=NULL)?entry->value:default_value;
+  uint64_t hash = hash_code(croquette, key, len);
+  croquette = segment_for(croquette, hash);
+  void **slot = NULL;
+  void *value = NULL;
+  if(croquette->lock_free_reads && croquette_epoch_enter()) {
+    slot = chained_read(croquette, key, len, hash);
+    value = (slot!=NULL)?__atomic_load_n(slot, __ATOMIC_ACQUIRE):default_value;
+    croquette_epoch_exit();
+    return value;
+  }
+  lock_read(croquette);
+  slot = croquette->backend->find(croquette, key, len, hash);
+  value = (slot!=NULL)?__atomic_load_n(slot, __ATOMIC_ACQUIRE):default_value;
+  lock_release(croquette);
+  return value;
+}
+
+/**
+ * @brief Allocates the Separate Chaining table (an array of chain heads)
+ *
+ * @param croquette The Croquette being created.
+ * @param capacity Number of Indices.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int chained_init(Croquette_s *croquette, int capacity) {
+  // - This is a 1D array of Pointers to Carrier_s objects.
+  croquette->table = calloc(capacity, sizeof(Carrier_s *));
+  Chained_View_s *view = croquette->lock_free_reads ? malloc(sizeof(Chained_View_s)) : NULL;
+  if(croquette->table == NULL || (croquette->lock_free_reads && view == NULL)) {
+    free(croquette->table);
+    free(view);
+    croquette->table = NULL;
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  croquette->capacity = capacity;
+  if(view != NULL) {
+    publish_view(croquette, view);
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Frees the (empty) Separate Chaining table
+ *
+ * @param croquette The Croquette being deleted.
+ */
+static void chained_destroy(Croquette_s *croquette) {
+  bins_free(croquette);
+  free(croquette->table);
+  croquette->table = NULL;
+  /* Deleting requires that no reader is still using the Croquette, so everything goes now */
+  if(croquette->lock_free_reads) {
+    reclaim(croquette, 1);
+    free(croquette->retired.items);
+    free(croquette->view);
+    croquette->view = NULL;
+  }
+}
+
+/**
+ * @brief Finds the Value slot for a Key, migrating part of any Incremental Rehash first
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key (from hash_code()).
+ * @return Address of the Entry's Value if Key Exists
+ * @return NULL if No Such Key
+ */
+static void **chained_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  rehash_migrate(croquette, croquette->rehash_step);
+  Carrier_s *entry = croquette_find_key(croquette, key, len, hash);
+  return (entry != NULL)?&entry->value:NULL;
+}
+
+/**
+ * @brief Finds the Value slot of any Entry holding a matching Value
+ *
+ * @param croquette The Croquette to search.
+ * @param value Value to compare against.
+ * @return Address of the Entry's Value if Value Exists
+ * @return NULL if No Such Value
+ */
+static void **chained_find_value(Croquette_s *croquette, const void *value) {
+  Carrier_s *entry = croquette_find_value(croquette, value);
+  return (entry != NULL)?&entry->value:NULL;
 }
 
 /**
  * @brief Finds an entry for a given Key
  *
- * @param key String based key to find.
+ * Entries cache the full hash of their Key, so a chain walk rejects nodes
+ * with a single integer compare and only compares Keys on a hash match.
+ * The Key must already be validated by the caller.
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key (from hash_code()).
  * @return Carrier_s *entry if Key Exists
  * @return NULL if No Such Key or any Errors (Error String Available)
  */
-static Carrier_s *croquette_find_key(const char *key) {
+static Carrier_s *croquette_find_key(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return NULL;
   }
-  if(key == NULL || strlen(key) == 0) {
-    croquette_set_error(C_Invalid_Key);
-    return NULL;
-  }
-
-  int index = get_index(key);
-  if(index == C_Error) {
-    // croquette_error propagates
-    return NULL;
-  }
 
+  long index = get_index(croquette, hash);
   Carrier_s *walker = croquette->table[index];
 
-  // Uses separate chaining, so no tombstones needed. 
-  if(walker == NULL) {
-    // No Entries isn't an error. 
-    return NULL;
+  /* A long chain is searched through its Tree Bin instead */
+  if(croquette->bins != NULL && croquette->bins[index] != NULL) {
+    walker = tree_find(croquette, croquette->bins[index]->root, key, len, hash);
+    if(walker != NULL || croquette->old_table == NULL) {
+      return walker;
+    }
+    walker = NULL;
   }
 
+  /* Short Keys are padded once here, so each candidate is a fixed size compare */
+  char padded[CARRIER_SHORT_SIZE] = {0};
+  const char *probe = NULL;
+  if(len <= CARRIER_SHORT_KEY && croquette->key_equal == NULL) {
+    memcpy(padded, key, len);
+    probe = padded;
+  }
+
+  // Uses separate chaining, so no tombstones needed. 
   /* Walk the linked list looking for a match variable name */
   while(walker != NULL) {
     /* If a match is found, report it */
-    if(is_key(walker, key)) {
+    if(walker->hash == hash && is_key(croquette, walker, key, len, probe)) {
       return walker;
     }
     walker = walker->next;
   }
+
+  /* During an Incremental Rehash, Keys not yet migrated are still in the old table */
+  if(croquette->old_table != NULL) {
+    walker = croquette->old_table[get_index_in(croquette, hash, croquette->old_capacity)];
+    while(walker != NULL) {
+      if(walker->hash == hash && is_key(croquette, walker, key, len, probe)) {
+        return walker;
+      }
+      walker = walker->next;
+    }
+  }
   return NULL;
 }
 
 /**
  * @brief Finds an entry for a given Key
  *
+ * @param croquette The Croquette to search.
  * @param key String based key to find.
  * @return Carrier_s *entry if Key Exists
  * @return NULL if No Such Key or any Errors (Error String Available)
  */
-static Carrier_s *croquette_find_value(const void *value) {
+static Carrier_s *croquette_find_value(Croquette_s *croquette, const void *value) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
@@ -382,62 +916,115 @@ static Carrier_s *croquette_find_value(const void *value) {
     /* Walk the linked list looking for a matching value */
     while(walker != NULL) {
       /* If a match is found, report it */
-      if(is_value(walker, value)) {
+      if(is_value(croquette, walker, value)) {
         return walker;
       }
       walker = walker->next;
     }
   }
+
+  /* During an Incremental Rehash, only the Indices not yet migrated hold entries */
+  if(croquette->old_table != NULL) {
+    for(current_index = croquette->rehash_index; current_index < croquette->old_capacity; current_index++) {
+      for(walker = croquette->old_table[current_index]; walker != NULL; walker = walker->next) {
+        if(is_value(croquette, walker, value)) {
+          return walker;
+        }
+      }
+    }
+  }
   return NULL;
 }
 
 /**
- * @brief Add a new Value to Croquette by Key
+ * @brief Add a new Value to a Croquette instance by Key
  *
+ * @param croquette Handle to the Croquette.
  * @param key String based key to add to the croquette.
  * @param value Generic value to put in to the croquette at the key.
  * @return C_Success on Successful Update/Add
  * @return C_Error on Error (Error String Available)
  */
-int croquette_put(const char *key, void *value) {
+int croquette_h_put(croquette_t *croquette, const char *key, void *value) {
+  return croquette_h_put_n(croquette, key, key_length(key), value);
+}
+
+/**
+ * @brief Add a new Value to a Croquette instance by a Key of known length
+ *
+ * The Key is copied; it need not be NUL terminated and is never scanned for its length.
+ *
+ * @param croquette Handle to the Croquette.
+ * @param key Key bytes to add to the croquette.
+ * @param len Number of bytes in the key.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Update/Add
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_h_put_n(croquette_t *croquette, const char *key, size_t len, void *value) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return C_Error;
   }
-  if(key == NULL || strlen(key) == 0) {
+  if(!is_valid_key(key, len)) {
     croquette_set_error(C_Invalid_Key);
     return C_Error;
   }
   
   /* Try and update the existing value */
-  Carrier_s *entry = croquette_find_key(key);
-  if(entry != NULL) {
+  uint64_t hash = hash_code(croquette, key, len);
+  croquette = segment_for(croquette, hash);
+  lock_write(croquette);
+  if(croquette->backend->put != NULL) {
+    int ret = croquette->backend->put(croquette, key, len, hash, value, 0, NULL);
+    lock_release(croquette);
+    return ret;
+  }
+  void **slot = croquette->backend->find(croquette, key, len, hash);
+  if(slot != NULL) {
     /* Check to see if this is a different value (update) */
-    if(croquette->value_compare(entry->value, value)) {
-      croquette->free_value(entry->value);
-      entry->value = value;
+    if(croquette->value_compare(*slot, value)) {
+      if(croquette->do_free == C_Do_Free) {
+        croquette->free_value(*slot);
+      }
+      __atomic_store_n(slot, value, __ATOMIC_RELEASE); // Lock-free readers may load it concurrently
     }
+    lock_release(croquette);
     return C_Success;
   }
 
-  /* Entry NULL, so we Need to create a new entry */
-  entry = carrier_create(key, value);
-  if(entry == NULL) {
-    croquette_set_error(C_Insufficient_Memory);
-    return C_Error;
+  int ret = croquette->backend->insert(croquette, key, len, hash, value);
+  if(ret == C_Success) {
+    croquette->inserts++;
   }
+  lock_release(croquette);
+  return ret;
+}
 
-  /* Get the hash code and then insert Symbol at the index */
-  int index = get_index(entry->key);
-  if(index == C_Error) {
+/**
+ * @brief Inserts a new Entry for a Key known not to be in the Croquette
+ *
+ * @param croquette The Croquette to insert into.
+ * @param key Key bytes to add to the croquette.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key (from hash_code()).
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Add
+ * @return C_Error on Error (Error String Available)
+ */
+static int croquette_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
+  /* Create a new entry, carrying the hash so it is never recomputed */
+  Carrier_s *entry = carrier_create(croquette, key, len, hash, value);
+  if(entry == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
     return C_Error;
   }
 
-  insert_at_index(index, entry);
+  insert_at_index(croquette, get_index(croquette, hash), entry);
 
   /* Assess and ReHash if needed */
-  int rehash_success = rehash(C_Insert);
+  int rehash_success = rehash(croquette, C_Insert);
   if(rehash_success == C_Error) {
     // Error string will propagate.
     return C_Error;
@@ -447,39 +1034,69 @@ int croquette_put(const char *key, void *value) {
 }
 
 /**
- * @brief Add a new Value to Croquette by Key only if Key has no Value
+ * @brief Add a new Value to a Croquette instance by Key only if Key has no Value
  *
+ * @param croquette Handle to the Croquette.
  * @param key String based key to add to the croquette.
  * @param value Generic value to put in to the croquette at the key.
  * @return NULL if key did not exist and value was added. 
  * @return value if key did exist, existing value is returned.
  */
-void *croquette_putIfAbsent(const char *key, void *value) {
-  Carrier_s *entry = croquette_find_key(key);
-  if(entry == NULL) {
-    croquette_put(key, value);
+void *croquette_h_putIfAbsent(croquette_t *croquette, const char *key, void *value) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return NULL;
+  }
+  size_t len = key_length(key);
+  if(!is_valid_key(key, len)) {
+    croquette_set_error(C_Invalid_Key);
     return NULL;
   }
-    
-  return entry->value;
+
+  uint64_t hash = hash_code(croquette, key, len);
+  croquette = segment_for(croquette, hash);
+  lock_write(croquette);
+  void *existing = NULL;
+  if(croquette->backend->put != NULL) {
+    croquette->backend->put(croquette, key, len, hash, value, 1, &existing);
+    lock_release(croquette);
+    return existing;
+  }
+  void **slot = croquette->backend->find(croquette, key, len, hash);
+  if(slot == NULL) {
+    if(croquette->backend->insert(croquette, key, len, hash, value) == C_Success) {
+      croquette->inserts++;
+    }
+  }
+  else {
+    existing = *slot;
+  }
+  lock_release(croquette);
+  return existing;
 }
 
 /**
  * @brief Assess for a ReHash and ReHash if needed
  *
+ * @param croquette The Croquette to assess.
+ * @param operation C_Insert or C_Remove, the operation that was just performed.
  * @return C_Success if ReHash not needed or ReHash succeeded.
  * @return C_Error if ReHash was needed and Failed (Error string set).
  */
-static int rehash(Croquette_Action_e operation) {
+static int rehash(Croquette_s *croquette, Croquette_Action_e operation) {
   croquette_set_error(C_No_Error);
-  /* Calculate the load and see if a rehash is needed before insert */
-  /* - Doubles when new size > (initial_capacity>>1 + initial_capacity>>2) */
-  /* - Special Case to handle int division, if new size is capacity (input on capacity = 1), then double */
+  /* An Incremental Rehash in progress finishes before the load is assessed again */
+  if(croquette->old_table != NULL) {
+    return C_Success;
+  }
+  /* Calculate the load and see if a rehash is needed after the operation */
+  /* - Doubles when new size > max_load% of capacity */
+  /* - Halves when new size < min_load% of capacity (min_load < max_load / 2, so neither immediately triggers the other) */
   int new_capacity = 0;
   switch(operation) {
     case C_Insert:
-      if(((croquette->size) > ((croquette->capacity>>1) + (croquette->capacity>>2)) || 
-                        (croquette->size) >= croquette->capacity)) {
+      if((long)croquette->size * 100 > (long)croquette->capacity * croquette->max_load) {
         new_capacity = croquette->capacity << 1;
       }
       else { // Nothing to do.
@@ -487,7 +1104,10 @@ static int rehash(Croquette_Action_e operation) {
       }
       break;
     case C_Remove:
-      if(croquette->size < (croquette->capacity>>1)) {
+      /* A pinned Capacity is a floor */
+      if(croquette->auto_shrink && croquette->capacity > 1 &&
+         (long)croquette->size * 100 < (long)croquette->capacity * croquette->min_load &&
+         (!croquette->pinned || (croquette->capacity>>1) >= croquette->base_capacity)) {
          new_capacity = croquette->capacity >> 1;
       }
       else { // Nothing to do.
@@ -498,7 +1118,8 @@ static int rehash(Croquette_Action_e operation) {
       return C_Success;
   }
 
-  int success = perform_rehash(new_capacity);
+  int success = (croquette->rehash_step > 0)?start_rehash(croquette, new_capacity):
+                                             perform_rehash(croquette, new_capacity);
   if(success == C_Error) {
     return C_Error;
   }
@@ -506,92 +1127,169 @@ static int rehash(Croquette_Action_e operation) {
 }
 
 /**
- * @brief Clears and Frees all Entries in Croquette, Removes Croquette
- * - Always Succeeds (no return)
- */
-void croquette_destroy() {
-  if(croquette == NULL) {
-    return;
-  }
-
-  int ret = croquette_clear();
-  if(ret == C_Error) {
-    return;
-  }
-
-  if(croquette != NULL) {
-    free(croquette->table);
-    free(croquette);
-    croquette = NULL;
-  }
-}
-
-/**
- * @brief Resets Croquette to Initial State (Empty)
+ * @brief Resets a Croquette instance to Initial State (Empty)
  *
  * Clears all entries and resets sizes to initial.
  *
+ * @param croquette Handle to the Croquette.
  * @return C_Success on Success
  * @return C_Error on any Failure (Error string set).
  */
-int croquette_clear() {
+int croquette_h_clear(croquette_t *croquette) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return C_Error;
   }
 
-  /* Iterate all Keys and Free Them */
-  Carrier_s *walker = NULL;
-  Carrier_s *reaper = NULL;
+  if(croquette->segments != NULL) {
+    int ret = C_Success;
+    int s = 0;
+    for(s = 0; s < croquette->num_segments; s++) {
+      ret = (croquette_h_clear(croquette->segments[s]) == C_Error) ? C_Error : ret;
+    }
+    return ret;
+  }
+  lock_write(croquette);
+  int ret = croquette->backend->clear(croquette);
+  lock_release(croquette);
+  return ret;
+}
+
+/**
+ * @brief Clears the Separate Chaining table and resets it to base_capacity
+ *
+ * @param croquette The Croquette to clear.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+static int chained_clear(Croquette_s *croquette) {
+  /* Readers may be walking the chains: swap in an empty table and retire every Entry instead */
+  if(croquette->lock_free_reads) {
+    Carrier_s **new_sable = calloc(croquette->base_capacity, sizeof(Carrier_s *));
+    Chained_View_s *view = malloc(sizeof(Chained_View_s));
+    if(new_sable == NULL || view == NULL) {
+      free(new_sable);
+      free(view);
+      croquette_set_error(C_Insufficient_Memory);
+      return C_Error;
+    }
+    Carrier_s **old_sable = croquette->table;
+    int old_capacity = croquette->capacity;
+    Carrier_s *reaper = NULL;
+    Carrier_s *walker = NULL;
+    int i = 0;
+    bins_free(croquette);
+    croquette->table = new_sable;
+    croquette->capacity = croquette->base_capacity;
+    croquette->size = 0;
+    publish_view(croquette, view);
+    for(i = 0; i < old_capacity; i++) {
+      for(walker = old_sable[i]; walker != NULL; ) {
+        reaper = walker;
+        walker = walker->next;
+        retire(croquette, reaper, C_Retire_Entry);
+      }
+    }
+    retire(croquette, old_sable, C_Retire_Block);
+    return C_Success;
+  }
+
+  /* Iterate all Keys and Free Them (the whole chain goes, so no unlinking is needed)
+   * - With a Slab, nodes go a slab at once, so chains are only walked to free Values. */
   int i = 0;
-  for(i = 0; i < croquette->capacity; i++) {
-    walker = croquette->table[i];
-    while(walker != NULL) {
-      reaper = walker;
-      walker = walker->next;
-      remove_entry(reaper);
+  if(croquette->slab == NULL || croquette->do_free == C_Do_Free) {
+    for(i = 0; i < croquette->capacity; i++) {
+      release_chain(croquette, croquette->table[i]);
+    }
+    for(i = croquette->rehash_index; croquette->old_table != NULL && i < croquette->old_capacity; i++) {
+      release_chain(croquette, croquette->old_table[i]);
     }
-    croquette->table[i] = NULL;
   }
+  memset(croquette->table, 0, croquette->capacity * sizeof(Carrier_s *));
+  bins_free(croquette);
+  croquette_slab_reset(croquette->slab);
+  free(croquette->old_table);
+  croquette->old_table = NULL;
+  croquette->size = 0;
 
   /* Reset to Base Hash Capacity */
-  int ret = perform_rehash(croquette->base_capacity);
+  if(croquette->capacity == croquette->base_capacity) {
+    return C_Success;
+  }
+  int ret = perform_rehash(croquette, croquette->base_capacity);
   return ret;
 }
 
 /**
- * @brief Removes an Entry in Croquette, will Rehash if needed after.
+ * @brief Removes an Entry in a Croquette instance, will Rehash if needed after.
  *
  * Will Remove a given Entry based on its Key
  * - Will only Free the Value if the do_free is set in configuration.
  *
+ * @param croquette Handle to the Croquette.
  * @param key String based Key to identify which entry to remove.
  * @return C_Success on Successful Removal (or if no Entry was Present)
  * @return C_Error on any Failure (Error string set).
  */
-int croquette_remove(const char *key) {
+int croquette_h_remove(croquette_t *croquette, const char *key) {
+  return croquette_h_remove_n(croquette, key, key_length(key));
+}
+
+/**
+ * @brief Removes an Entry by a Key of known length, will Rehash if needed after.
+ *
+ * Will Remove a given Entry based on its Key
+ * - Will only Free the Value if the do_free is set in configuration.
+ *
+ * @param croquette Handle to the Croquette.
+ * @param key Key bytes to identify which entry to remove (need not be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_h_remove_n(croquette_t *croquette, const char *key, size_t len) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return C_Error;
   }
-  if(key == NULL || strlen(key) == 0) {
+  if(!is_valid_key(key, len)) {
     croquette_set_error(C_Invalid_Key);
     return C_Error;
   }
 
+  uint64_t hash = hash_code(croquette, key, len);
+  croquette = segment_for(croquette, hash);
+  lock_write(croquette);
+  int ret = croquette->backend->remove(croquette, key, len, hash);
+  lock_release(croquette);
+  return ret;
+}
+
+/**
+ * @brief Removes a Key from the Separate Chaining table, will Rehash if needed after.
+ *
+ * @param croquette The Croquette to remove from.
+ * @param key Key bytes to identify which entry to remove.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key (from hash_code()).
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+static int chained_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
   /* If there's no such key, mission accomplished. */
-  Carrier_s *entry = croquette_find_key(key);
+  rehash_migrate(croquette, croquette->rehash_step);
+  Carrier_s *entry = croquette_find_key(croquette, key, len, hash);
   if(entry == NULL) {
     return C_Success;
   } else {
-    remove_entry(entry);
+    remove_entry(croquette, entry);
   }
 
   /* Calculate the load and see if a rehash is needed before insert */
   /* - Halves when size < (initial_capacity>>1) */
-  int rehash_success = rehash(C_Remove);
+  int rehash_success = rehash(croquette, C_Remove);
   if(rehash_success == C_Error) {
     // Error string will propagate.
     return C_Error;
@@ -601,13 +1299,34 @@ int croquette_remove(const char *key) {
 }
 
 /**
- * @brief [Convenience Function] Prints all Keys (and their Indices)
+ * @brief [Convenience Function] Prints all Keys (and their Indices) of a Croquette instance
+ *
+ * @param croquette Handle to the Croquette.
  */
-void croquette_print_keys() {
+void croquette_h_print_keys(croquette_t *croquette) {
   printf("Keys: \n");
   if(croquette == NULL) {
     return;
   }
+  if(croquette->segments != NULL) {
+    int s = 0;
+    for(s = 0; s < croquette->num_segments; s++) {
+      printf("Segment %d ", s);
+      croquette_h_print_keys(croquette->segments[s]);
+    }
+    return;
+  }
+  lock_read(croquette);
+  croquette->backend->print_keys(croquette);
+  lock_release(croquette);
+}
+
+/**
+ * @brief Prints all Keys (and their Indices) of the Separate Chaining table
+ *
+ * @param croquette The Croquette to print.
+ */
+static void chained_print_keys(Croquette_s *croquette) {
 
   /* Iterate all Indices and Keys, Printing Them */
   int i = 0;
@@ -619,104 +1338,1250 @@ void croquette_print_keys() {
       }  
     }
   }
+  for(i = croquette->rehash_index; croquette->old_table != NULL && i < croquette->old_capacity; i++) {
+    for(walker = croquette->old_table[i]; walker != NULL; walker = walker->next) {
+      printf("[old %2d] %s\n", i, walker->key);
+    }
+  }
 }
 
 /**
- * @brief Rehashes Croquette to the new Capacity (Larger or Smaller)
- * 
- * @param new_capacity The new capacity for the hash table
- * @return C_Success on Successful Rehash
+ * @brief Grows a Croquette instance once so n Keys fit without another resize
+ *
+ * Never shrinks.  While the capacity is pinned, the reserved capacity becomes the new floor.
+ *
+ * @param croquette Handle to the Croquette.
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
  * @return C_Error on any Failure (Error string set).
  */
-static int perform_rehash(int new_capacity) {
+int croquette_h_reserve(croquette_t *croquette, int n) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
     return C_Error;
   }
-  if(new_capacity <= 0) {
+  if(n < 0) {
     croquette_set_error(C_Invalid_Capacity);
     return C_Error;
   }
 
-  Carrier_s **new_sable = calloc(new_capacity, sizeof(Carrier_s *));
-  if(new_sable == NULL) {
-    croquette_set_error(C_Insufficient_Memory);
+  if(croquette->segments != NULL) {
+    /* Each Segment takes its share of the Keys, plus 1/8 for the uneven spread of hashes */
+    int share = (n + croquette->num_segments - 1) / croquette->num_segments;
+    int ret = C_Success;
+    int s = 0;
+    for(s = 0; s < croquette->num_segments && ret == C_Success; s++) {
+      ret = croquette_h_reserve(croquette->segments[s], share + share / 8);
+    }
+    return ret;
+  }
+  lock_settings(croquette);
+  int ret = croquette->backend->reserve(croquette, n);
+  int capacity = __atomic_load_n(&croquette->capacity, __ATOMIC_RELAXED);
+  if(ret == C_Success && croquette->pinned && capacity > croquette->base_capacity) {
+    croquette->base_capacity = capacity;
+  }
+  unlock_settings(croquette);
+  return ret;
+}
+
+/**
+ * @brief Pins the current capacity of a Croquette instance as its floor
+ *
+ * Backends shrink no lower than base_capacity and clear() resets to it, so pinning raises
+ * base_capacity to the current capacity and remembers the original for unpinning.
+ *
+ * @param croquette Handle to the Croquette.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_h_pin_capacity(croquette_t *croquette) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return C_Error;
+  }
+
+  if(croquette->segments != NULL) {
+    int s = 0;
+    for(s = 0; s < croquette->num_segments; s++) {
+      croquette_h_pin_capacity(croquette->segments[s]);
+    }
+    return C_Success;
+  }
+  lock_settings(croquette);
+  if(!croquette->pinned) {
+    croquette->unpinned_base = croquette->base_capacity;
+    croquette->pinned = 1;
+  }
+  croquette->base_capacity = __atomic_load_n(&croquette->capacity, __ATOMIC_RELAXED);
+  unlock_settings(croquette);
+  return C_Success;
+}
+
+/**
+ * @brief Releases a pinned capacity of a Croquette instance (restoring the original base_capacity)
+ *
+ * @param croquette Handle to the Croquette.
+ * @return C_Success on Success (including when not pinned)
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_h_unpin_capacity(croquette_t *croquette) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return C_Error;
+  }
+
+  if(croquette->segments != NULL) {
+    int s = 0;
+    for(s = 0; s < croquette->num_segments; s++) {
+      croquette_h_unpin_capacity(croquette->segments[s]);
+    }
+    return C_Success;
+  }
+  lock_settings(croquette);
+  if(croquette->pinned) {
+    croquette->base_capacity = croquette->unpinned_base;
+    croquette->pinned = 0;
+  }
+  unlock_settings(croquette);
+  return C_Success;
+}
+
+/**
+ * @brief Doubles a Separate Chaining capacity until n Keys stay within max_load
+ *
+ * @param croquette The Croquette (for max_load).
+ * @param capacity Capacity to start from (doubling keeps its Power of Two or Exact sizing).
+ * @param n Number of Keys to fit.
+ * @return The capacity
+ */
+static int chained_fit_capacity(const Croquette_s *croquette, int capacity, int n) {
+  while((long)n * 100 > (long)capacity * croquette->max_load && capacity < (1 << 30)) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+/**
+ * @brief Grows the Separate Chaining table so n Keys stay within max_load (one rehash)
+ *
+ * Doubles from the current capacity, as inserts would, and finishes any Incremental Rehash.
+ *
+ * @param croquette The Croquette to grow.
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int chained_reserve(Croquette_s *croquette, int n) {
+  int capacity = chained_fit_capacity(croquette, croquette->capacity, n);
+  if(capacity == croquette->capacity) {
+    return C_Success;
+  }
+  return perform_rehash(croquette, capacity);
+}
+
+/**
+ * @brief Rehashes the Separate Chaining table to the smallest doubling of base_capacity within max_load
+ *
+ * @param croquette The Croquette to shrink.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int chained_shrink_to_fit(Croquette_s *croquette) {
+  int capacity = chained_fit_capacity(croquette, croquette->base_capacity, croquette->size);
+  if(capacity >= croquette->capacity) {
+    return C_Success;
+  }
+  return perform_rehash(croquette, capacity);
+}
+
+/**
+ * @brief Shrinks a Croquette instance to the smallest capacity that holds its Keys
+ *
+ * Never below base_capacity (the pinned capacity while pinned).
+ *
+ * @param croquette Handle to the Croquette.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_h_shrink_to_fit(croquette_t *croquette) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return C_Error;
+  }
+  if(croquette->segments != NULL) {
+    int ret = C_Success;
+    int s = 0;
+    for(s = 0; s < croquette->num_segments && ret == C_Success; s++) {
+      ret = croquette_h_shrink_to_fit(croquette->segments[s]);
+    }
+    return ret;
+  }
+  lock_write(croquette);
+  int ret = croquette->backend->shrink_to_fit(croquette);
+  lock_release(croquette);
+  return ret;
+}
+
+/**
+ * @brief Calls visit on every Entry of a Croquette instance until it returns non-zero
+ *
+ * @param croquette Handle to the Croquette.
+ * @param visit Function to call with each Key, its length, its Value and arg.
+ * @param arg Passed through to visit.
+ * @return C_Success on Success (including stopping early)
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_h_foreach(croquette_t *croquette, Croquette_Visit_f visit, void *arg) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return C_Error;
+  }
+  if(visit == NULL) {
+    croquette_set_error(C_Entry_NULL);
+    return C_Error;
+  }
+
+  /* Each Segment is visited under its own lock; a visitor stopping ends the whole walk */
+  int count = (croquette->segments != NULL) ? croquette->num_segments : 1;
+  int stop = 0;
+  int s = 0;
+  for(s = 0; s < count && stop == 0; s++) {
+    Croquette_s *segment = (croquette->segments != NULL) ? croquette->segments[s] : croquette;
+    lock_read(segment);
+    stop = segment->backend->foreach(segment, visit, arg);
+    lock_release(segment);
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Visits every Entry of the Separate Chaining table (both tables during a migration)
+ *
+ * @param croquette The Croquette to visit.
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return The first non-zero result of visit, or 0
+ */
+static int chained_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg) {
+  Carrier_s *walker = NULL;
+  int stop = 0;
+  int i = 0;
+  for(i = 0; i < croquette->capacity; i++) {
+    for(walker = croquette->table[i]; walker != NULL; walker = walker->next) {
+      if((stop = visit(walker->key, walker->key_len, walker->value, arg)) != 0) {
+        return stop;
+      }
+    }
+  }
+  for(i = croquette->rehash_index; croquette->old_table != NULL && i < croquette->old_capacity; i++) {
+    for(walker = croquette->old_table[i]; walker != NULL; walker = walker->next) {
+      if((stop = visit(walker->key, walker->key_len, walker->value, arg)) != 0) {
+        return stop;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Gets the Occupancy and insert counters of a Croquette instance
+ *
+ * @param croquette Handle to the Croquette.
+ * @param stats Filled in with the current values.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_h_stats(croquette_t *croquette, Croquette_Stats_s *stats) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return C_Error;
+  }
+  if(stats == NULL) {
+    croquette_set_error(C_Entry_NULL);
     return C_Error;
   }
 
-  /* Move Croquette to the new Table, but hold the Old Table */
-  Carrier_s **old_sable = croquette->table;
-  croquette->table = new_sable;
+  int count = (croquette->segments != NULL) ? croquette->num_segments : 1;
+  int s = 0;
+  memset(stats, 0, sizeof(Croquette_Stats_s));
+  for(s = 0; s < count; s++) {
+    Croquette_s *segment = (croquette->segments != NULL) ? croquette->segments[s] : croquette;
+    lock_read(segment);
+    stats->size += __atomic_load_n(&segment->size, __ATOMIC_RELAXED);
+    stats->capacity += __atomic_load_n(&segment->capacity, __ATOMIC_RELAXED);
+    stats->inserts += __atomic_load_n(&segment->inserts, __ATOMIC_RELAXED);
+    stats->insert_failures += __atomic_load_n(&segment->insert_failures, __ATOMIC_RELAXED);
+    lock_release(segment);
+  }
+  stats->load_permille = (int)((long)stats->size * 1000 / stats->capacity);
+  return C_Success;
+}
+
+/**
+ * @brief Gets the number of shards of a Croquette instance (1 if it is not sharded)
+ *
+ * @param croquette Handle to the Croquette.
+ * @return Number of shards
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_h_shard_count(croquette_t *croquette) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return C_Error;
+  }
+  return (croquette->segments != NULL) ? croquette->num_segments : 1;
+}
+
+/**
+ * @brief Gets the Occupancy and insert counters of one shard of a Croquette instance
+ *
+ * Shard 0 of a Croquette that is not sharded is the whole Croquette.
+ *
+ * @param croquette Handle to the Croquette.
+ * @param shard Shard number, under croquette_h_shard_count().
+ * @param stats Filled in with the shard's current values.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_h_shard_stats(croquette_t *croquette, int shard, Croquette_Stats_s *stats) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return C_Error;
+  }
+  if(shard < 0 || shard >= croquette_h_shard_count(croquette)) {
+    croquette_set_error(C_Invalid_Index);
+    return C_Error;
+  }
+  return croquette_h_stats((croquette->segments != NULL) ? croquette->segments[shard] : croquette, stats);
+}
+
+/**
+ * @brief Initialize the default Croquette
+ *
+ * Creates the default Croquette used by the non-handle functions.
+ * See croquette_new() for the rules and parameters; only one default Croquette may exist at a time.
+ *
+ * @param initial_capacity Initial Capacity or 0 for Default Capacity for Croquette.
+ * @param do_free Croquette_NoFree_Value or Croquette_Free_Value to select if it should free on removal.
+ * @param free_value Function to free the value if @p do_free is Croquette_Free_Value.
+ * @param value_compare Function to compare values: Returns 0 if equal, <0 if v1 < v2, >0 is v1 > v2
+ * @return C_Success on Success
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_create(int initial_capacity, 
+                    int do_free, 
+                    void (*free_value)(void *value),
+                    int (*value_compare)(const void *value1, const void *value2)) {
+  croquette_set_error(C_No_Error); // Reset Internal error tracker.
+  // Only create if it doesn't already exist.
+  if(default_croquette != NULL) {
+    croquette_set_error(C_Exists);
+    return C_Error;
+  }
+
+  default_croquette = croquette_new(initial_capacity, do_free, free_value, value_compare);
+  return (default_croquette != NULL)?C_Success:C_Error;
+}
+
+/**
+ * @brief Initialize the default Croquette from a Configuration
+ *
+ * Creates the default Croquette used by the non-handle functions.
+ * See croquette_new_config() for the Configuration; only one default Croquette may exist at a time.
+ *
+ * @param config The Configuration (see croquette_config_init()).
+ * @return C_Success on Success
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_create_config(const Croquette_Config_s *config) {
+  croquette_set_error(C_No_Error); // Reset Internal error tracker.
+  // Only create if it doesn't already exist.
+  if(default_croquette != NULL) {
+    croquette_set_error(C_Exists);
+    return C_Error;
+  }
+
+  default_croquette = croquette_new_config(config);
+  return (default_croquette != NULL)?C_Success:C_Error;
+}
+
+/**
+ * @brief Checks if the default Croquette is Empty
+ *
+ * @return 1 if Empty
+ * @return 0 if Not-Empty
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_isEmpty() {
+  return croquette_h_isEmpty(default_croquette);
+}
+
+/**
+ * @brief Gets the number of K,V entries in the default Croquette
+ *
+ * @return Size
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_size() {
+  return croquette_h_size(default_croquette);
+}
+
+/**
+ * @brief Gets the current number of Indices in the default Croquette
+ *
+ * @return Capacity 
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_capacity() {
+  return croquette_h_capacity(default_croquette);
+}
+
+/**
+ * @brief Checks if the default Croquette contains a Key
+ *
+ * @param key String based key to check
+ * @return True if Key Exists
+ * @return False if No Such Key
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_containsKey(const char *key) {
+  return croquette_h_containsKey(default_croquette, key);
+}
+
+/**
+ * @brief Checks if the default Croquette contains a Value
+ *
+ * @param value Value to check for.
+ * @return True if Value Exists
+ * @return False if No Such Value
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_containsValue(void *value) {
+  return croquette_h_containsValue(default_croquette, value);
+}
+
+/**
+ * @brief Gets the value for a given key. Will not Free the Value Returned.
+ *
+ * @param key String based key to get the value of.
+ * @return void *value if Key Exists
+ * @return NULL if No Such Key or any Errors (Error String Available)
+ */
+void *croquette_get(const char *key) {
+  return croquette_h_get(default_croquette, key);
+}
+
+/**
+ * @brief Gets the value for a given key of known length. Will not Free the Value Returned.
+ *
+ * @param key Key bytes to get the value of (need not be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @return void *value if Key Exists
+ * @return NULL if No Such Key or any Errors (Error String Available)
+ */
+void *croquette_get_n(const char *key, size_t len) {
+  return croquette_h_get_n(default_croquette, key, len);
+}
+
+/**
+ * @brief Gets the value for a given key. Will not Free the Value Returned.
+ *
+ * @param key String based key to get the value of.
+ * @return void *value if Key Exists
+ * @return default_value if No Such Key
+ * @return NULL on any Errors (Error String Available)
+ */
+void *croquette_getOrDefault(const char *key, void *default_value) {
+  return croquette_h_getOrDefault(default_croquette, key, default_value);
+}
+
+/**
+ * @brief Add a new Value to the default Croquette by Key
+ *
+ * @param key String based key to add to the croquette.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Update/Add
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_put(const char *key, void *value) {
+  return croquette_h_put(default_croquette, key, value);
+}
+
+/**
+ * @brief Add a new Value to the default Croquette by a Key of known length
+ *
+ * @param key Key bytes to add to the croquette (need not be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Update/Add
+ * @return C_Error on Error (Error String Available)
+ */
+int croquette_put_n(const char *key, size_t len, void *value) {
+  return croquette_h_put_n(default_croquette, key, len, value);
+}
+
+/**
+ * @brief Add a new Value to the default Croquette by Key only if Key has no Value
+ *
+ * @param key String based key to add to the croquette.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return NULL if key did not exist and value was added. 
+ * @return value if key did exist, existing value is returned.
+ */
+void *croquette_putIfAbsent(const char *key, void *value) {
+  return croquette_h_putIfAbsent(default_croquette, key, value);
+}
+
+/**
+ * @brief Clears and Frees all Entries in the default Croquette, Removes Croquette
+ * - Always Succeeds (no return)
+ */
+void croquette_destroy() {
+  if(default_croquette == NULL) {
+    return;
+  }
+
+  int ret = croquette_h_clear(default_croquette);
+  if(ret == C_Error) {
+    return;
+  }
+
+  croquette_delete(default_croquette);
+  default_croquette = NULL;
+}
+
+/**
+ * @brief Resets the default Croquette to Initial State (Empty)
+ *
+ * Clears all entries and resets sizes to initial.
+ *
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_clear() {
+  return croquette_h_clear(default_croquette);
+}
+
+/**
+ * @brief Removes an Entry in the default Croquette, will Rehash if needed after.
+ *
+ * Will Remove a given Entry based on its Key
+ * - Will only Free the Value if the do_free is set in configuration.
+ *
+ * @param key String based Key to identify which entry to remove.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_remove(const char *key) {
+  return croquette_h_remove(default_croquette, key);
+}
+
+/**
+ * @brief Removes an Entry in the default Croquette by a Key of known length.
+ *
+ * @param key Key bytes to identify which entry to remove (need not be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_remove_n(const char *key, size_t len) {
+  return croquette_h_remove_n(default_croquette, key, len);
+}
+
+/**
+ * @brief [Convenience Function] Prints all Keys (and their Indices) of the default Croquette
+ */
+void croquette_print_keys() {
+  croquette_h_print_keys(default_croquette);
+}
+
+/**
+ * @brief Grows the default Croquette once so n Keys fit without another resize
+ *
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_reserve(int n) {
+  return croquette_h_reserve(default_croquette, n);
+}
+
+/**
+ * @brief Pins the current capacity of the default Croquette as its floor
+ *
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_pin_capacity() {
+  return croquette_h_pin_capacity(default_croquette);
+}
+
+/**
+ * @brief Releases a pinned capacity of the default Croquette
+ *
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_unpin_capacity() {
+  return croquette_h_unpin_capacity(default_croquette);
+}
+
+/**
+ * @brief Shrinks the default Croquette to the smallest capacity that holds its Keys
+ *
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_shrink_to_fit() {
+  return croquette_h_shrink_to_fit(default_croquette);
+}
+
+/**
+ * @brief Calls visit on every Entry of the default Croquette until it returns non-zero
+ *
+ * @param visit Function to call with each Key, its length, its Value and arg.
+ * @param arg Passed through to visit.
+ * @return C_Success on Success (including stopping early)
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_foreach(Croquette_Visit_f visit, void *arg) {
+  return croquette_h_foreach(default_croquette, visit, arg);
+}
+
+/**
+ * @brief Gets the Occupancy and insert counters of the default Croquette
+ *
+ * @param stats Filled in with the current values.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+int croquette_stats(Croquette_Stats_s *stats) {
+  return croquette_h_stats(default_croquette, stats);
+}
+
+/**
+ * @brief Rehashes Croquette to the new Capacity (Larger or Smaller)
+ *
+ * The existing Carrier nodes are relinked into the new table by their cached hash,
+ * so the only allocation is the new table itself and no Key is copied or rehashed.
+ * Any Incremental Rehash in progress is completed first.
+ * 
+ * @param croquette The Croquette to rehash.
+ * @param new_capacity The new capacity for the hash table
+ * @return C_Success on Successful Rehash
+ * @return C_Error on any Failure (Error string set).
+ */
+static int perform_rehash(Croquette_s *croquette, int new_capacity) {
+  croquette_set_error(C_No_Error);
+  if(croquette == NULL) {
+    croquette_set_error(C_Uninitialized);
+    return C_Error;
+  }
+  if(new_capacity <= 0) {
+    croquette_set_error(C_Invalid_Capacity);
+    return C_Error;
+  }
+  if(croquette->lock_free_reads) {
+    return rehash_copy(croquette, new_capacity);
+  }
+
+  Carrier_s **new_sable = calloc(new_capacity, sizeof(Carrier_s *));
+  if(new_sable == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  if(croquette->old_table != NULL) {
+    rehash_migrate(croquette, croquette->old_capacity);
+  }
+
+  /* Move Croquette to the new Table, but hold the Old Table (Tree Bins are rebuilt as chains grow) */
+  bins_free(croquette);
+  Carrier_s **old_sable = croquette->table;
+  croquette->table = new_sable;
+
+  int old_capacity = croquette->capacity;
+  croquette->capacity = new_capacity;
+
+  /* Iterate the old table and push each node onto the front of its new chain. */
+  int i;
+  for(i = 0; i < old_capacity; i++) {
+    relink_chain(croquette, old_sable[i]);
+  }
+  free(old_sable);
+  return C_Success;
+}
+
+/**
+ * @brief Starts an Incremental Rehash to the new Capacity (Larger or Smaller)
+ *
+ * The current table becomes old_table and an empty table of the new capacity takes its place.
+ * New Keys go to the new table, lookups consult both, and each operation migrates
+ * rehash_step Indices via rehash_migrate() until the old table is empty.
+ *
+ * @param croquette The Croquette to rehash.
+ * @param new_capacity The new capacity for the hash table
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+static int start_rehash(Croquette_s *croquette, int new_capacity) {
+  if(new_capacity <= 0) {
+    croquette_set_error(C_Invalid_Capacity);
+    return C_Error;
+  }
+
+  Carrier_s **new_sable = calloc(new_capacity, sizeof(Carrier_s *));
+  if(new_sable == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+
+  /* Tree Bins index the current table only; unmigrated chains are walked */
+  bins_free(croquette);
+  croquette->old_table = croquette->table;
+  croquette->old_capacity = croquette->capacity;
+  croquette->rehash_index = 0;
+  croquette->table = new_sable;
+  croquette->capacity = new_capacity;
+  return C_Success;
+}
+
+/**
+ * @brief Migrates Indices of the old table during an Incremental Rehash
+ *
+ * Moves up to @p budget non-empty Indices (visiting at most 10x as many empty ones, as Redis does)
+ * from old_table into the current table, and frees old_table once it is fully migrated.
+ *
+ * @param croquette The Croquette being rehashed.
+ * @param budget Number of non-empty Indices to migrate.
+ */
+static void rehash_migrate(Croquette_s *croquette, int budget) {
+  if(croquette->old_table == NULL) {
+    return;
+  }
+
+  long empty_visits = (long)budget * 10;
+  Carrier_s *chain = NULL;
+  while(budget > 0 && croquette->rehash_index < croquette->old_capacity) {
+    chain = croquette->old_table[croquette->rehash_index];
+    croquette->old_table[croquette->rehash_index] = NULL;
+    croquette->rehash_index++;
+    if(chain != NULL) {
+      relink_chain(croquette, chain);
+      budget--;
+    }
+    else if(--empty_visits <= 0) {
+      break;
+    }
+  }
+
+  if(croquette->rehash_index >= croquette->old_capacity) {
+    free(croquette->old_table);
+    croquette->old_table = NULL;
+    croquette->old_capacity = 0;
+    croquette->rehash_index = 0;
+  }
+}
+
+/**
+ * @brief Relinks every node of a detached chain onto the front of its chain in the current table
+ *
+ * @param croquette The Croquette whose table receives the nodes.
+ * @param chain First node of the chain to move.
+ */
+static void relink_chain(Croquette_s *croquette, Carrier_s *chain) {
+  Carrier_s *mover = NULL;
+  long index = 0;
+  while(chain != NULL) {
+    mover = chain;
+    chain = chain->next;
+    index = get_index(croquette, mover->hash);
+    mover->prev = NULL;
+    mover->next = croquette->table[index];
+    if(croquette->table[index] != NULL) {
+      croquette->table[index]->prev = mover;
+    }
+    croquette->table[index] = mover;
+    bin_add(croquette, index, mover);
+  }
+}
+
+/**
+ * @brief Rehashes into a table of copied Entries, for Croquettes with lock-free readers
+ *
+ * Relinking the nodes in place would let a reader walking an old chain be led into a new one
+ * and miss its Key, so every Entry is copied into the new table, the new table is published,
+ * and the old table and nodes are retired untouched (readers already in them finish there).
+ * Every copy is made before anything changes, so running out of memory leaves the table as it was.
+ *
+ * @param croquette The Croquette to rehash.
+ * @param new_capacity The new capacity for the hash table
+ * @return C_Success on Successful Rehash
+ * @return C_Error on any Failure (Error string set).
+ */
+static int rehash_copy(Croquette_s *croquette, int new_capacity) {
+  Carrier_s **new_sable = calloc(new_capacity, sizeof(Carrier_s *));
+  Chained_View_s *view = malloc(sizeof(Chained_View_s));
+  Carrier_s *copies = NULL;
+  Carrier_s *copy = NULL;
+  Carrier_s *walker = NULL;
+  int i = 0;
+  if(new_sable == NULL || view == NULL) {
+    free(new_sable);
+    free(view);
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+
+  for(i = 0; i < croquette->capacity; i++) {
+    for(walker = croquette->table[i]; walker != NULL; walker = walker->next) {
+      copy = carrier_create(croquette, walker->key, walker->key_len, walker->hash, walker->value);
+      if(copy == NULL) {
+        while(copies != NULL) {
+          copy = copies;
+          copies = copies->next;
+          croquette_block_free(croquette, copy, carrier_size(copy->key_len));
+        }
+        free(new_sable);
+        free(view);
+        croquette_set_error(C_Insufficient_Memory);
+        return C_Error;
+      }
+      copy->next = copies;
+      copies = copy;
+    }
+  }
+
+  /* Fill the new table before any reader can see it, then retire the old one whole */
+  Carrier_s **old_sable = croquette->table;
+  int old_capacity = croquette->capacity;
+  bins_free(croquette);
+  croquette->table = new_sable;
+  croquette->capacity = new_capacity;
+  relink_chain(croquette, copies);
+  publish_view(croquette, view);
+  for(i = 0; i < old_capacity; i++) {
+    for(walker = old_sable[i]; walker != NULL; ) {
+      copy = walker;
+      walker = walker->next;
+      retire(croquette, copy, C_Retire_Node);
+    }
+  }
+  retire(croquette, old_sable, C_Retire_Block);
+  return C_Success;
+}
+
+/**
+ * @brief Finds the Value slot for a Key without taking the lock (between croquette_epoch_enter() and exit)
+ *
+ * The view gives a matching table and capacity, and every link is followed with an acquire load.
+ * Writers fill in a node before linking it and never change its Key or hash, and an unlinked node
+ * keeps its next link until it is freed, which is not before this reader exits its epoch.
+ *
+ * @param croquette The Croquette to search (lock_free_reads).
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key (from hash_code()).
+ * @return Address of the Entry's Value if Key Exists (load it atomically)
+ * @return NULL if No Such Key
+ */
+static void **chained_read(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Chained_View_s *view = __atomic_load_n(&croquette->view, __ATOMIC_ACQUIRE);
+  Carrier_s *walker = __atomic_load_n(&view->table[get_index_in(croquette, hash, view->capacity)], __ATOMIC_ACQUIRE);
+
+  char padded[CARRIER_SHORT_SIZE] = {0};
+  const char *probe = NULL;
+  if(len <= CARRIER_SHORT_KEY && croquette->key_equal == NULL) {
+    memcpy(padded, key, len);
+    probe = padded;
+  }
+  while(walker != NULL) {
+    if(walker->hash == hash && is_key(croquette, walker, key, len, probe)) {
+      return &walker->value;
+    }
+    walker = __atomic_load_n(&walker->next, __ATOMIC_ACQUIRE);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Publishes the current table and capacity to lock-free readers, retiring the old view
+ *
+ * @param croquette The Croquette whose table was replaced.
+ * @param view An unused view (allocated up front, so publishing cannot fail).
+ */
+static void publish_view(Croquette_s *croquette, Chained_View_s *view) {
+  Chained_View_s *old_view = croquette->view;
+  view->table = croquette->table;
+  view->capacity = croquette->capacity;
+  __atomic_store_n(&croquette->view, view, __ATOMIC_RELEASE);
+  if(old_view != NULL) {
+    retire(croquette, old_view, C_Retire_Block);
+  }
+}
+
+/**
+ * @brief Retires a block unlinked from a lock-free reads Croquette, reclaiming older ones in batches
+ *
+ * If the retire list cannot grow, waits for every reader to move on and frees the block at once.
+ *
+ * @param croquette The Croquette the block was unlinked from.
+ * @param block The Entry, table or view.
+ * @param kind What the block is.
+ */
+static void retire(Croquette_s *croquette, void *block, Croquette_Retire_e kind) {
+  if(!croquette_epoch_retire(&croquette->retired, block, kind)) {
+    Croquette_Retired_s item = {block, kind, 0};
+    croquette_epoch_synchronize();
+    release_retired(croquette, &item);
+    return;
+  }
+  if(croquette->retired.count >= croquette->retired.collect_at) {
+    reclaim(croquette, 0);
+  }
+}
+
+/**
+ * @brief Frees the retired blocks no reader can still hold
+ *
+ * Two attempts to advance the epoch are made, so with no reader in the way a batch is freed
+ * by the collection after it was retired.  Blocks still held stay, and the next collection
+ * waits until the list has doubled, keeping the cost per retired block constant.
+ *
+ * @param croquette The Croquette owning the retire list.
+ * @param all Boolean: free everything (only when no reader can be using the Croquette).
+ */
+static void reclaim(Croquette_s *croquette, int all) {
+  Croquette_Retire_List_s *list = &croquette->retired;
+  uint64_t epoch = UINT64_MAX;
+  int kept = 0;
+  int i = 0;
+  if(!all) {
+    croquette_epoch_advance();
+    epoch = croquette_epoch_advance();
+  }
+  for(i = 0; i < list->count; i++) {
+    if(all || list->items[i].epoch + 2 <= epoch) {
+      release_retired(croquette, &list->items[i]);
+    }
+    else {
+      list->items[kept++] = list->items[i];
+    }
+  }
+  list->count = kept;
+  list->collect_at = (kept * 2 > EPOCH_COLLECT_MIN) ? kept * 2 : EPOCH_COLLECT_MIN;
+}
+
+/**
+ * @brief Frees a retired block according to its kind
+ *
+ * @param croquette The Croquette the block came from.
+ * @param item The retired block.
+ */
+static void release_retired(Croquette_s *croquette, const Croquette_Retired_s *item) {
+  Carrier_s *entry = item->block;
+  switch(item->kind) {
+    case C_Retire_Entry:
+      free_entry(croquette, entry);
+      break;
+    case C_Retire_Node:
+      croquette_block_free(croquette, entry, carrier_size(entry->key_len));
+      break;
+    default:
+      free(item->block);
+      break;
+  }
+}
+
+/**
+ * @brief Computes the Hash Code from a Key
+ *
+ * Uses the configured hash_fn if one was given, otherwise the built-in croquette_hash().
+ *
+ * @param croquette The Croquette providing the hash function and seed.
+ * @param key The Key bytes to compute a Hash Code from
+ * @param len Number of bytes in the key.
+ * @return The Hash Code from the Key
+ */
+static uint64_t hash_code(Croquette_s *croquette, const char *key, size_t len) {
+  if(croquette->hash_fn != NULL) {
+    return croquette->hash_fn(key, len, croquette->seed);
+  }
+  return croquette_hash(key, len, croquette->seed);
+}
+
+/**
+ * @brief Picks the Segment of a segmented Croquette that holds a hash
+ *
+ * The top segment_bits of the hash times a 64-bit odd constant choose the Segment.  The product's
+ * top bits depend on every bit of the hash, so no bit a Backend reads (the low bits for the
+ * Index, the top bits for Swiss and Bucketized tags, bits 32 and up for the alternate Cuckoo
+ * bucket) is the same for every Key of a Segment.  Shifting in two steps keeps 0 bits well defined.
+ *
+ * @param croquette The Croquette (returned as is unless segmented).
+ * @param hash The hash of the Key.
+ * @return The Croquette or Segment to operate on
+ */
+static inline Croquette_s *segment_for(Croquette_s *croquette, uint64_t hash) {
+  if(croquette->segments == NULL) {
+    return croquette;
+  }
+  return croquette->segments[((hash * SEGMENT_MIX) >> (63 - croquette->segment_bits)) >> 1];
+}
+
+/**
+ * @brief Creates a segmented Croquette: num_segments thread safe Croquettes sharing one hash
+ *
+ * The outer Croquette only hashes and routes; every Segment is created from the same
+ * Configuration with its share of the initial capacity and the outer Croquette's seed.
+ *
+ * @param config The Configuration (segments > 0).
+ * @return Handle to the new Croquette on Success
+ * @return NULL on Error (Error String Available)
+ */
+static croquette_t *segmented_new(const Croquette_Config_s *config) {
+  if(config->segments < 0 || config->segments > C_Max_Segments ||
+     (config->segments & (config->segments - 1)) != 0) {
+    croquette_set_error(C_Invalid_Config);
+    return NULL;
+  }
+
+  Croquette_s *croquette = calloc(1, sizeof(Croquette_s));
+  Croquette_s **segments = calloc(config->segments, sizeof(Croquette_s *));
+  if(croquette == NULL || segments == NULL) {
+    free(croquette);
+    free(segments);
+    croquette_set_error(C_Insufficient_Memory);
+    return NULL;
+  }
+  croquette->segments = segments;
+  croquette->num_segments = config->segments;
+  while((1 << croquette->segment_bits) < config->segments) {
+    croquette->segment_bits++;
+  }
+  croquette->hash_fn = config->hash_fn;
+  croquette->seed = config->fixed_seed ? config->seed : random_seed(croquette);
+
+  Croquette_Config_s segment_config = *config;
+  int initial_capacity = (config->initial_capacity > 0) ? config->initial_capacity : CROQUETTE_DEFAULT_INITIAL_SIZE;
+  segment_config.segments = 0;
+  segment_config.thread_safe = 1;
+  segment_config.initial_capacity = (initial_capacity + config->segments - 1) / config->segments;
+  segment_config.fixed_seed = 1;
+  segment_config.seed = croquette->seed;
+  int s = 0;
+  for(s = 0; s < config->segments; s++) {
+    segments[s] = croquette_new_config(&segment_config);
+    if(segments[s] == NULL) {
+      Croquette_Error_Code_e error = croquette_get_error();
+      croquette->num_segments = s;
+      croquette_delete(croquette);
+      croquette_set_error(error);
+      return NULL;
+    }
+  }
+  return croquette;
+}
+
+/**
+ * @brief Draws a random seed for an instance's Key hash
+ *
+ * Uses getrandom() where available, then /dev/urandom.  If neither can be read, the clock,
+ * the salt's address and a counter are mixed instead, so creating a Croquette never fails here.
+ *
+ * @param salt Address mixed into the fallback seed (the new instance).
+ * @return The seed.
+ */
+static uint64_t random_seed(const void *salt) {
+  static uint64_t counter = 0;
+  uint64_t seed = 0;
+  size_t got = 0;
+
+#ifdef __linux__
+  while(got < sizeof(seed)) {
+    ssize_t ret = getrandom((char *)&seed + got, sizeof(seed) - got, 0);
+    if(ret <= 0) {
+      break;
+    }
+    got += ret;
+  }
+#endif
+  if(got < sizeof(seed)) {
+    FILE *urandom = fopen("/dev/urandom", "rb");
+    if(urandom != NULL) {
+      got = fread(&seed, 1, sizeof(seed), urandom);
+      fclose(urandom);
+    }
+  }
+  if(got < sizeof(seed)) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    seed = croquette_hash((const char *)&ts, sizeof(ts),
+                          (uint64_t)(uintptr_t)salt ^ __atomic_add_fetch(&counter, 1, __ATOMIC_RELAXED));
+  }
+  return seed;
+}
+
+/**
+ * @brief Gets the length of a NUL terminated Key (0 for NULL)
+ *
+ * @param key The String key to measure.
+ * @return Number of characters in the key.
+ */
+static size_t key_length(const char *key) {
+  return (key != NULL)?strlen(key):0;
+}
+
+/**
+ * @brief Checks that a Key is usable: non-NULL, non-empty and at most MAX_KEY_SIZE bytes.
+ *
+ * @param key The Key bytes.
+ * @param len Number of bytes in the key.
+ * @return True if the Key is valid.
+ */
+static int is_valid_key(const char *key, size_t len) {
+  return key != NULL && len > 0 && len <= MAX_KEY_SIZE;
+}
 
-  int old_capacity = croquette->capacity;
-  croquette->capacity = new_capacity;
-  croquette->size = 0; // Will all be added back in properly below
+/**
+ * @brief Multiplies two 64-bit words and folds the 128-bit product back to 64 bits
+ *
+ * @param a First factor.
+ * @param b Second factor.
+ * @return The low half of the product XOR'd with the high half.
+ */
+static inline uint64_t hash_mum(uint64_t a, uint64_t b) {
+  croquette_u128 product = (croquette_u128)a * b;
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
 
+/**
+ * @brief Reads 8 (unaligned) bytes of a key as a word
+ */
+static inline uint64_t hash_read8(const uint8_t *bytes) {
+  uint64_t word;
+  memcpy(&word, bytes, sizeof(word));
+  return word;
+}
 
-  /* Iterate the old table and hash all the values into the new table.
-   * Free the old symbols
-   */
-  Carrier_s *walker = NULL;
-  Carrier_s *reaper = NULL;
-  int i;
-  for(i = 0; i < old_capacity; i++) {
-    if(old_sable[i] != NULL) {
-      walker = old_sable[i];
-      while(walker != NULL) {
-        reaper = walker;
-        croquette_put(walker->key, walker->value);
-        walker = walker->next;
-        // The object was moved to the next table, so cut the pointer here first.
-        reaper->value = NULL;
-        free_entry(reaper);
-      }
-    }
-  }
-  free(old_sable);
-  return C_Success;
+/**
+ * @brief Reads 4 (unaligned) bytes of a key as a word
+ */
+static inline uint64_t hash_read4(const uint8_t *bytes) {
+  uint32_t word;
+  memcpy(&word, bytes, sizeof(word));
+  return word;
 }
 
 /**
- * @brief Computes the Hash Code from a String
+ * @brief Computes a 64-bit Hash of a Key (wyhash family)
  *
- * @param key The String key to compute a Hash Code from
- * @return The Hash Code from the Key
+ * Consumes the key a word at a time (16 bytes per round, 48 bytes per round on long keys)
+ * and finishes with a full-width multiply so every input bit affects every output bit.
+ * Keys of 16 bytes or less are read with at most four overlapping loads and no loop.
+ * The seed is folded into both factors of every multiply, so no key block can zero a product
+ * (and erase the seed) without knowing the seed.
+ *
+ * @param key The key bytes to hash (does not need to be NUL terminated).
+ * @param len Number of bytes in the key.
+ * @param seed Seed to perturb the hash with.
+ * @return The 64-bit Hash Code of the Key
  */
-static long hash_code(const char *key) {
-  long code = 0;
-  int i = 0;
-  int size = strlen(key);
-
-  for(i = 0; i < size; i++) {
-    code += key[i];
-    if(size == 1 || i < (size - 1)) {
-      code <<= 7;
+uint64_t croquette_hash(const char *key, size_t len, uint64_t seed) {
+  const uint8_t *bytes = (const uint8_t *)key;
+  uint64_t a = 0;
+  uint64_t b = 0;
+  size_t remaining = len;
+  uint64_t secret = 0;
+
+  seed ^= hash_mum(seed ^ HASH_P0, HASH_P1);
+  secret = seed;
+
+  if(len <= 16) {
+    if(len >= 4) {
+      // Two overlapping pairs of 4-byte reads cover every byte of 4..16 byte keys
+      size_t shift = (len >> 3) << 2;
+      a = (hash_read4(bytes) << 32) | hash_read4(bytes + shift);
+      b = (hash_read4(bytes + len - 4) << 32) | hash_read4(bytes + len - 4 - shift);
+    }
+    else if(len > 0) {
+      a = ((uint64_t)bytes[0] << 16) | ((uint64_t)bytes[len >> 1] << 8) | bytes[len - 1];
+    }
+  }
+  else {
+    if(remaining > 48) {
+      // Three independent lanes keep the multipliers busy on long keys
+      uint64_t lane1 = seed;
+      uint64_t lane2 = seed;
+      do {
+        seed = hash_mum(hash_read8(bytes) ^ HASH_P1 ^ secret, hash_read8(bytes + 8) ^ seed);
+        lane1 = hash_mum(hash_read8(bytes + 16) ^ HASH_P2 ^ secret, hash_read8(bytes + 24) ^ lane1);
+        lane2 = hash_mum(hash_read8(bytes + 32) ^ HASH_P3 ^ secret, hash_read8(bytes + 40) ^ lane2);
+        bytes += 48;
+        remaining -= 48;
+      } while(remaining > 48);
+      seed ^= lane1 ^ lane2;
+    }
+    while(remaining > 16) {
+      seed = hash_mum(hash_read8(bytes) ^ HASH_P1 ^ secret, hash_read8(bytes + 8) ^ seed);
+      bytes += 16;
+      remaining -= 16;
     }
+    // The last 16 bytes (overlapping the previous round if needed)
+    a = hash_read8(bytes + remaining - 16);
+    b = hash_read8(bytes + remaining - 8);
   }
 
-  return code;
+  a ^= HASH_P1 ^ secret;
+  b ^= seed;
+  croquette_u128 product = (croquette_u128)a * b;
+  a = (uint64_t)product;
+  b = (uint64_t)(product >> 64);
+  return hash_mum(a ^ HASH_P0 ^ len, b ^ HASH_P1);
 }
 
 /**
  * @brief Creates a new Carrier entry object
+ *
+ * The node and its inline Key copy are one block (carrier_size()), from the Croquette's Slab
+ * if it has one, otherwise from malloc().  Short Keys are zero padded to CARRIER_SHORT_SIZE.
  * 
- * @param key The String Key to add to the new Entry
+ * @param croquette The Croquette the Entry is created for.
+ * @param key The Key bytes to copy into the new Entry (stored NUL terminated)
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the Key, cached in the Entry
  * @param value The generic Value to add to the new Entry
  * @return Carrier entry object on Success
  * @return NULL on errors (error string available)
  */
-static Carrier_s *carrier_create(const char *key, void *value) {
+static Carrier_s *carrier_create(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
   croquette_set_error(C_No_Error);
-  Carrier_s *entry = calloc(1, sizeof(Carrier_s));
+  Carrier_s *entry = NULL;
+  if(croquette->slab != NULL) {
+    entry = croquette_slab_alloc(croquette->slab, carrier_size(len));
+  }
+  else {
+    entry = malloc(carrier_size(len));
+  }
   if(entry == NULL) {
     croquette_set_error(C_Insufficient_Memory);
     return NULL;
   }
-
-  int key_size = min(MAX_KEY_SIZE, strlen(key) + 1);
-  entry->key = calloc(1, key_size);
-  strncpy((char *)entry->key, key, key_size);
+  if(len <= CARRIER_SHORT_KEY) {
+    memset(entry->key, 0, CARRIER_SHORT_SIZE);
+  }
+  memcpy(entry->key, key, len);
+  entry->key[len] = '\0';
+  entry->key_len = len;
+  entry->hash = hash;
   entry->value = value;
   entry->next = NULL;
   entry->prev = NULL;
@@ -726,12 +2591,13 @@ static Carrier_s *carrier_create(const char *key, void *value) {
 /**
  * @brief Inserts an Entry at the given Index
  * 
+ * @param croquette The Croquette to insert into.
  * @param index The index to insert the Entry into
  * @param entry The entry to insert at that index
  * @return C_Success on Success
  * @return C_Error on Error Condition (Error string available)
  */
-static int insert_at_index(int index, Carrier_s *entry) {
+static int insert_at_index(Croquette_s *croquette, int index, Carrier_s *entry) {
   croquette_set_error(C_No_Error);
   if(croquette == NULL) {
     croquette_set_error(C_Uninitialized);
@@ -743,8 +2609,15 @@ static int insert_at_index(int index, Carrier_s *entry) {
   }
 
   /* Simple Case, nothing at index, so insert it */
+  /* - Links that publish the Entry are release stores, for lock-free readers */
   if(croquette->table[index] == NULL) {
-    croquette->table[index] = entry;
+    link_store(&croquette->table[index], entry);
+  }
+  /* A Tree Bin chain may be long, so push onto the front rather than walk it */
+  else if(croquette->bins != NULL && croquette->bins[index] != NULL) {
+    entry->next = croquette->table[index];
+    croquette->table[index]->prev = entry;
+    link_store(&croquette->table[index], entry);
   }
   /* Else, iterate to find the tail and insert there */
   else {
@@ -752,49 +2625,170 @@ static int insert_at_index(int index, Carrier_s *entry) {
     while(walker->next != NULL) {
       walker = walker->next;
     }
-    walker->next = entry;
     entry->prev = walker;
+    link_store(&walker->next, entry);
   }
   croquette->size++;
+  bin_add(croquette, index, entry);
   return C_Success;
 }
 
 /**
- * @brief Gets the index for a Key
+ * @brief Takes the lock of a thread safe Croquette for a lookup
  *
- * @param key The String key to generate the Index from
- * @return Hashed Index from the Key
- * @return C_General_Error (Error string available)
+ * Shared, unless Incremental Rehash is on: then every lookup migrates Indices, so it is exclusive.
+ * A non-blocking Backend takes no lock: the operation runs inside an epoch instead, so nothing
+ * it reaches is reclaimed before it ends.
+ *
+ * @param croquette The Croquette to lock.
  */
-static long get_index(const char *key) {
-  croquette_set_error(C_No_Error);
-  if(croquette == NULL) {
-    croquette_set_error(C_Uninitialized);
-    return C_General_Error;
+static inline void lock_read(Croquette_s *croquette) {
+  if(croquette->non_blocking) {
+    while(!croquette_epoch_enter()) { // Registering the thread failed (out of memory)
+      sched_yield();
+    }
+    return;
   }
-    
-  if(key == NULL || strlen(key) == 0) {
-    croquette_set_error(C_Invalid_Key);
-    return C_General_Error;
+  if(!croquette->thread_safe) {
+    return;
   }
-  
-  long code = hash_code(key);
+  if(croquette->rehash_step > 0) {
+    pthread_rwlock_wrlock(&croquette->lock);
+  }
+  else {
+    pthread_rwlock_rdlock(&croquette->lock);
+  }
+}
+
+/**
+ * @brief Takes the lock of a thread safe Croquette exclusively, for a change
+ *
+ * A non-blocking Backend enters an epoch instead, as in lock_read().
+ *
+ * @param croquette The Croquette to lock.
+ */
+static inline void lock_write(Croquette_s *croquette) {
+  if(croquette->non_blocking) {
+    while(!croquette_epoch_enter()) { // Registering the thread failed (out of memory)
+      sched_yield();
+    }
+    return;
+  }
+  if(croquette->thread_safe) {
+    pthread_rwlock_wrlock(&croquette->lock);
+  }
+}
+
+/**
+ * @brief Releases the lock taken by lock_read() or lock_write()
+ *
+ * @param croquette The Croquette to unlock.
+ */
+static inline void lock_release(Croquette_s *croquette) {
+  if(croquette->non_blocking) {
+    croquette_epoch_exit();
+    return;
+  }
+  if(croquette->thread_safe) {
+    pthread_rwlock_unlock(&croquette->lock);
+  }
+}
+
+/**
+ * @brief Takes the lock of a thread safe Croquette exclusively, to change capacity settings
+ *
+ * The same as lock_write() but for non-blocking Backends, whose Entry operations take no lock:
+ * settings changes (pinned, base_capacity) still wait on each other, and on nothing else.
+ *
+ * @param croquette The Croquette to lock.
+ */
+static inline void lock_settings(Croquette_s *croquette) {
+  if(croquette->thread_safe) {
+    pthread_rwlock_wrlock(&croquette->lock);
+  }
+}
+
+/**
+ * @brief Releases the lock taken by lock_settings()
+ *
+ * @param croquette The Croquette to unlock.
+ */
+static inline void unlock_settings(Croquette_s *croquette) {
+  if(croquette->thread_safe) {
+    pthread_rwlock_unlock(&croquette->lock);
+  }
+}
+
+/**
+ * @brief Stores a chain link with release order, so a lock-free reader that loads it sees the Entry filled in
+ *
+ * @param link The table slot or next pointer to set.
+ * @param entry The Entry to link (or NULL).
+ */
+static inline void link_store(Carrier_s **link, Carrier_s *entry) {
+  __atomic_store_n(link, entry, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Gets the index for a Key's hash
+ *
+ * In Power of Two mode the high half of the hash is folded into the low half and masked,
+ * so no division is needed and hashes with weak low bits still spread over all buckets.
+ * Otherwise the index is the hash modulo the capacity.
+ *
+ * @param croquette The Croquette whose capacity is used.
+ * @param hash The hash of the Key (from hash_code() or a cached Carrier_s hash)
+ * @return Hashed Index from the Key
+ */
+static inline long get_index(Croquette_s *croquette, uint64_t hash) {
+  return get_index_in(croquette, hash, croquette->capacity);
+}
+
+/**
+ * @brief Gets the index for a Key's hash in a table of the given capacity
+ *
+ * @param croquette The Croquette whose capacity mode is used.
+ * @param hash The hash of the Key (from hash_code() or a cached Carrier_s hash)
+ * @param capacity Number of Indices in the table (table or old_table).
+ * @return Hashed Index from the Key
+ */
+static inline long get_index_in(Croquette_s *croquette, uint64_t hash, int capacity) {
+  if(croquette->pow2) {
+    return (hash ^ (hash >> 32)) & (uint64_t)(capacity - 1);
+  }
+  return hash % capacity;
+}
 
-  return code % croquette->capacity;
+/**
+ * @brief Gets the size of the single allocation holding a Carrier and its Key
+ *
+ * @param len Number of bytes in the key.
+ * @return Bytes to allocate (short Keys all share one size, 64 bytes on LP64)
+ */
+static inline size_t carrier_size(size_t len) {
+  return sizeof(Carrier_s) + (len <= CARRIER_SHORT_KEY ? CARRIER_SHORT_SIZE : len + 1);
 }
 
 /**
  * @brief Check if the Key matches the Entry's Key
  *
- * The comparison is done via a string comparison up to MAX_KEY_SIZE
+ * Uses the configured key_equal if one was given, otherwise
+ * the comparison is done on the lengths and then the bytes.
+ * A short Key padded into probe is compared as one fixed size block (no length dependent loop).
  *
+ * @param croquette The Croquette providing the key_equal function.
  * @param entry The Entry to compare keys against.
- * @param key The String key to compare against the Entry's key.
+ * @param key The Key bytes to compare against the Entry's key.
+ * @param len Number of bytes in the key.
+ * @param probe The Key zero padded to CARRIER_SHORT_SIZE, or NULL if not a short Key.
  * @return True if the Key matches the Entry's Key
  * @return False if the Key does not match the Entry's Key
  */
-static int is_key(Carrier_s *entry, const char *key) {
-  return !(strncmp(entry->key, key, MAX_KEY_SIZE));
+static int is_key(Croquette_s *croquette, Carrier_s *entry, const char *key, size_t len, const char *probe) {
+  if(probe != NULL) {
+    return entry->key_len == len && memcmp(entry->key, probe, CARRIER_SHORT_SIZE) == 0;
+  }
+  return croquette_key_equal(croquette, entry->key, entry->key_len, key, len);
 }
 
 /**
@@ -802,12 +2796,13 @@ static int is_key(Carrier_s *entry, const char *key) {
  *
  * The comparison is done via value_compare function.
  *
+ * @param croquette The Croquette providing the value_compare function.
  * @param entry The Entry to compare keys against.
  * @param value The Value to compare against the Entry's key.
  * @return True if the Value matches the Entry's Value.
  * @return False if the Value does not match the Entry's Value.
  */
-static int is_value(Carrier_s *entry, const void *value) {
+static int is_value(Croquette_s *croquette, Carrier_s *entry, const void *value) {
   return (croquette->value_compare(entry->value, value)) == 0;
 }
 
@@ -816,34 +2811,48 @@ static int is_value(Carrier_s *entry, const void *value) {
  *
  * This function will only free the Value if do_free was configured on Initialization.
  *
+ * @param croquette The Croquette holding the Entry.
  * @param entry The Entry to remove from Croquette
  * @return C_Success on Success
  * @return C_Error on any Error (Error string available)
  */
-static int remove_entry(Carrier_s *entry) {
+static int remove_entry(Croquette_s *croquette, Carrier_s *entry) {
   croquette_set_error(C_No_Error);
   if(entry == NULL) {
     croquette_set_error(C_Entry_NULL);
     return C_Error;
   }
 
-  int index = get_index(entry->key);
+  long index = get_index(croquette, entry->hash);
+  bin_remove(croquette, index, entry);
 
   // Case where this is the first item in the Index, simply update the table around it.
+  // - During an Incremental Rehash, the head may still be in the old table.
   if(entry->prev == NULL) {
-    croquette->table[index] = entry->next;
+    if(croquette->table[index] == entry) {
+      link_store(&croquette->table[index], entry->next);
+    }
+    else {
+      croquette->old_table[get_index_in(croquette, entry->hash, croquette->old_capacity)] = entry->next;
+    }
   } 
   // Otherwise, bridge around it forward.
   else {
-    entry->prev->next = entry->next;
+    link_store(&entry->prev->next, entry->next);
   }
   // Either way, bridge around it backwards
   if(entry->next) {
     entry->next->prev = entry->prev;
   }
   // Now, free the entry.  (Also frees value if configured to do_free)
-  entry->next = NULL;
-  free_entry(entry);
+  // - A lock-free reader may be standing on it, so it keeps its next link until reclaimed
+  if(croquette->lock_free_reads) {
+    retire(croquette, entry, C_Retire_Entry);
+  }
+  else {
+    entry->next = NULL;
+    free_entry(croquette, entry);
+  }
   
   // And adjust the croquette size
   croquette->size--;
@@ -856,18 +2865,42 @@ static int remove_entry(Carrier_s *entry) {
  *
  * Will only free the memory if do_free was configured during Initialization.
  *
+ * @param croquette The Croquette holding the Entry.
  * @param entry The Entry to free
  */
-static void free_entry(Carrier_s *entry) {
+static void free_entry(Croquette_s *croquette, Carrier_s *entry) {
   if(croquette != NULL && entry != NULL && croquette->do_free == C_Do_Free) {
     croquette->free_value(entry->value);
   }
-  if(entry->key) {
-    free(entry->key);
+  if(croquette->slab != NULL) {
+    croquette_slab_free(croquette->slab, entry, carrier_size(entry->key_len));
+    return;
   }
   free(entry);
 }
 
+/**
+ * @brief Frees every Entry of a detached chain (Values only if do_free)
+ *
+ * With a Slab, only the Values are freed here; the nodes are released with their slabs.
+ *
+ * @param croquette The Croquette holding the chain.
+ * @param chain First Entry of the chain.
+ */
+static void release_chain(Croquette_s *croquette, Carrier_s *chain) {
+  Carrier_s *reaper = NULL;
+  while(chain != NULL) {
+    reaper = chain;
+    chain = chain->next;
+    if(croquette->slab == NULL) {
+      free_entry(croquette, reaper);
+    }
+    else if(croquette->do_free == C_Do_Free) {
+      croquette->free_value(reaper->value);
+    }
+  }
+}
+
 /**
  * @brief [Convenience Function] Prints a Description for the given Croquette Error.
  */
@@ -903,3 +2936,316 @@ Croquette_Error_Code_e croquette_get_error() {
   return croquette_error;
 }
 
+
+/**
+ * @brief Checks if a chain has more than limit Entries (walks at most limit + 1)
+ *
+ * @param chain First Entry of the chain.
+ * @param limit Number of Entries allowed.
+ * @return True if the chain is longer than limit
+ */
+static int chain_longer_than(const Carrier_s *chain, int limit) {
+  while(chain != NULL && limit >= 0) {
+    chain = chain->next;
+    limit--;
+  }
+  return limit < 0;
+}
+
+/**
+ * @brief Records a newly linked Entry in its Index's Tree Bin, converting a long chain to one
+ *
+ * If memory for the tree runs out, the Index simply stays (or goes back to) a plain chain.
+ *
+ * @param croquette The Croquette holding the table.
+ * @param index Index the Entry was linked into.
+ * @param entry The Entry.
+ */
+static void bin_add(Croquette_s *croquette, long index, Carrier_s *entry) {
+  if(croquette->bins == NULL || croquette->bins[index] == NULL) {
+    if(chain_longer_than(croquette->table[index], CHAIN_TREEIFY)) {
+      bin_treeify(croquette, index);
+    }
+    return;
+  }
+
+  Tree_Bin_s *bin = croquette->bins[index];
+  Tree_Node_s *node = calloc(1, sizeof(Tree_Node_s));
+  if(node == NULL) {
+    tree_free(bin->root);
+    free(bin);
+    croquette->bins[index] = NULL;
+    return;
+  }
+  node->entry = entry;
+  node->height = 1;
+  bin->root = tree_insert(bin->root, node);
+  bin->count++;
+}
+
+/**
+ * @brief Drops an Entry from its Index's Tree Bin, converting a short bin back to a chain
+ *
+ * Entries not in the tree (not yet migrated by an Incremental Rehash) are ignored.
+ *
+ * @param croquette The Croquette holding the table.
+ * @param index Index of the Entry in the current table.
+ * @param entry The Entry being removed.
+ */
+static void bin_remove(Croquette_s *croquette, long index, Carrier_s *entry) {
+  if(croquette->bins == NULL || croquette->bins[index] == NULL) {
+    return;
+  }
+
+  Tree_Bin_s *bin = croquette->bins[index];
+  int found = 0;
+  bin->root = tree_delete(bin->root, entry, &found);
+  bin->count -= found;
+  if(bin->count < CHAIN_UNTREEIFY) {
+    tree_free(bin->root);
+    free(bin);
+    croquette->bins[index] = NULL;
+  }
+}
+
+/**
+ * @brief Builds a Tree Bin over the chain at an Index
+ *
+ * @param croquette The Croquette holding the table.
+ * @param index Index of the long chain.
+ */
+static void bin_treeify(Croquette_s *croquette, long index) {
+  Carrier_s *walker = NULL;
+
+  if(croquette->bins == NULL) {
+    croquette->bins = calloc(croquette->capacity, sizeof(Tree_Bin_s *));
+    if(croquette->bins == NULL) {
+      return;
+    }
+  }
+  Tree_Bin_s *bin = calloc(1, sizeof(Tree_Bin_s));
+  if(bin == NULL) {
+    return;
+  }
+  croquette->bins[index] = bin;
+  for(walker = croquette->table[index]; walker != NULL; walker = walker->next) {
+    Tree_Node_s *node = calloc(1, sizeof(Tree_Node_s));
+    if(node == NULL) {
+      tree_free(bin->root);
+      free(bin);
+      croquette->bins[index] = NULL;
+      return;
+    }
+    node->entry = walker;
+    node->height = 1;
+    bin->root = tree_insert(bin->root, node);
+    bin->count++;
+  }
+}
+
+/**
+ * @brief Frees every Tree Bin (the chains are untouched)
+ *
+ * @param croquette The Croquette holding the table.
+ */
+static void bins_free(Croquette_s *croquette) {
+  int i = 0;
+  if(croquette->bins == NULL) {
+    return;
+  }
+  for(i = 0; i < croquette->capacity; i++) {
+    if(croquette->bins[i] != NULL) {
+      tree_free(croquette->bins[i]->root);
+      free(croquette->bins[i]);
+    }
+  }
+  free(croquette->bins);
+  croquette->bins = NULL;
+}
+
+/**
+ * @brief Orders an Entry against a (hash, Key) pair: by hash, then length, then bytes
+ *
+ * @return <0 if the Entry orders first, 0 if identical, >0 if the Entry orders after
+ */
+static int tree_order(const Carrier_s *entry, uint64_t hash, const char *key, size_t len) {
+  if(entry->hash != hash) {
+    return (entry->hash < hash)?-1:1;
+  }
+  if(entry->key_len != len) {
+    return (entry->key_len < len)?-1:1;
+  }
+  return memcmp(entry->key, key, len);
+}
+
+/**
+ * @brief Finds a Key in a Tree Bin
+ *
+ * With byte-wise Keys the search follows the tree order.  A custom key_equal may match Keys
+ * with other bytes, so among equal hashes both subtrees are searched.
+ *
+ * @param croquette The Croquette (for key_equal).
+ * @param node Root of the (sub)tree.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return The Entry if found, else NULL
+ */
+static Carrier_s *tree_find(Croquette_s *croquette, Tree_Node_s *node, const char *key, size_t len, uint64_t hash) {
+  int order = 0;
+  while(node != NULL) {
+    if(croquette->key_equal != NULL && node->entry->hash == hash) {
+      if(croquette_key_equal(croquette, node->entry->key, node->entry->key_len, key, len)) {
+        return node->entry;
+      }
+      Carrier_s *found = tree_find(croquette, node->left, key, len, hash);
+      return (found != NULL)?found:tree_find(croquette, node->right, key, len, hash);
+    }
+    order = tree_order(node->entry, hash, key, len);
+    if(order == 0) {
+      return node->entry;
+    }
+    node = (order > 0)?node->left:node->right;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Gets the height of a subtree (0 if empty)
+ */
+static inline int tree_height(const Tree_Node_s *node) {
+  return (node != NULL)?node->height:0;
+}
+
+/**
+ * @brief Recomputes a node's height from its children
+ */
+static inline void tree_fix(Tree_Node_s *node) {
+  int left = tree_height(node->left);
+  int right = tree_height(node->right);
+  node->height = ((left > right)?left:right) + 1;
+}
+
+/**
+ * @brief Rotates a subtree right (the left child becomes the root)
+ *
+ * @return The new root of the subtree
+ */
+static Tree_Node_s *tree_rotate_right(Tree_Node_s *node) {
+  Tree_Node_s *pivot = node->left;
+  node->left = pivot->right;
+  pivot->right = node;
+  tree_fix(node);
+  tree_fix(pivot);
+  return pivot;
+}
+
+/**
+ * @brief Rotates a subtree left (the right child becomes the root)
+ *
+ * @return The new root of the subtree
+ */
+static Tree_Node_s *tree_rotate_left(Tree_Node_s *node) {
+  Tree_Node_s *pivot = node->right;
+  node->right = pivot->left;
+  pivot->left = node;
+  tree_fix(node);
+  tree_fix(pivot);
+  return pivot;
+}
+
+/**
+ * @brief Restores the AVL balance of a subtree whose children differ in height by at most 2
+ *
+ * @return The new root of the subtree
+ */
+static Tree_Node_s *tree_balance(Tree_Node_s *node) {
+  tree_fix(node);
+  int balance = tree_height(node->left) - tree_height(node->right);
+  if(balance > 1) {
+    if(tree_height(node->left->left) < tree_height(node->left->right)) {
+      node->left = tree_rotate_left(node->left);
+    }
+    return tree_rotate_right(node);
+  }
+  if(balance < -1) {
+    if(tree_height(node->right->right) < tree_height(node->right->left)) {
+      node->right = tree_rotate_right(node->right);
+    }
+    return tree_rotate_left(node);
+  }
+  return node;
+}
+
+/**
+ * @brief Inserts a node into an AVL (sub)tree
+ *
+ * @param node Root of the (sub)tree.
+ * @param fresh The node to insert (its Entry is not already in the tree).
+ * @return The new root of the subtree
+ */
+static Tree_Node_s *tree_insert(Tree_Node_s *node, Tree_Node_s *fresh) {
+  if(node == NULL) {
+    return fresh;
+  }
+  const Carrier_s *entry = fresh->entry;
+  if(tree_order(node->entry, entry->hash, entry->key, entry->key_len) > 0) {
+    node->left = tree_insert(node->left, fresh);
+  }
+  else {
+    node->right = tree_insert(node->right, fresh);
+  }
+  return tree_balance(node);
+}
+
+/**
+ * @brief Deletes an Entry's node from an AVL (sub)tree
+ *
+ * @param node Root of the (sub)tree.
+ * @param entry The Entry to remove.
+ * @param found Set to 1 if the Entry was in the tree.
+ * @return The new root of the subtree
+ */
+static Tree_Node_s *tree_delete(Tree_Node_s *node, const Carrier_s *entry, int *found) {
+  if(node == NULL) {
+    return NULL;
+  }
+  int order = tree_order(node->entry, entry->hash, entry->key, entry->key_len);
+  if(order > 0) {
+    node->left = tree_delete(node->left, entry, found);
+  }
+  else if(order < 0) {
+    node->right = tree_delete(node->right, entry, found);
+  }
+  else {
+    Tree_Node_s *child = NULL;
+    *found = 1;
+    if(node->left == NULL || node->right == NULL) {
+      child = (node->left != NULL)?node->left:node->right;
+      free(node);
+      return child;
+    }
+    /* Two children: take over the successor's Entry, then delete the successor */
+    child = node->right;
+    while(child->left != NULL) {
+      child = child->left;
+    }
+    node->entry = child->entry;
+    node->right = tree_delete(node->right, child->entry, found);
+  }
+  return tree_balance(node);
+}
+
+/**
+ * @brief Frees every node of a (sub)tree (the Entries are untouched)
+ *
+ * @param node Root of the (sub)tree.
+ */
+static void tree_free(Tree_Node_s *node) {
+  if(node == NULL) {
+    return;
+  }
+  tree_free(node->left);
+  tree_free(node->right);
+  free(node);
+}
@@ -0,0 +1,613 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_bucket.c
+ * @brief Bucketized Chaining Backend for Croquette
+ * - Each Index is one 64 byte line holding up to 7 (tag, Entry) pairs, stored in the table.
+ * - A lookup compares 8 bit tags from the hash within the line before reading any Entry,
+ *   so a typical chain of 1-3 Keys costs one line plus the matching Entry.
+ * - A full line moves its last pair into an overflow line and links it from that slot,
+ *   so every line but the last of a chain holds 6 pairs.
+ * - Entries have no chain pointers: a hash, the Value and the Key in one allocation.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croquette_internal.h"
+
+// Bucket Sizes
+#define BUCKET_SLOTS 7          // (tag, Entry) pairs per line
+#define BUCKET_LINE 64          // Line alignment (one cache line)
+#define BUCKET_MORE 0x80        // Line count flag: the last slot links the next line
+#define BUCKET_MAX_LOAD 4       // Doubles past this many Keys per line on average
+
+/**
+ * @struct Bucket_Entry_s
+ *
+ * @brief An Entry: the hash, the Value and its Key in one allocation
+ */
+typedef struct bucket_entry {
+  uint64_t hash;          ///< Full hash of the Key (resizes never rehash Keys).
+  void *value;            ///< Value for Croquette to Store.
+  uint32_t key_len;       ///< Number of bytes in the Key.
+  char key[];             ///< Key for Croquette (NUL terminated copy).
+} Bucket_Entry_s;
+
+/**
+ * @struct Bucket_Line_s
+ *
+ * @brief One 64 byte line of a chain: 7 tags, a count and 7 slots
+ *
+ * Slots hold Entries, except that the last slot of a line flagged BUCKET_MORE holds the next line.
+ */
+typedef struct bucket_line {
+  uint8_t tags[BUCKET_SLOTS];     ///< High byte of the hash of each occupied slot.
+  uint8_t count;                  ///< Occupied slots, | BUCKET_MORE if the chain continues.
+  void *slots[BUCKET_SLOTS];      ///< Entry of each occupied slot (or the next line).
+} Bucket_Line_s;
+
+/**
+ * @struct Bucket_Store_s
+ *
+ * @brief State of the Bucketized table
+ */
+typedef struct bucket_store {
+  Bucket_Line_s *lines;       ///< Head line of every Index (cache line aligned).
+  size_t num_lines;           ///< Power of Two number of Indices.
+} Bucket_Store_s;
+
+// Internal Prototypes - (Private to this Source File Only)
+static int bucket_init(Croquette_s *croquette, int capacity);
+static void bucket_destroy(Croquette_s *croquette);
+static void **bucket_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void **bucket_find_value(Croquette_s *croquette, const void *value);
+static int bucket_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static int bucket_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int bucket_clear(Croquette_s *croquette);
+static void bucket_print_keys(Croquette_s *croquette);
+static int bucket_reserve(Croquette_s *croquette, int n);
+static int bucket_shrink_to_fit(Croquette_s *croquette);
+static int bucket_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+static Bucket_Line_s *bucket_alloc_lines(size_t num_lines);
+static void bucket_free_overflow(Bucket_Store_s *store);
+static int bucket_append(Bucket_Store_s *store, Bucket_Entry_s *entry);
+static int bucket_resize(Croquette_s *croquette, size_t num_lines);
+static int bucket_find_slot(Croquette_s *croquette, const char *key, size_t len, uint64_t hash,
+                            Bucket_Line_s **found, int *slot);
+static inline size_t bucket_index(uint64_t hash, size_t mask);
+static inline uint8_t bucket_tag(uint64_t hash);
+static inline int bucket_count(const Bucket_Line_s *line);
+static inline Bucket_Line_s *bucket_next(const Bucket_Line_s *line);
+static inline size_t bucket_entry_size(size_t len);
+
+// Bucketized Chaining Backend
+const Croquette_Backend_s croquette_bucket_backend = {
+  .name = "bucketized",
+  .init = bucket_init,
+  .destroy = bucket_destroy,
+  .find = bucket_find,
+  .find_value = bucket_find_value,
+  .insert = bucket_insert,
+  .remove = bucket_remove,
+  .clear = bucket_clear,
+  .print_keys = bucket_print_keys,
+  .reserve = bucket_reserve,
+  .shrink_to_fit = bucket_shrink_to_fit,
+  .foreach = bucket_foreach
+};
+
+/**
+ * @brief Gets the Index of a hash (folding the high half in, as Power of Two chaining does)
+ *
+ * @param hash The hash of the key.
+ * @param mask Number of lines - 1.
+ * @return Index of the head line
+ */
+static inline size_t bucket_index(uint64_t hash, size_t mask) {
+  return (size_t)(hash ^ (hash >> 32)) & mask;
+}
+
+/**
+ * @brief Gets the tag of a hash (its high byte, independent of the Index bits)
+ */
+static inline uint8_t bucket_tag(uint64_t hash) {
+  return (uint8_t)(hash >> 56);
+}
+
+/**
+ * @brief Gets the number of Entries in a line
+ */
+static inline int bucket_count(const Bucket_Line_s *line) {
+  return line->count & ~BUCKET_MORE;
+}
+
+/**
+ * @brief Gets the line following a line in its chain, or NULL for the last line
+ */
+static inline Bucket_Line_s *bucket_next(const Bucket_Line_s *line) {
+  return (line->count & BUCKET_MORE) ? line->slots[BUCKET_SLOTS - 1] : NULL;
+}
+
+/**
+ * @brief Gets the size of the allocation holding an Entry and its Key
+ */
+static inline size_t bucket_entry_size(size_t len) {
+  return sizeof(Bucket_Entry_s) + len + 1;
+}
+
+/**
+ * @brief Allocates empty, cache line aligned lines
+ *
+ * @param num_lines Number of lines.
+ * @return The lines, or NULL if out of memory
+ */
+static Bucket_Line_s *bucket_alloc_lines(size_t num_lines) {
+  void *lines = NULL;
+  if(posix_memalign(&lines, BUCKET_LINE, num_lines * sizeof(Bucket_Line_s)) != 0) {
+    return NULL;
+  }
+  memset(lines, 0, num_lines * sizeof(Bucket_Line_s));
+  return lines;
+}
+
+/**
+ * @brief Frees every overflow line of a table (the head lines and Entries are kept)
+ *
+ * @param store The Bucketized table.
+ */
+static void bucket_free_overflow(Bucket_Store_s *store) {
+  size_t i = 0;
+  for(i = 0; i < store->num_lines; i++) {
+    Bucket_Line_s *line = bucket_next(&store->lines[i]);
+    while(line != NULL) {
+      Bucket_Line_s *reaper = line;
+      line = bucket_next(line);
+      free(reaper);
+    }
+    store->lines[i].count &= ~BUCKET_MORE;
+  }
+}
+
+/**
+ * @brief Allocates an empty Bucketized table with at least capacity Indices
+ *
+ * @param croquette The Croquette being created.
+ * @param capacity Minimum number of Indices.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int bucket_init(Croquette_s *croquette, int capacity) {
+  size_t num_lines = 1;
+  while(num_lines < (size_t)capacity && num_lines < (1 << 28)) {
+    num_lines <<= 1;
+  }
+
+  Bucket_Store_s *store = calloc(1, sizeof(Bucket_Store_s));
+  if(store == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  store->lines = bucket_alloc_lines(num_lines);
+  if(store->lines == NULL) {
+    free(store);
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  store->num_lines = num_lines;
+  croquette->store = store;
+  croquette->capacity = (int)num_lines;
+  return C_Success;
+}
+
+/**
+ * @brief Frees the (empty) Bucketized table
+ *
+ * @param croquette The Croquette being deleted.
+ */
+static void bucket_destroy(Croquette_s *croquette) {
+  Bucket_Store_s *store = croquette->store;
+  if(store == NULL) {
+    return;
+  }
+  bucket_free_overflow(store);
+  free(store->lines);
+  free(store);
+  croquette->store = NULL;
+}
+
+/**
+ * @brief Finds the line and slot of a Key, comparing tags before reading Entries
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param found Set to the line holding the Key if found.
+ * @param slot Set to the slot Index in that line if found.
+ * @return True if the Key Exists
+ */
+static int bucket_find_slot(Croquette_s *croquette, const char *key, size_t len, uint64_t hash,
+                            Bucket_Line_s **found, int *slot) {
+  Bucket_Store_s *store = croquette->store;
+  Bucket_Line_s *line = &store->lines[bucket_index(hash, store->num_lines - 1)];
+  uint8_t tag = bucket_tag(hash);
+  int i = 0;
+
+  for(; line != NULL; line = bucket_next(line)) {
+    int count = bucket_count(line);
+    for(i = 0; i < count; i++) {
+      if(line->tags[i] != tag) {
+        continue;
+      }
+      Bucket_Entry_s *entry = line->slots[i];
+      if(entry->hash == hash && croquette_key_equal(croquette, entry->key, entry->key_len, key, len)) {
+        *found = line;
+        *slot = i;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Finds the Value slot for a Key
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Address of the Entry's Value if Key Exists
+ * @return NULL if No Such Key
+ */
+static void **bucket_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Bucket_Line_s *line = NULL;
+  int slot = 0;
+  if(!bucket_find_slot(croquette, key, len, hash, &line, &slot)) {
+    return NULL;
+  }
+  return &((Bucket_Entry_s *)line->slots[slot])->value;
+}
+
+/**
+ * @brief Finds the Value slot of any Entry holding a matching Value
+ *
+ * @param croquette The Croquette to search.
+ * @param value Value to compare against.
+ * @return Address of the Entry's Value if Value Exists
+ * @return NULL if No Such Value
+ */
+static void **bucket_find_value(Croquette_s *croquette, const void *value) {
+  Bucket_Store_s *store = croquette->store;
+  Bucket_Line_s *line = NULL;
+  size_t b = 0;
+  int i = 0;
+  for(b = 0; b < store->num_lines; b++) {
+    for(line = &store->lines[b]; line != NULL; line = bucket_next(line)) {
+      for(i = 0; i < bucket_count(line); i++) {
+        Bucket_Entry_s *entry = line->slots[i];
+        if(croquette->value_compare(entry->value, value) == 0) {
+          return &entry->value;
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Adds an Entry to the end of its chain, starting an overflow line if the last line is full
+ *
+ * @param store The Bucketized table.
+ * @param entry The Entry to add (its Key must not be in the table).
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the table is unchanged).
+ */
+static int bucket_append(Bucket_Store_s *store, Bucket_Entry_s *entry) {
+  Bucket_Line_s *line = &store->lines[bucket_index(entry->hash, store->num_lines - 1)];
+  Bucket_Line_s *next = NULL;
+  uint8_t tag = bucket_tag(entry->hash);
+
+  while((next = bucket_next(line)) != NULL) {
+    line = next;
+  }
+  if(line->count < BUCKET_SLOTS) {
+    line->tags[line->count] = tag;
+    line->slots[line->count] = entry;
+    line->count++;
+    return C_Success;
+  }
+
+  /* The last pair moves over so its slot can link the new line */
+  next = bucket_alloc_lines(1);
+  if(next == NULL) {
+    return C_Error;
+  }
+  next->tags[0] = line->tags[BUCKET_SLOTS - 1];
+  next->slots[0] = line->slots[BUCKET_SLOTS - 1];
+  next->tags[1] = tag;
+  next->slots[1] = entry;
+  next->count = 2;
+  line->slots[BUCKET_SLOTS - 1] = next;
+  line->count = (BUCKET_SLOTS - 1) | BUCKET_MORE;
+  return C_Success;
+}
+
+/**
+ * @brief Moves every Entry into a new set of lines (Entries themselves are not copied)
+ *
+ * @param croquette The Croquette to resize.
+ * @param num_lines Power of Two number of Indices.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the table is unchanged, Error string set).
+ */
+static int bucket_resize(Croquette_s *croquette, size_t num_lines) {
+  Bucket_Store_s *store = croquette->store;
+  Bucket_Store_s fresh;
+  Bucket_Line_s *line = NULL;
+  size_t b = 0;
+  int i = 0;
+
+  fresh.num_lines = num_lines;
+  fresh.lines = bucket_alloc_lines(num_lines);
+  if(fresh.lines == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  for(b = 0; b < store->num_lines; b++) {
+    for(line = &store->lines[b]; line != NULL; line = bucket_next(line)) {
+      for(i = 0; i < bucket_count(line); i++) {
+        if(bucket_append(&fresh, line->slots[i]) == C_Error) {
+          bucket_free_overflow(&fresh);
+          free(fresh.lines);
+          croquette_set_error(C_Insufficient_Memory);
+          return C_Error;
+        }
+      }
+    }
+  }
+
+  bucket_free_overflow(store);
+  free(store->lines);
+  *store = fresh;
+  croquette->capacity = (int)num_lines;
+  return C_Success;
+}
+
+/**
+ * @brief Inserts a Key known not to be in the Croquette, doubling past BUCKET_MAX_LOAD Keys per line
+ *
+ * @param croquette The Croquette to insert into.
+ * @param key Key bytes to add to the croquette.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Add
+ * @return C_Error on Error (Error String Available)
+ */
+static int bucket_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
+  Bucket_Store_s *store = croquette->store;
+  if((size_t)croquette->size + 1 > store->num_lines * BUCKET_MAX_LOAD && store->num_lines < (1 << 28) &&
+     bucket_resize(croquette, store->num_lines << 1) == C_Error) {
+    return C_Error;
+  }
+
+  Bucket_Entry_s *entry = croquette_block_alloc(croquette, bucket_entry_size(len));
+  if(entry == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  entry->hash = hash;
+  entry->value = value;
+  entry->key_len = (uint32_t)len;
+  memcpy(entry->key, key, len);
+  entry->key[len] = '\0';
+
+  if(bucket_append(store, entry) == C_Error) {
+    croquette_block_free(croquette, entry, bucket_entry_size(len));
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  croquette->size++;
+  return C_Success;
+}
+
+/**
+ * @brief Removes a Key if present, halving under one Key per line (never below base_capacity)
+ *
+ * The last pair of the chain fills the hole, so lines stay packed; an overflow line left
+ * with a single pair folds it back into the line before it.
+ *
+ * @param croquette The Croquette to remove from.
+ * @param key Key bytes to identify which entry to remove.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+static int bucket_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Bucket_Store_s *store = croquette->store;
+  Bucket_Line_s *line = NULL;
+  Bucket_Line_s *tail = &store->lines[bucket_index(hash, store->num_lines - 1)];
+  Bucket_Line_s *before = NULL;
+  int slot = 0;
+  if(!bucket_find_slot(croquette, key, len, hash, &line, &slot)) {
+    return C_Success;
+  }
+
+  Bucket_Entry_s *entry = line->slots[slot];
+  if(croquette->do_free == C_Do_Free) {
+    croquette->free_value(entry->value);
+  }
+  croquette_block_free(croquette, entry, bucket_entry_size(entry->key_len));
+  croquette->size--;
+
+  while(bucket_next(tail) != NULL) {
+    before = tail;
+    tail = bucket_next(tail);
+  }
+  tail->count--;
+  line->tags[slot] = tail->tags[tail->count];
+  line->slots[slot] = tail->slots[tail->count];
+  if(before != NULL && tail->count == 1) {
+    before->tags[BUCKET_SLOTS - 1] = tail->tags[0];
+    before->slots[BUCKET_SLOTS - 1] = tail->slots[0];
+    before->count = BUCKET_SLOTS;
+    free(tail);
+  }
+
+  if(croquette->auto_shrink && croquette->capacity > croquette->base_capacity &&
+     (size_t)croquette->size < store->num_lines) {
+    return bucket_resize(croquette, store->num_lines >> 1);
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Clears the Bucketized table and resets it to base_capacity
+ *
+ * @param croquette The Croquette to clear.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+static int bucket_clear(Croquette_s *croquette) {
+  Bucket_Store_s *store = croquette->store;
+  Bucket_Line_s *line = NULL;
+  size_t b = 0;
+  int i = 0;
+
+  /* With a Slab, Entries go a slab at once, so lines are only visited to free Values */
+  if(croquette->slab == NULL || croquette->do_free == C_Do_Free) {
+    for(b = 0; b < store->num_lines; b++) {
+      for(line = &store->lines[b]; line != NULL; line = bucket_next(line)) {
+        for(i = 0; i < bucket_count(line); i++) {
+          Bucket_Entry_s *entry = line->slots[i];
+          if(croquette->do_free == C_Do_Free) {
+            croquette->free_value(entry->value);
+          }
+          if(croquette->slab == NULL) {
+            free(entry);
+          }
+        }
+      }
+    }
+  }
+  croquette_slab_reset(croquette->slab);
+  croquette->size = 0;
+  bucket_free_overflow(store);
+  memset(store->lines, 0, store->num_lines * sizeof(Bucket_Line_s));
+
+  /* Reset to Base Capacity */
+  if(croquette->capacity == croquette->base_capacity) {
+    return C_Success;
+  }
+  return bucket_resize(croquette, (size_t)croquette->base_capacity);
+}
+
+/**
+ * @brief Prints all Keys (and their Indices) of the Bucketized table
+ *
+ * @param croquette The Croquette to print.
+ */
+static void bucket_print_keys(Croquette_s *croquette) {
+  Bucket_Store_s *store = croquette->store;
+  Bucket_Line_s *line = NULL;
+  size_t b = 0;
+  int i = 0;
+  for(b = 0; b < store->num_lines; b++) {
+    for(line = &store->lines[b]; line != NULL; line = bucket_next(line)) {
+      for(i = 0; i < bucket_count(line); i++) {
+        printf("[%2zu] %s\n", b, ((Bucket_Entry_s *)line->slots[i])->key);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Doubles a number of lines until n Keys average at most BUCKET_MAX_LOAD per line
+ *
+ * @return The number of lines
+ */
+static size_t bucket_fit_lines(size_t num_lines, int n) {
+  while((size_t)n > num_lines * BUCKET_MAX_LOAD && num_lines < (1 << 28)) {
+    num_lines <<= 1;
+  }
+  return num_lines;
+}
+
+/**
+ * @brief Doubles the lines until n Keys average at most BUCKET_MAX_LOAD per line (one resize)
+ *
+ * @param croquette The Croquette to grow.
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int bucket_reserve(Croquette_s *croquette, int n) {
+  Bucket_Store_s *store = croquette->store;
+  size_t num_lines = bucket_fit_lines(store->num_lines, n);
+  if(num_lines == store->num_lines) {
+    return C_Success;
+  }
+  return bucket_resize(croquette, num_lines);
+}
+
+/**
+ * @brief Resizes to the smallest doubling of the base lines holding n Keys within BUCKET_MAX_LOAD
+ *
+ * @param croquette The Croquette to shrink.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int bucket_shrink_to_fit(Croquette_s *croquette) {
+  Bucket_Store_s *store = croquette->store;
+  size_t num_lines = bucket_fit_lines((size_t)croquette->base_capacity, croquette->size);
+  if(num_lines >= store->num_lines) {
+    return C_Success;
+  }
+  return bucket_resize(croquette, num_lines);
+}
+
+/**
+ * @brief Visits every Entry of the Bucketized table, line by line
+ *
+ * @param croquette The Croquette to visit.
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return The first non-zero result of visit, or 0
+ */
+static int bucket_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg) {
+  Bucket_Store_s *store = croquette->store;
+  Bucket_Line_s *line = NULL;
+  int stop = 0;
+  size_t b = 0;
+  int i = 0;
+  for(b = 0; b < store->num_lines; b++) {
+    for(line = &store->lines[b]; line != NULL; line = bucket_next(line)) {
+      for(i = 0; i < bucket_count(line); i++) {
+        Bucket_Entry_s *entry = line->slots[i];
+        if((stop = visit(entry->key, entry->key_len, entry->value, arg)) != 0) {
+          return stop;
+        }
+      }
+    }
+  }
+  return 0;
+}
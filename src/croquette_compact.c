@@ -0,0 +1,603 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_compact.c
+ * @brief Compact (Insertion Ordered) Backend for Croquette, laid out like CPython's dict
+ * - Entries (hash, Key, Value) are appended to a dense array in insertion order.
+ * - A sparse index of 8, 16 or 32 bit Entry numbers (by table size) is probed to find them.
+ * - Key bytes are packed into one arena, so there is no allocation per Entry.
+ * - Removal marks the Entry deleted and the index slot a dummy; both are reclaimed when the
+ *   Entries run out and the table is rebuilt.
+ * - Iteration, Value scans and clear are linear sweeps of the Entry array.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croquette_internal.h"
+
+// Compact Sizes
+#define COMPACT_MIN_INDEX 8             // Smallest sparse index
+#define COMPACT_MAX_INDEX (1 << 30)     // Largest sparse index
+#define COMPACT_EMPTY (-1)              // Index slot never used
+#define COMPACT_DUMMY (-2)              // Index slot of a removed Entry (probing continues)
+#define COMPACT_DELETED UINT32_MAX      // key_off of a removed Entry
+#define COMPACT_MIN_ARENA 64            // Smallest Key arena
+#define COMPACT_MIN_ENTRIES 8           // Smallest Entry array
+
+/**
+ * @struct Compact_Entry_s
+ *
+ * @brief An Entry in the dense array; its Key lives in the Key arena
+ */
+typedef struct compact_entry {
+  uint64_t hash;          ///< Cached full hash of the Key (rebuilds never rehash).
+  void *value;            ///< Value for Croquette to Store.
+  uint32_t key_off;       ///< Offset of the Key in the arena (COMPACT_DELETED if removed).
+  uint32_t key_len;       ///< Number of bytes in the Key.
+} Compact_Entry_s;
+
+/**
+ * @struct Compact_Store_s
+ *
+ * @brief State of the Compact table
+ */
+typedef struct compact_store {
+  void *index;                ///< Sparse index of Entry numbers (int8_t, int16_t or int32_t).
+  int width;                  ///< Bytes per index slot (1, 2 or 4).
+  size_t index_size;          ///< Power of Two number of index slots.
+  Compact_Entry_s *entries;   ///< Dense Entries in insertion order.
+  size_t entries_cap;         ///< Entries allocated (grows by half up to usable).
+  size_t usable;              ///< Entries that fit before a rebuild (2/3 of index_size).
+  size_t used;                ///< Entries appended, including removed ones.
+  char *keys;                 ///< Key arena (NUL terminated Keys, back to back).
+  size_t keys_used;           ///< Bytes of the arena in use, including removed Keys.
+  size_t keys_cap;            ///< Bytes allocated for the arena.
+} Compact_Store_s;
+
+// Internal Prototypes - (Private to this Source File Only)
+static int compact_init(Croquette_s *croquette, int capacity);
+static void compact_destroy(Croquette_s *croquette);
+static void **compact_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void **compact_find_value(Croquette_s *croquette, const void *value);
+static int compact_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static int compact_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int compact_clear(Croquette_s *croquette);
+static void compact_print_keys(Croquette_s *croquette);
+static int compact_reserve(Croquette_s *croquette, int n);
+static int compact_shrink_to_fit(Croquette_s *croquette);
+static int compact_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+static int compact_build(Compact_Store_s *store, size_t index_size, const Compact_Store_s *from);
+static int compact_resize(Croquette_s *croquette, size_t index_size);
+static int compact_make_room(Croquette_s *croquette, size_t len);
+static size_t compact_lookup(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, long *entry);
+static size_t compact_index_size(size_t keys, size_t floor);
+static inline long compact_get(const Compact_Store_s *store, size_t slot);
+static inline void compact_set(Compact_Store_s *store, size_t slot, long entry);
+
+// Compact Backend
+const Croquette_Backend_s croquette_compact_backend = {
+  .name = "compact",
+  .init = compact_init,
+  .destroy = compact_destroy,
+  .find = compact_find,
+  .find_value = compact_find_value,
+  .insert = compact_insert,
+  .remove = compact_remove,
+  .clear = compact_clear,
+  .print_keys = compact_print_keys,
+  .reserve = compact_reserve,
+  .shrink_to_fit = compact_shrink_to_fit,
+  .foreach = compact_foreach
+};
+
+/**
+ * @brief Reads an index slot
+ *
+ * @param store The Compact table.
+ * @param slot Index slot to read.
+ * @return Entry number, COMPACT_EMPTY or COMPACT_DUMMY
+ */
+static inline long compact_get(const Compact_Store_s *store, size_t slot) {
+  switch(store->width) {
+    case 1:
+      return ((const int8_t *)store->index)[slot];
+    case 2:
+      return ((const int16_t *)store->index)[slot];
+    default:
+      return ((const int32_t *)store->index)[slot];
+  }
+}
+
+/**
+ * @brief Writes an index slot
+ *
+ * @param store The Compact table.
+ * @param slot Index slot to write.
+ * @param entry Entry number, COMPACT_EMPTY or COMPACT_DUMMY.
+ */
+static inline void compact_set(Compact_Store_s *store, size_t slot, long entry) {
+  switch(store->width) {
+    case 1:
+      ((int8_t *)store->index)[slot] = (int8_t)entry;
+      break;
+    case 2:
+      ((int16_t *)store->index)[slot] = (int16_t)entry;
+      break;
+    default:
+      ((int32_t *)store->index)[slot] = (int32_t)entry;
+      break;
+  }
+}
+
+/**
+ * @brief Gets the index size for a number of Keys: room for them in 2/3 of it (a Power of Two)
+ *
+ * @param keys Number of Keys that must fit.
+ * @param floor Smallest index size to return.
+ * @return Power of Two index size
+ */
+static size_t compact_index_size(size_t keys, size_t floor) {
+  size_t index_size = COMPACT_MIN_INDEX;
+  while((index_size < floor || index_size * 2 / 3 < keys) && index_size < COMPACT_MAX_INDEX) {
+    index_size <<= 1;
+  }
+  return index_size;
+}
+
+/**
+ * @brief Builds an empty table, or a packed copy of another (removed Entries and Keys dropped)
+ *
+ * The index width is the smallest that holds every Entry number plus the two markers.
+ * The Entry array and Key arena start half again larger than the live Entries and Keys.
+ *
+ * @param store Set to the new table.
+ * @param index_size Power of Two number of index slots (must leave room for from's Keys).
+ * @param from Table to copy the live Entries of, in order (NULL for an empty table).
+ * @return C_Success on Success
+ * @return C_Error if out of memory (nothing is allocated).
+ */
+static int compact_build(Compact_Store_s *store, size_t index_size, const Compact_Store_s *from) {
+  size_t key_bytes = 0;
+  size_t live = 0;
+  size_t i = 0;
+
+  memset(store, 0, sizeof(Compact_Store_s));
+  store->index_size = index_size;
+  store->usable = index_size * 2 / 3;
+  store->width = (index_size <= 128) ? 1 : (index_size <= (1 << 15)) ? 2 : 4;
+  for(i = 0; from != NULL && i < from->used; i++) {
+    if(from->entries[i].key_off != COMPACT_DELETED) {
+      key_bytes += from->entries[i].key_len + 1;
+      live++;
+    }
+  }
+  store->keys_cap = key_bytes + key_bytes / 2;
+  if(store->keys_cap < COMPACT_MIN_ARENA) {
+    store->keys_cap = COMPACT_MIN_ARENA;
+  }
+  store->entries_cap = live + live / 2;
+  if(store->entries_cap < COMPACT_MIN_ENTRIES) {
+    store->entries_cap = COMPACT_MIN_ENTRIES;
+  }
+  if(store->entries_cap > store->usable) {
+    store->entries_cap = store->usable;
+  }
+
+  store->index = malloc(index_size * store->width);
+  store->entries = malloc(store->entries_cap * sizeof(Compact_Entry_s));
+  store->keys = malloc(store->keys_cap);
+  if(store->index == NULL || store->entries == NULL || store->keys == NULL) {
+    free(store->index);
+    free(store->entries);
+    free(store->keys);
+    return C_Error;
+  }
+  memset(store->index, 0xff, index_size * store->width);   // Every width reads all ones as COMPACT_EMPTY
+
+  /* Copy the live Entries in order, re-packing their Keys and re-probing their hashes */
+  for(i = 0; from != NULL && i < from->used; i++) {
+    const Compact_Entry_s *entry = &from->entries[i];
+    size_t mask = index_size - 1;
+    size_t slot = (size_t)entry->hash & mask;
+    uint64_t perturb = entry->hash;
+    if(entry->key_off == COMPACT_DELETED) {
+      continue;
+    }
+    while(compact_get(store, slot) != COMPACT_EMPTY) {
+      perturb >>= 5;
+      slot = (slot * 5 + (size_t)perturb + 1) & mask;
+    }
+    compact_set(store, slot, (long)store->used);
+    store->entries[store->used] = *entry;
+    store->entries[store->used].key_off = (uint32_t)store->keys_used;
+    memcpy(store->keys + store->keys_used, from->keys + entry->key_off, entry->key_len + 1);
+    store->keys_used += entry->key_len + 1;
+    store->used++;
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Rebuilds the table with a new index size, packing out removed Entries
+ *
+ * @param croquette The Croquette to rebuild.
+ * @param index_size Power of Two number of index slots.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the table is unchanged, Error string set).
+ */
+static int compact_resize(Croquette_s *croquette, size_t index_size) {
+  Compact_Store_s *store = croquette->store;
+  Compact_Store_s fresh;
+  if(compact_build(&fresh, index_size, store) == C_Error) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  free(store->index);
+  free(store->entries);
+  free(store->keys);
+  *store = fresh;
+  croquette->capacity = (int)index_size;
+  return C_Success;
+}
+
+/**
+ * @brief Allocates an empty Compact table with at least capacity index slots
+ *
+ * @param croquette The Croquette being created.
+ * @param capacity Minimum number of index slots.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int compact_init(Croquette_s *croquette, int capacity) {
+  Compact_Store_s *store = calloc(1, sizeof(Compact_Store_s));
+  size_t index_size = compact_index_size(0, (size_t)capacity);
+  if(store == NULL || compact_build(store, index_size, NULL) == C_Error) {
+    free(store);
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  croquette->store = store;
+  croquette->capacity = (int)index_size;
+  return C_Success;
+}
+
+/**
+ * @brief Frees the (empty) Compact table
+ *
+ * @param croquette The Croquette being deleted.
+ */
+static void compact_destroy(Croquette_s *croquette) {
+  Compact_Store_s *store = croquette->store;
+  if(store == NULL) {
+    return;
+  }
+  free(store->index);
+  free(store->entries);
+  free(store->keys);
+  free(store);
+  croquette->store = NULL;
+}
+
+/**
+ * @brief Probes the index for a Key (perturbed probing, as CPython does)
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param entry Set to the Entry number if found, otherwise to -1.
+ * @return The index slot of the Key if found, otherwise the first dummy or empty slot seen
+ */
+static size_t compact_lookup(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, long *entry) {
+  Compact_Store_s *store = croquette->store;
+  size_t mask = store->index_size - 1;
+  size_t slot = (size_t)hash & mask;
+  size_t free_slot = SIZE_MAX;
+  uint64_t perturb = hash;
+
+  for(;;) {
+    long ix = compact_get(store, slot);
+    if(ix == COMPACT_EMPTY) {
+      *entry = -1;
+      return (free_slot != SIZE_MAX) ? free_slot : slot;
+    }
+    if(ix == COMPACT_DUMMY) {
+      if(free_slot == SIZE_MAX) {
+        free_slot = slot;
+      }
+    }
+    else {
+      Compact_Entry_s *candidate = &store->entries[ix];
+      if(candidate->hash == hash &&
+         croquette_key_equal(croquette, store->keys + candidate->key_off, candidate->key_len, key, len)) {
+        *entry = ix;
+        return slot;
+      }
+    }
+    perturb >>= 5;
+    slot = (slot * 5 + (size_t)perturb + 1) & mask;
+  }
+}
+
+/**
+ * @brief Finds the Value slot for a Key
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Address of the Entry's Value if Key Exists
+ * @return NULL if No Such Key
+ */
+static void **compact_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Compact_Store_s *store = croquette->store;
+  long entry = -1;
+  compact_lookup(croquette, key, len, hash, &entry);
+  return (entry >= 0) ? &store->entries[entry].value : NULL;
+}
+
+/**
+ * @brief Finds the Value slot of the first Entry (in insertion order) holding a matching Value
+ *
+ * @param croquette The Croquette to search.
+ * @param value Value to compare against.
+ * @return Address of the Entry's Value if Value Exists
+ * @return NULL if No Such Value
+ */
+static void **compact_find_value(Croquette_s *croquette, const void *value) {
+  Compact_Store_s *store = croquette->store;
+  size_t i = 0;
+  for(i = 0; i < store->used; i++) {
+    if(store->entries[i].key_off != COMPACT_DELETED &&
+       croquette->value_compare(store->entries[i].value, value) == 0) {
+      return &store->entries[i].value;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Appends a Key known not to be in the Croquette (see compact_make_room() for growth)
+ *
+ * @param croquette The Croquette to insert into.
+ * @param key Key bytes to add to the croquette.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Add
+ * @return C_Error on Error (Error String Available)
+ */
+static int compact_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
+  Compact_Store_s *store = croquette->store;
+  long entry = -1;
+
+  if(compact_make_room(croquette, len) == C_Error) {
+    return C_Error;
+  }
+
+  size_t slot = compact_lookup(croquette, key, len, hash, &entry);
+  compact_set(store, slot, (long)store->used);
+  store->entries[store->used].hash = hash;
+  store->entries[store->used].value = value;
+  store->entries[store->used].key_off = (uint32_t)store->keys_used;
+  store->entries[store->used].key_len = (uint32_t)len;
+  memcpy(store->keys + store->keys_used, key, len);
+  store->keys[store->keys_used + len] = '\0';
+  store->keys_used += len + 1;
+  store->used++;
+  croquette->size++;
+  return C_Success;
+}
+
+/**
+ * @brief Makes room to append one Entry with a Key of len bytes
+ *
+ * Rebuilds when the index has no usable Entries left, sized for 3/2 of the live Keys plus one
+ * (so it grows, or only packs out removed Entries when many were removed).  Otherwise the
+ * Entry array and Key arena grow by half when full.
+ *
+ * @param croquette The Croquette to insert into.
+ * @param len Number of bytes in the Key to append.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the table is unchanged, Error string set).
+ */
+static int compact_make_room(Croquette_s *croquette, size_t len) {
+  Compact_Store_s *store = croquette->store;
+
+  if(store->used == store->usable) {
+    size_t index_size = compact_index_size(((size_t)croquette->size + 1) * 3 / 2,
+                                           (size_t)croquette->base_capacity);
+    if(compact_resize(croquette, index_size) == C_Error) {
+      return C_Error;
+    }
+  }
+  if(store->used == store->entries_cap) {
+    size_t entries_cap = store->entries_cap + store->entries_cap / 2;
+    if(entries_cap > store->usable) {
+      entries_cap = store->usable;
+    }
+    Compact_Entry_s *entries = realloc(store->entries, entries_cap * sizeof(Compact_Entry_s));
+    if(entries == NULL) {
+      croquette_set_error(C_Insufficient_Memory);
+      return C_Error;
+    }
+    store->entries = entries;
+    store->entries_cap = entries_cap;
+  }
+  if(store->keys_used + len + 1 > store->keys_cap) {
+    size_t keys_cap = store->keys_cap + store->keys_cap / 2 + len + 1;
+    char *keys = realloc(store->keys, keys_cap);
+    if(keys == NULL) {
+      croquette_set_error(C_Insufficient_Memory);
+      return C_Error;
+    }
+    store->keys = keys;
+    store->keys_cap = keys_cap;
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Removes a Key if present, shrinking under 1/8 full (never below base_capacity)
+ *
+ * @param croquette The Croquette to remove from.
+ * @param key Key bytes to identify which entry to remove.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+static int compact_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Compact_Store_s *store = croquette->store;
+  long entry = -1;
+  size_t slot = compact_lookup(croquette, key, len, hash, &entry);
+  if(entry < 0) {
+    return C_Success;
+  }
+
+  if(croquette->do_free == C_Do_Free) {
+    croquette->free_value(store->entries[entry].value);
+  }
+  store->entries[entry].key_off = COMPACT_DELETED;
+  store->entries[entry].value = NULL;
+  compact_set(store, slot, COMPACT_DUMMY);
+  croquette->size--;
+
+  if(croquette->auto_shrink && croquette->capacity > croquette->base_capacity &&
+     (size_t)croquette->size < store->index_size / 8) {
+    return compact_resize(croquette, compact_index_size((size_t)croquette->size * 3 / 2,
+                                                        (size_t)croquette->base_capacity));
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Clears the Compact table and resets it to base_capacity
+ *
+ * @param croquette The Croquette to clear.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+static int compact_clear(Croquette_s *croquette) {
+  Compact_Store_s *store = croquette->store;
+  size_t i = 0;
+
+  for(i = 0; croquette->do_free == C_Do_Free && i < store->used; i++) {
+    if(store->entries[i].key_off != COMPACT_DELETED) {
+      croquette->free_value(store->entries[i].value);
+    }
+  }
+  croquette->size = 0;
+  store->used = 0;
+  store->keys_used = 0;
+  memset(store->index, 0xff, store->index_size * store->width);
+
+  /* Reset to Base Capacity */
+  if(croquette->capacity == croquette->base_capacity) {
+    return C_Success;
+  }
+  return compact_resize(croquette, (size_t)croquette->base_capacity);
+}
+
+/**
+ * @brief Prints all Keys (and their Entry numbers) in insertion order
+ *
+ * @param croquette The Croquette to print.
+ */
+static void compact_print_keys(Croquette_s *croquette) {
+  Compact_Store_s *store = croquette->store;
+  size_t i = 0;
+  for(i = 0; i < store->used; i++) {
+    if(store->entries[i].key_off != COMPACT_DELETED) {
+      printf("[%2zu] %s\n", i, store->keys + store->entries[i].key_off);
+    }
+  }
+}
+
+/**
+ * @brief Rebuilds the index for n Keys (packing out removed Entries) and sizes the Entry array for them
+ *
+ * @param croquette The Croquette to grow.
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int compact_reserve(Croquette_s *croquette, int n) {
+  Compact_Store_s *store = croquette->store;
+  size_t index_size = compact_index_size((size_t)n, store->index_size);
+  size_t entries_cap = (size_t)n;
+
+  /* Removed Entries still use up the index until a rebuild packs them out */
+  if((index_size > store->index_size || store->used - (size_t)croquette->size + (size_t)n > store->usable) &&
+     compact_resize(croquette, index_size) == C_Error) {
+    return C_Error;
+  }
+  if(entries_cap > store->usable) {
+    entries_cap = store->usable;
+  }
+  if(entries_cap > store->entries_cap) {
+    Compact_Entry_s *entries = realloc(store->entries, entries_cap * sizeof(Compact_Entry_s));
+    if(entries == NULL) {
+      croquette_set_error(C_Insufficient_Memory);
+      return C_Error;
+    }
+    store->entries = entries;
+    store->entries_cap = entries_cap;
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Rebuilds at the smallest index (from base_capacity) for the live Keys, packing out removed Entries
+ *
+ * @param croquette The Croquette to shrink.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int compact_shrink_to_fit(Croquette_s *croquette) {
+  Compact_Store_s *store = croquette->store;
+  size_t index_size = compact_index_size((size_t)croquette->size, (size_t)croquette->base_capacity);
+  if(index_size > store->index_size || (index_size == store->index_size && store->used == (size_t)croquette->size)) {
+    return C_Success;
+  }
+  return compact_resize(croquette, index_size);
+}
+
+/**
+ * @brief Visits every Entry of the Compact table in insertion order
+ *
+ * @param croquette The Croquette to visit.
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return The first non-zero result of visit, or 0
+ */
+static int compact_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg) {
+  Compact_Store_s *store = croquette->store;
+  int stop = 0;
+  size_t i = 0;
+  for(i = 0; i < store->used; i++) {
+    Compact_Entry_s *entry = &store->entries[i];
+    if(entry->key_off != COMPACT_DELETED &&
+       (stop = visit(store->keys + entry->key_off, entry->key_len, entry->value, arg)) != 0) {
+      return stop;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,756 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_cuckoo.c
+ * @brief Bucketized Cuckoo Hashing Backend for Croquette
+ * - Every Key lives in one of two 4-way buckets, both picked by its hash.
+ * - A bucket is one 64 byte cache line (4 hashes, 4 Entry pointers), so a lookup reads at
+ *   most two bucket lines before comparing Keys (bounded worst case).
+ * - Inserts into full buckets search breadth first for the shortest chain of Entries that
+ *   can each move to their other bucket; if none is found the table doubles.
+ * - A table under half full does not double (Keys that fail there share their buckets at any
+ *   size, e.g. equal hashes); the Entry goes to a small stash, scanned after both buckets.
+ * - Growth stops at CUCKOO_MAX_BUCKETS; later failures also go to the stash.
+ * - Each failed search is counted (see croquette_h_stats()).
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croquette_internal.h"
+
+// Cuckoo Sizes
+#define CUCKOO_WAYS 4           // Slots per bucket
+#define CUCKOO_BFS_NODES 128    // Buckets examined per displacement search
+#define CUCKOO_LINE 64          // Bucket alignment (one cache line)
+#define CUCKOO_MAX_BUCKETS ((size_t)1 << 28)  // Largest table (capacity stays within an int)
+#define CUCKOO_STASH_INIT 4     // First stash allocation
+#define CUCKOO_MIX 0x9e3779b97f4a7c15ull     // Golden ratio multiplier for the other bucket
+
+/**
+ * @struct Cuckoo_Entry_s
+ *
+ * @brief An Entry: the Value and its Key in one allocation
+ */
+typedef struct cuckoo_entry {
+  void *value;            ///< Value for Croquette to Store.
+  size_t key_len;         ///< Number of bytes in the Key.
+  char key[];             ///< Key for Croquette (NUL terminated copy).
+} Cuckoo_Entry_s;
+
+/**
+ * @struct Cuckoo_Bucket_s
+ *
+ * @brief A 4-way bucket (64 bytes); hashes are kept here so Entries move without being read
+ */
+typedef struct cuckoo_bucket {
+  uint64_t hashes[CUCKOO_WAYS];               ///< Full hash of each occupied slot.
+  Cuckoo_Entry_s *entries[CUCKOO_WAYS];       ///< Entry of each slot (NULL if empty).
+} Cuckoo_Bucket_s;
+
+/**
+ * @struct Cuckoo_Stashed_s
+ *
+ * @brief An Entry that could not be placed in either of its buckets
+ */
+typedef struct cuckoo_stashed {
+  uint64_t hash;              ///< Full hash of the Entry's Key.
+  Cuckoo_Entry_s *entry;      ///< The Entry.
+} Cuckoo_Stashed_s;
+
+/**
+ * @struct Cuckoo_Store_s
+ *
+ * @brief State of the Cuckoo table
+ */
+typedef struct cuckoo_store {
+  Cuckoo_Bucket_s *buckets;   ///< Bucket array (cache line aligned).
+  size_t num_buckets;         ///< Power of Two number of buckets.
+  Cuckoo_Stashed_s *stash;    ///< Entries that fit neither bucket (NULL until first needed).
+  size_t stash_size;          ///< Number of stashed Entries.
+  size_t stash_capacity;      ///< Allocated length of stash.
+} Cuckoo_Store_s;
+
+/**
+ * @struct Cuckoo_Path_s
+ *
+ * @brief A bucket reached by the displacement search
+ */
+typedef struct cuckoo_path {
+  size_t bucket;              ///< The bucket reached.
+  int parent;                 ///< Search node whose Entry would move here (-1 for the two home buckets).
+  int slot;                   ///< Slot of that Entry in the parent's bucket.
+} Cuckoo_Path_s;
+
+// Internal Prototypes - (Private to this Source File Only)
+static int cuckoo_init(Croquette_s *croquette, int capacity);
+static void cuckoo_destroy(Croquette_s *croquette);
+static void **cuckoo_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void **cuckoo_find_value(Croquette_s *croquette, const void *value);
+static int cuckoo_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static int cuckoo_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int cuckoo_clear(Croquette_s *croquette);
+static void cuckoo_print_keys(Croquette_s *croquette);
+static int cuckoo_reserve(Croquette_s *croquette, int n);
+static int cuckoo_shrink_to_fit(Croquette_s *croquette);
+static int cuckoo_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+static Cuckoo_Bucket_s *cuckoo_alloc_buckets(size_t num_buckets);
+static int cuckoo_place(Cuckoo_Store_s *store, uint64_t hash, Cuckoo_Entry_s *entry);
+static int cuckoo_stash_push(Cuckoo_Store_s *store, uint64_t hash, Cuckoo_Entry_s *entry);
+static int cuckoo_rehome(Cuckoo_Store_s *store, uint64_t hash, Cuckoo_Entry_s *entry);
+static int cuckoo_displace(Cuckoo_Store_s *store, uint64_t hash);
+static int cuckoo_resize(Croquette_s *croquette, size_t num_buckets);
+static int cuckoo_find_slot(Croquette_s *croquette, const char *key, size_t len, uint64_t hash,
+                            size_t *bucket, int *slot);
+static inline size_t cuckoo_bucket1(uint64_t hash, size_t mask);
+static inline size_t cuckoo_other(uint64_t hash, size_t bucket, size_t mask);
+static inline int cuckoo_free_slot(const Cuckoo_Bucket_s *bucket);
+
+// Cuckoo Backend
+const Croquette_Backend_s croquette_cuckoo_backend = {
+  .name = "cuckoo",
+  .init = cuckoo_init,
+  .destroy = cuckoo_destroy,
+  .find = cuckoo_find,
+  .find_value = cuckoo_find_value,
+  .insert = cuckoo_insert,
+  .remove = cuckoo_remove,
+  .clear = cuckoo_clear,
+  .print_keys = cuckoo_print_keys,
+  .reserve = cuckoo_reserve,
+  .shrink_to_fit = cuckoo_shrink_to_fit,
+  .foreach = cuckoo_foreach
+};
+
+/**
+ * @brief Gets the first bucket of a hash (its low bits)
+ *
+ * @param hash The hash of the key.
+ * @param mask Number of buckets - 1.
+ * @return Bucket Index
+ */
+static inline size_t cuckoo_bucket1(uint64_t hash, size_t mask) {
+  return (size_t)hash & mask;
+}
+
+/**
+ * @brief Gets the other bucket of a hash, given either one of its two buckets
+ *
+ * The second bucket is the first XOR an odd value from the high bits of the remixed hash, so
+ * it always differs from the first and each maps back to the other.  The remix spreads a
+ * user hash_fn with few high bits (e.g. 32 bit) over every bucket instead of just bucket ^ 1.
+ *
+ * @param hash The hash of the key.
+ * @param bucket One of the Key's buckets.
+ * @param mask Number of buckets - 1.
+ * @return The Key's other bucket Index
+ */
+static inline size_t cuckoo_other(uint64_t hash, size_t bucket, size_t mask) {
+  return (bucket ^ (size_t)(((hash * CUCKOO_MIX) >> 32) | 1)) & mask;
+}
+
+/**
+ * @brief Finds an empty slot in a bucket
+ *
+ * @param bucket The bucket to check.
+ * @return Slot Index, or -1 if the bucket is full
+ */
+static inline int cuckoo_free_slot(const Cuckoo_Bucket_s *bucket) {
+  int i = 0;
+  for(i = 0; i < CUCKOO_WAYS; i++) {
+    if(bucket->entries[i] == NULL) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Allocates an empty, cache line aligned bucket array
+ *
+ * @param num_buckets Number of buckets.
+ * @return The buckets, or NULL if out of memory
+ */
+static Cuckoo_Bucket_s *cuckoo_alloc_buckets(size_t num_buckets) {
+  void *buckets = NULL;
+  if(posix_memalign(&buckets, CUCKOO_LINE, num_buckets * sizeof(Cuckoo_Bucket_s)) != 0) {
+    return NULL;
+  }
+  memset(buckets, 0, num_buckets * sizeof(Cuckoo_Bucket_s));
+  return buckets;
+}
+
+/**
+ * @brief Allocates an empty Cuckoo table with at least capacity slots (at least two buckets)
+ *
+ * @param croquette The Croquette being created.
+ * @param capacity Minimum number of slots.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int cuckoo_init(Croquette_s *croquette, int capacity) {
+  size_t num_buckets = 2;
+  while(num_buckets * CUCKOO_WAYS < (size_t)capacity && num_buckets < CUCKOO_MAX_BUCKETS) {
+    num_buckets <<= 1;
+  }
+
+  Cuckoo_Store_s *store = calloc(1, sizeof(Cuckoo_Store_s));
+  if(store == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  store->buckets = cuckoo_alloc_buckets(num_buckets);
+  if(store->buckets == NULL) {
+    free(store);
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  store->num_buckets = num_buckets;
+  croquette->store = store;
+  croquette->capacity = (int)(num_buckets * CUCKOO_WAYS);
+  return C_Success;
+}
+
+/**
+ * @brief Frees the (empty) Cuckoo table
+ *
+ * @param croquette The Croquette being deleted.
+ */
+static void cuckoo_destroy(Croquette_s *croquette) {
+  Cuckoo_Store_s *store = croquette->store;
+  if(store == NULL) {
+    return;
+  }
+  free(store->buckets);
+  free(store->stash);
+  free(store);
+  croquette->store = NULL;
+}
+
+/**
+ * @brief Finds the bucket and slot of a Key (its two buckets, then the stash if not empty)
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param bucket Set to the bucket Index if found (num_buckets if stashed).
+ * @param slot Set to the slot Index if found (stash Index if stashed).
+ * @return True if the Key Exists
+ */
+static int cuckoo_find_slot(Croquette_s *croquette, const char *key, size_t len, uint64_t hash,
+                            size_t *bucket, int *slot) {
+  Cuckoo_Store_s *store = croquette->store;
+  size_t mask = store->num_buckets - 1;
+  size_t candidates[2];
+  int b = 0;
+  int i = 0;
+
+  candidates[0] = cuckoo_bucket1(hash, mask);
+  candidates[1] = cuckoo_other(hash, candidates[0], mask);
+  for(b = 0; b < 2; b++) {
+    Cuckoo_Bucket_s *walker = &store->buckets[candidates[b]];
+    for(i = 0; i < CUCKOO_WAYS; i++) {
+      if(walker->hashes[i] == hash && walker->entries[i] != NULL &&
+         croquette_key_equal(croquette, walker->entries[i]->key, walker->entries[i]->key_len, key, len)) {
+        *bucket = candidates[b];
+        *slot = i;
+        return 1;
+      }
+    }
+  }
+  for(i = 0; i < (int)store->stash_size; i++) {
+    Cuckoo_Entry_s *entry = store->stash[i].entry;
+    if(store->stash[i].hash == hash &&
+       croquette_key_equal(croquette, entry->key, entry->key_len, key, len)) {
+      *bucket = store->num_buckets;
+      *slot = i;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Finds the Value slot for a Key
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Address of the Entry's Value if Key Exists
+ * @return NULL if No Such Key
+ */
+static void **cuckoo_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Cuckoo_Store_s *store = croquette->store;
+  size_t bucket = 0;
+  int slot = 0;
+  if(!cuckoo_find_slot(croquette, key, len, hash, &bucket, &slot)) {
+    return NULL;
+  }
+  if(bucket == store->num_buckets) {
+    return &store->stash[slot].entry->value;
+  }
+  return &store->buckets[bucket].entries[slot]->value;
+}
+
+/**
+ * @brief Finds the Value slot of any Entry holding a matching Value
+ *
+ * @param croquette The Croquette to search.
+ * @param value Value to compare against.
+ * @return Address of the Entry's Value if Value Exists
+ * @return NULL if No Such Value
+ */
+static void **cuckoo_find_value(Croquette_s *croquette, const void *value) {
+  Cuckoo_Store_s *store = croquette->store;
+  size_t b = 0;
+  int i = 0;
+  for(b = 0; b < store->num_buckets; b++) {
+    for(i = 0; i < CUCKOO_WAYS; i++) {
+      Cuckoo_Entry_s *entry = store->buckets[b].entries[i];
+      if(entry != NULL && croquette->value_compare(entry->value, value) == 0) {
+        return &entry->value;
+      }
+    }
+  }
+  for(b = 0; b < store->stash_size; b++) {
+    if(croquette->value_compare(store->stash[b].entry->value, value) == 0) {
+      return &store->stash[b].entry->value;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Frees a slot in one of a hash's two buckets by moving Entries to their other buckets
+ *
+ * A breadth first search from both buckets finds the shortest chain of moves ending in
+ * an empty slot.  Moves run from the empty end back, so every step leaves each Entry in one
+ * of its own buckets; a step that no longer applies ends the attempt.
+ *
+ * @param store The Cuckoo table.
+ * @param hash The hash of the Key that needs a slot.
+ * @return Slot freed in one of the two buckets (bucket Index * CUCKOO_WAYS + slot)
+ * @return -1 if no chain was found within CUCKOO_BFS_NODES buckets
+ */
+static int cuckoo_displace(Cuckoo_Store_s *store, uint64_t hash) {
+  Cuckoo_Path_s queue[CUCKOO_BFS_NODES];
+  size_t mask = store->num_buckets - 1;
+  int head = 0;
+  int tail = 0;
+  int i = 0;
+
+  queue[tail++] = (Cuckoo_Path_s){cuckoo_bucket1(hash, mask), -1, -1};
+  queue[tail++] = (Cuckoo_Path_s){cuckoo_other(hash, queue[0].bucket, mask), -1, -1};
+
+  while(head < tail) {
+    Cuckoo_Path_s node = queue[head];
+    Cuckoo_Bucket_s *bucket = &store->buckets[node.bucket];
+    for(i = 0; i < CUCKOO_WAYS; i++) {
+      size_t alt = cuckoo_other(bucket->hashes[i], node.bucket, mask);
+      int free_slot = cuckoo_free_slot(&store->buckets[alt]);
+      if(free_slot >= 0) {
+        /* Walk the chain back to a home bucket, moving each Entry into the slot just freed */
+        size_t to_bucket = alt;
+        int to_slot = free_slot;
+        size_t from_bucket = node.bucket;
+        int from_slot = i;
+        int at = head;
+        for(;;) {
+          Cuckoo_Bucket_s *from = &store->buckets[from_bucket];
+          Cuckoo_Bucket_s *to = &store->buckets[to_bucket];
+          if(from->entries[from_slot] == NULL || to->entries[to_slot] != NULL ||
+             cuckoo_other(from->hashes[from_slot], from_bucket, mask) != to_bucket) {
+            return -1;
+          }
+          to->hashes[to_slot] = from->hashes[from_slot];
+          to->entries[to_slot] = from->entries[from_slot];
+          from->entries[from_slot] = NULL;
+          if(queue[at].parent < 0) {
+            return (int)(from_bucket * CUCKOO_WAYS) + from_slot;
+          }
+          to_bucket = from_bucket;
+          to_slot = from_slot;
+          from_slot = queue[at].slot;
+          at = queue[at].parent;
+          from_bucket = queue[at].bucket;
+        }
+      }
+      if(tail < CUCKOO_BFS_NODES) {
+        queue[tail++] = (Cuckoo_Path_s){alt, head, i};
+      }
+    }
+    head++;
+  }
+  return -1;
+}
+
+/**
+ * @brief Places an Entry in one of its two buckets, displacing others if both are full
+ *
+ * @param store The Cuckoo table.
+ * @param hash The hash of the Entry's Key.
+ * @param entry The Entry to place.
+ * @return C_Success if placed
+ * @return C_Error if no slot could be freed (the table is unchanged apart from valid moves)
+ */
+static int cuckoo_place(Cuckoo_Store_s *store, uint64_t hash, Cuckoo_Entry_s *entry) {
+  size_t mask = store->num_buckets - 1;
+  size_t bucket = cuckoo_bucket1(hash, mask);
+  int slot = cuckoo_free_slot(&store->buckets[bucket]);
+
+  if(slot < 0) {
+    bucket = cuckoo_other(hash, bucket, mask);
+    slot = cuckoo_free_slot(&store->buckets[bucket]);
+  }
+  if(slot < 0) {
+    int freed = cuckoo_displace(store, hash);
+    if(freed < 0) {
+      return C_Error;
+    }
+    bucket = (size_t)freed / CUCKOO_WAYS;
+    slot = freed % CUCKOO_WAYS;
+  }
+  store->buckets[bucket].hashes[slot] = hash;
+  store->buckets[bucket].entries[slot] = entry;
+  return C_Success;
+}
+
+/**
+ * @brief Adds an Entry to the stash, doubling its allocation when full
+ *
+ * @param store The Cuckoo table.
+ * @param hash The hash of the Entry's Key.
+ * @param entry The Entry to stash.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the stash is unchanged, Error string set).
+ */
+static int cuckoo_stash_push(Cuckoo_Store_s *store, uint64_t hash, Cuckoo_Entry_s *entry) {
+  if(store->stash_size == store->stash_capacity) {
+    size_t stash_capacity = (store->stash_capacity == 0)?CUCKOO_STASH_INIT:store->stash_capacity << 1;
+    Cuckoo_Stashed_s *stash = realloc(store->stash, stash_capacity * sizeof(Cuckoo_Stashed_s));
+    if(stash == NULL) {
+      croquette_set_error(C_Insufficient_Memory);
+      return C_Error;
+    }
+    store->stash = stash;
+    store->stash_capacity = stash_capacity;
+  }
+  store->stash[store->stash_size++] = (Cuckoo_Stashed_s){hash, entry};
+  return C_Success;
+}
+
+/**
+ * @brief Places an Entry in one of its two buckets, or stashes it if neither has room
+ *
+ * @param store The Cuckoo table.
+ * @param hash The hash of the Entry's Key.
+ * @param entry The Entry to place.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int cuckoo_rehome(Cuckoo_Store_s *store, uint64_t hash, Cuckoo_Entry_s *entry) {
+  if(cuckoo_place(store, hash, entry) == C_Success) {
+    return C_Success;
+  }
+  return cuckoo_stash_push(store, hash, entry);
+}
+
+/**
+ * @brief Moves every Entry (stashed ones included) into a new bucket array
+ *
+ * Entries that fit neither bucket of the new array go to its stash.
+ *
+ * @param croquette The Croquette to resize.
+ * @param num_buckets Power of Two number of buckets.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the table is unchanged, Error string set).
+ */
+static int cuckoo_resize(Croquette_s *croquette, size_t num_buckets) {
+  Cuckoo_Store_s *store = croquette->store;
+  Cuckoo_Store_s fresh = {0};
+  int status = C_Success;
+  size_t b = 0;
+  int i = 0;
+
+  fresh.num_buckets = num_buckets;
+  fresh.buckets = cuckoo_alloc_buckets(num_buckets);
+  if(fresh.buckets == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  for(b = 0; b < store->num_buckets && status == C_Success; b++) {
+    for(i = 0; i < CUCKOO_WAYS && status == C_Success; i++) {
+      if(store->buckets[b].entries[i] != NULL) {
+        status = cuckoo_rehome(&fresh, store->buckets[b].hashes[i], store->buckets[b].entries[i]);
+      }
+    }
+  }
+  for(b = 0; b < store->stash_size && status == C_Success; b++) {
+    status = cuckoo_rehome(&fresh, store->stash[b].hash, store->stash[b].entry);
+  }
+  if(status == C_Error) {
+    /* The old table still holds every Entry */
+    free(fresh.buckets);
+    free(fresh.stash);
+    return C_Error;
+  }
+
+  free(store->buckets);
+  free(store->stash);
+  *store = fresh;
+  croquette->capacity = (int)(num_buckets * CUCKOO_WAYS);
+  return C_Success;
+}
+
+/**
+ * @brief Inserts a Key known not to be in the Croquette, doubling if no slot can be freed
+ *
+ * Only a table whose buckets are at least half full (and under CUCKOO_MAX_BUCKETS) doubles;
+ * otherwise, or if doubling did not help, the Entry is stashed.
+ *
+ * @param croquette The Croquette to insert into.
+ * @param key Key bytes to add to the croquette.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Add
+ * @return C_Error on Error (Error String Available)
+ */
+static int cuckoo_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
+  Cuckoo_Store_s *store = croquette->store;
+  int status = C_Success;
+  Cuckoo_Entry_s *entry = croquette_block_alloc(croquette, sizeof(Cuckoo_Entry_s) + len + 1);
+  if(entry == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  entry->value = value;
+  entry->key_len = len;
+  memcpy(entry->key, key, len);
+  entry->key[len] = '\0';
+
+  while(cuckoo_place(store, hash, entry) == C_Error) {
+    croquette->insert_failures++;
+    /* Under half full, the Keys in the way share these buckets at any size (e.g. equal hashes) */
+    if(store->num_buckets >= CUCKOO_MAX_BUCKETS ||
+       ((size_t)croquette->size - store->stash_size) * 2 < store->num_buckets * CUCKOO_WAYS) {
+      status = cuckoo_stash_push(store, hash, entry);
+      break;
+    }
+    status = cuckoo_resize(croquette, store->num_buckets << 1);
+    if(status == C_Error) {
+      break;
+    }
+  }
+  if(status == C_Error) {
+    croquette_block_free(croquette, entry, sizeof(Cuckoo_Entry_s) + len + 1);
+    return C_Error;
+  }
+  croquette->size++;
+  return C_Success;
+}
+
+/**
+ * @brief Removes a Key if present, halving when under a quarter full (never below base_capacity)
+ *
+ * @param croquette The Croquette to remove from.
+ * @param key Key bytes to identify which entry to remove.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+static int cuckoo_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Cuckoo_Store_s *store = croquette->store;
+  size_t bucket = 0;
+  int slot = 0;
+  if(!cuckoo_find_slot(croquette, key, len, hash, &bucket, &slot)) {
+    return C_Success;
+  }
+
+  Cuckoo_Entry_s *entry = NULL;
+  if(bucket == store->num_buckets) {
+    entry = store->stash[slot].entry;
+    store->stash[slot] = store->stash[--store->stash_size];
+  }
+  else {
+    entry = store->buckets[bucket].entries[slot];
+    store->buckets[bucket].entries[slot] = NULL;
+  }
+  if(croquette->do_free == C_Do_Free) {
+    croquette->free_value(entry->value);
+  }
+  croquette_block_free(croquette, entry, sizeof(Cuckoo_Entry_s) + entry->key_len + 1);
+  croquette->size--;
+
+  if(croquette->auto_shrink && croquette->capacity > croquette->base_capacity &&
+     croquette->size < (croquette->capacity >> 2)) {
+    return cuckoo_resize(croquette, store->num_buckets >> 1);
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Clears the Cuckoo table and resets it to base_capacity
+ *
+ * @param croquette The Croquette to clear.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+static int cuckoo_clear(Croquette_s *croquette) {
+  Cuckoo_Store_s *store = croquette->store;
+  size_t b = 0;
+  int i = 0;
+
+  /* With a Slab, Entries go a slab at once, so buckets are only visited to free Values */
+  if(croquette->slab == NULL || croquette->do_free == C_Do_Free) {
+    for(b = 0; b < store->num_buckets; b++) {
+      for(i = 0; i < CUCKOO_WAYS; i++) {
+        Cuckoo_Entry_s *entry = store->buckets[b].entries[i];
+        if(entry == NULL) {
+          continue;
+        }
+        if(croquette->do_free == C_Do_Free) {
+          croquette->free_value(entry->value);
+        }
+        if(croquette->slab == NULL) {
+          free(entry);
+        }
+      }
+    }
+    for(b = 0; b < store->stash_size; b++) {
+      if(croquette->do_free == C_Do_Free) {
+        croquette->free_value(store->stash[b].entry->value);
+      }
+      if(croquette->slab == NULL) {
+        free(store->stash[b].entry);
+      }
+    }
+  }
+  croquette_slab_reset(croquette->slab);
+  croquette->size = 0;
+  store->stash_size = 0;
+  memset(store->buckets, 0, store->num_buckets * sizeof(Cuckoo_Bucket_s));
+
+  /* Reset to Base Capacity */
+  if(croquette->capacity == croquette->base_capacity) {
+    return C_Success;
+  }
+  return cuckoo_resize(croquette, (size_t)croquette->base_capacity / CUCKOO_WAYS);
+}
+
+/**
+ * @brief Prints all Keys (and their bucket Indices) of the Cuckoo table
+ *
+ * @param croquette The Croquette to print.
+ */
+static void cuckoo_print_keys(Croquette_s *croquette) {
+  Cuckoo_Store_s *store = croquette->store;
+  size_t b = 0;
+  int i = 0;
+  for(b = 0; b < store->num_buckets; b++) {
+    for(i = 0; i < CUCKOO_WAYS; i++) {
+      if(store->buckets[b].entries[i] != NULL) {
+        printf("[%2zu] %s\n", b, store->buckets[b].entries[i]->key);
+      }
+    }
+  }
+  for(b = 0; b < store->stash_size; b++) {
+    printf("[stash] %s\n", store->stash[b].entry->key);
+  }
+}
+
+/**
+ * @brief Doubles a number of buckets until n Keys fill at most 9/10 of their slots
+ *
+ * @return The number of buckets
+ */
+static size_t cuckoo_fit_buckets(size_t num_buckets, int n) {
+  while((size_t)n * 10 > num_buckets * CUCKOO_WAYS * 9 && num_buckets < CUCKOO_MAX_BUCKETS) {
+    num_buckets <<= 1;
+  }
+  return num_buckets;
+}
+
+/**
+ * @brief Doubles the buckets until n Keys fill at most 9/10 of the slots (one resize)
+ *
+ * Cuckoo inserts only grow when a Key cannot be placed, which 4-way buckets rarely hit below that load.
+ *
+ * @param croquette The Croquette to grow.
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int cuckoo_reserve(Croquette_s *croquette, int n) {
+  Cuckoo_Store_s *store = croquette->store;
+  size_t num_buckets = cuckoo_fit_buckets(store->num_buckets, n);
+  if(num_buckets == store->num_buckets) {
+    return C_Success;
+  }
+  return cuckoo_resize(croquette, num_buckets);
+}
+
+/**
+ * @brief Resizes to the smallest doubling of the base buckets that n Keys fill to at most 9/10
+ *
+ * @param croquette The Croquette to shrink.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int cuckoo_shrink_to_fit(Croquette_s *croquette) {
+  Cuckoo_Store_s *store = croquette->store;
+  size_t num_buckets = cuckoo_fit_buckets((size_t)croquette->base_capacity / CUCKOO_WAYS, croquette->size);
+  if(num_buckets >= store->num_buckets) {
+    return C_Success;
+  }
+  return cuckoo_resize(croquette, num_buckets);
+}
+
+/**
+ * @brief Visits every Entry of the Cuckoo table in bucket order
+ *
+ * @param croquette The Croquette to visit.
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return The first non-zero result of visit, or 0
+ */
+static int cuckoo_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg) {
+  Cuckoo_Store_s *store = croquette->store;
+  int stop = 0;
+  size_t b = 0;
+  int i = 0;
+  for(b = 0; b < store->num_buckets; b++) {
+    for(i = 0; i < CUCKOO_WAYS; i++) {
+      Cuckoo_Entry_s *entry = store->buckets[b].entries[i];
+      if(entry != NULL && (stop = visit(entry->key, entry->key_len, entry->value, arg)) != 0) {
+        return stop;
+      }
+    }
+  }
+  for(b = 0; b < store->stash_size; b++) {
+    Cuckoo_Entry_s *entry = store->stash[b].entry;
+    if((stop = visit(entry->key, entry->key_len, entry->value, arg)) != 0) {
+      return stop;
+    }
+  }
+  return 0;
+}
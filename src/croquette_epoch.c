@@ -0,0 +1,205 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_epoch.c
+ * @brief Epoch Based Reclamation (Fraser) for lock-free Croquette readers
+ * - One global epoch counter is shared by every Croquette.
+ * - Each reading thread owns a record announcing the epoch it entered in (or that it is idle);
+ *   records are claimed on first use and handed back when the thread exits.
+ * - The epoch advances only when every active reader has announced the current one, so a
+ *   block retired in epoch e cannot be reached by anyone once the epoch reaches e + 2.
+ * - Entering and exiting touch only the reader's own record: no shared line is written.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "croquette_epoch.h"
+
+/**
+ * @struct Epoch_Thread_s
+ *
+ * @brief A reading thread's announcement, linked into the list scanned by croquette_epoch_advance().
+ */
+typedef struct epoch_thread {
+  uint64_t state;                 ///< (epoch << 1) | 1 while reading, epoch << 1 while idle.
+  int depth;                      ///< Nesting of croquette_epoch_enter() (owner only).
+  int in_use;                     ///< Boolean: owned by a live thread.
+  struct epoch_thread *next;      ///< Next record (records are never freed).
+} Epoch_Thread_s;
+
+// Private Globals (Private to this Source File Only)
+static uint64_t epoch_global = 1;                 // Current epoch
+static Epoch_Thread_s *epoch_threads = NULL;      // Every record ever claimed
+static pthread_key_t epoch_key;                   // Hands a record back on thread exit
+static pthread_once_t epoch_once = PTHREAD_ONCE_INIT;
+static __thread Epoch_Thread_s *epoch_self = NULL; // This thread's record
+
+/**
+ * @brief Hands a record back for reuse when its thread exits
+ *
+ * @param arg The thread's record.
+ */
+static void epoch_release(void *arg) {
+  Epoch_Thread_s *record = arg;
+  record->depth = 0;
+  __atomic_store_n(&record->state, 0, __ATOMIC_RELEASE);
+  __atomic_store_n(&record->in_use, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Creates the key whose destructor hands records back (once per process)
+ */
+static void epoch_key_create() {
+  pthread_key_create(&epoch_key, epoch_release);
+}
+
+/**
+ * @brief Claims a record for the calling thread, reusing one of an exited thread if possible
+ *
+ * @return The record on Success
+ * @return NULL if out of memory
+ */
+static Epoch_Thread_s *epoch_claim() {
+  Epoch_Thread_s *record = NULL;
+  int idle = 0;
+
+  pthread_once(&epoch_once, epoch_key_create);
+  for(record = __atomic_load_n(&epoch_threads, __ATOMIC_ACQUIRE); record != NULL; record = record->next) {
+    idle = 0;
+    if(__atomic_load_n(&record->in_use, __ATOMIC_RELAXED) == 0 &&
+       __atomic_compare_exchange_n(&record->in_use, &idle, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      break;
+    }
+  }
+  if(record == NULL) {
+    record = calloc(1, sizeof(Epoch_Thread_s));
+    if(record == NULL) {
+      return NULL;
+    }
+    record->in_use = 1;
+    record->next = __atomic_load_n(&epoch_threads, __ATOMIC_RELAXED);
+    while(!__atomic_compare_exchange_n(&epoch_threads, &record->next, record, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+  }
+  pthread_setspecific(epoch_key, record);
+  return record;
+}
+
+/**
+ * @brief Marks the calling thread as reading (nests)
+ *
+ * The announcement is ordered before every load of the read by a full fence, so a writer
+ * that sees the thread idle knows the read has not yet loaded anything.
+ *
+ * @return 1 on Success
+ * @return 0 if the thread could not be registered (out of memory); read under a lock instead
+ */
+int croquette_epoch_enter() {
+  if(epoch_self == NULL && (epoch_self = epoch_claim()) == NULL) {
+    return 0;
+  }
+  if(epoch_self->depth++ > 0) {
+    return 1;
+  }
+  uint64_t epoch = __atomic_load_n(&epoch_global, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&epoch_self->state, (epoch << 1) | 1, __ATOMIC_SEQ_CST);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  return 1;
+}
+
+/**
+ * @brief Ends the read started by the matching croquette_epoch_enter()
+ */
+void croquette_epoch_exit() {
+  if(--epoch_self->depth > 0) {
+    return;
+  }
+  uint64_t state = __atomic_load_n(&epoch_self->state, __ATOMIC_RELAXED);
+  __atomic_store_n(&epoch_self->state, state & ~(uint64_t)1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Adds a block to a retire list, tagged with the current epoch
+ *
+ * @param list The retire list.
+ * @param block The block, already unreachable for new readers.
+ * @param kind Passed back with the block when it is reclaimed.
+ * @return 1 on Success
+ * @return 0 if out of memory (nothing was retired)
+ */
+int croquette_epoch_retire(Croquette_Retire_List_s *list, void *block, int kind) {
+  if(list->count == list->capacity) {
+    int capacity = (list->capacity > 0) ? list->capacity * 2 : EPOCH_COLLECT_MIN;
+    Croquette_Retired_s *items = realloc(list->items, capacity * sizeof(Croquette_Retired_s));
+    if(items == NULL) {
+      return 0;
+    }
+    list->items = items;
+    list->capacity = capacity;
+  }
+  list->items[list->count].block = block;
+  list->items[list->count].kind = kind;
+  list->items[list->count].epoch = croquette_epoch_current();
+  list->count++;
+  return 1;
+}
+
+/**
+ * @brief Reads the global epoch, to tag a block retired outside a Croquette_Retire_List_s
+ *
+ * @return The current epoch
+ */
+uint64_t croquette_epoch_current() {
+  return __atomic_load_n(&epoch_global, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Moves the global epoch forward if every active reader has seen it
+ *
+ * @return The global epoch; blocks retired in epoch e are safe to free once e + 2 <= it
+ */
+uint64_t croquette_epoch_advance() {
+  Epoch_Thread_s *record = NULL;
+  uint64_t state = 0;
+
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  uint64_t epoch = __atomic_load_n(&epoch_global, __ATOMIC_SEQ_CST);
+  for(record = __atomic_load_n(&epoch_threads, __ATOMIC_ACQUIRE); record != NULL; record = record->next) {
+    state = __atomic_load_n(&record->state, __ATOMIC_SEQ_CST);
+    if((state & 1) && (state >> 1) != epoch) {
+      return epoch;
+    }
+  }
+  // A failed exchange means another writer advanced it: epoch is then the newer value
+  if(__atomic_compare_exchange_n(&epoch_global, &epoch, epoch + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+    epoch++;
+  }
+  return epoch;
+}
+
+/**
+ * @brief Waits until every block retired so far is safe to free
+ */
+void croquette_epoch_synchronize() {
+  uint64_t target = __atomic_load_n(&epoch_global, __ATOMIC_SEQ_CST) + 2;
+  while(croquette_epoch_advance() < target) {
+    sched_yield();
+  }
+}
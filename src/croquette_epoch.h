@@ -0,0 +1,99 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_epoch.h
+ * @brief Private Epoch Based Reclamation for lock-free Croquette readers
+ *
+ * Not part of the public API; only included by the Croquette sources.
+ * Readers bracket their traversal with croquette_epoch_enter()/croquette_epoch_exit().
+ * Writers unlink a block, retire it into a list tagged with the current epoch, and free it
+ * only once croquette_epoch_advance() has moved two epochs past that tag, by which time
+ * every reader that could still hold the block has exited.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+
+#ifndef CROQUETTE_EPOCH_H
+#define CROQUETTE_EPOCH_H
+
+#include <stdint.h>
+
+// Retire List Sizes
+#define EPOCH_COLLECT_MIN 64        // Retired blocks held before the first collection is tried
+
+/**
+ * @struct Croquette_Retired_s
+ *
+ * @brief A block waiting for every reader that might hold it to exit.
+ */
+typedef struct croquette_retired {
+  void *block;                    ///< The unlinked block.
+  int kind;                       ///< What the block is (meaning private to the owner of the list).
+  uint64_t epoch;                 ///< Epoch it was retired in.
+} Croquette_Retired_s;
+
+/**
+ * @struct Croquette_Retire_List_s
+ *
+ * @brief Blocks retired by one writer (kept under that writer's lock).
+ */
+typedef struct croquette_retire_list {
+  Croquette_Retired_s *items;     ///< Retired blocks, oldest first.
+  int count;                      ///< Number of retired blocks.
+  int capacity;                   ///< Number of slots in items.
+  int collect_at;                 ///< count at which the owner should try to reclaim.
+} Croquette_Retire_List_s;
+
+/**
+ * @brief Marks the calling thread as reading (nests)
+ *
+ * @return 1 on Success
+ * @return 0 if the thread could not be registered (out of memory); read under a lock instead
+ */
+int croquette_epoch_enter();
+/**
+ * @brief Ends the read started by the matching croquette_epoch_enter()
+ */
+void croquette_epoch_exit();
+/**
+ * @brief Adds a block to a retire list, tagged with the current epoch
+ *
+ * @param list The retire list.
+ * @param block The block, already unreachable for new readers.
+ * @param kind Passed back with the block when it is reclaimed.
+ * @return 1 on Success
+ * @return 0 if out of memory (nothing was retired)
+ */
+int croquette_epoch_retire(Croquette_Retire_List_s *list, void *block, int kind);
+/**
+ * @brief Reads the global epoch, to tag a block retired outside a Croquette_Retire_List_s
+ *
+ * @return The current epoch
+ */
+uint64_t croquette_epoch_current();
+/**
+ * @brief Moves the global epoch forward if every active reader has seen it
+ *
+ * @return The global epoch; blocks retired in epoch e are safe to free once e + 2 <= it
+ */
+uint64_t croquette_epoch_advance();
+/**
+ * @brief Waits until every block retired so far is safe to free
+ */
+void croquette_epoch_synchronize();
+
+#endif
@@ -0,0 +1,175 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_internal.h
+ * @brief Private definitions shared by croquette.c and the table Backends
+ *
+ * Not part of the public API; only included by the Croquette sources.
+ * - croquette.c validates arguments, hashes Keys and dispatches to the Backend.
+ * - Each Backend (separate chaining in croquette.c, others in croquette_<name>.c)
+ *   stores the Entries and keeps size and capacity up to date.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+
+#ifndef CROQUETTE_INTERNAL_H
+#define CROQUETTE_INTERNAL_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croquette.h"
+#include "croquette_epoch.h"
+#include "croquette_slab.h"
+
+typedef struct croquette_backend Croquette_Backend_s;
+
+/**
+ * @struct Croquette_s
+ *
+ * @brief Main Structure for Croquette
+ *
+ * This provides the definitions needed for Croquette, along with all of the functions
+ *   needed to work with the chosen key and value.
+ * The table fields belong to the chaining Backend; other Backends keep their state in store.
+ */
+typedef struct croquette_struct {
+  int do_free;                                      ///< Boolean: Free nodes on removal?
+  int size;                                         ///< Number of Keys in Croquette
+  int capacity;                                     ///< Number of Indices in Croquette
+  int base_capacity;                                ///< Base Number of Indices in Croquette (the floor while pinned)
+  int pinned;                                       ///< Boolean: Capacity is pinned (no shrinking below base_capacity)
+  int unpinned_base;                                ///< base_capacity to restore when unpinned
+  int pow2;                                         ///< Boolean: Capacities are Powers of Two (mask indexing)
+  struct carrier_struct **old_table;                ///< Table being migrated from (NULL unless Incremental Rehash)
+  int old_capacity;                                 ///< Number of Indices in old_table
+  int rehash_index;                                 ///< Next Index of old_table to migrate
+  int rehash_step;                                  ///< Indices to migrate per operation (0 for all at once)
+  int max_load;                                     ///< Percent load that doubles (chaining)
+  int min_load;                                     ///< Percent load that halves (chaining)
+  int auto_shrink;                                  ///< Boolean: Removals may halve the table
+  Croquette_Slab_s *slab;                           ///< Allocator for Entries and Keys (NULL for malloc)
+  struct carrier_struct **table;                    ///< Vector of Carrier Pointers
+  struct tree_bin **bins;                           ///< Tree Bins parallel to table (NULL until a chain grows long)
+  const Croquette_Backend_s *backend;               ///< Table engine storing the Entries
+  int small_size;                                   ///< Keys held in the small map before upgrading (0 = off)
+  const Croquette_Backend_s *large_backend;         ///< Backend a small map upgrades to
+  int large_capacity;                               ///< Initial capacity of large_backend
+  void *store;                                      ///< Backend private state (NULL for chaining)
+  void (*free_value)(void *value);                  ///< Function to call to free the Value
+  int (*value_compare)(const void *value1, const void *value2); ///< Function to compare two values (v1 vs. v2)
+  Croquette_Hash_f hash_fn;                         ///< Function to hash Keys (NULL for croquette_hash)
+  Croquette_KeyEqual_f key_equal;                   ///< Function to compare Keys (NULL for byte compare)
+  uint64_t seed;                                    ///< Seed passed to the hash function
+  long inserts;                                     ///< Number of new Keys inserted (for stats)
+  long insert_failures;                             ///< Inserts the Backend could not place without a resize
+  int thread_safe;                                  ///< Boolean: public functions take lock
+  pthread_rwlock_t lock;                            ///< Shared for lookups, exclusive for changes (if thread_safe)
+  struct croquette_struct **segments;               ///< Thread safe Segments routed by hash (NULL unless segmented)
+  int num_segments;                                 ///< Power of Two number of Segments
+  int segment_bits;                                 ///< log2(num_segments): top hash bits that pick a Segment
+  int lock_free_reads;                              ///< Boolean: lookups take no lock (chaining only)
+  struct chained_view *view;                        ///< Table and capacity published to lock-free readers
+  Croquette_Retire_List_s retired;                  ///< Unlinked Entries and tables awaiting reclamation
+  int non_blocking;                                 ///< Boolean: the Backend needs no lock, only an epoch (read before locking)
+} Croquette_s;
+
+/**
+ * @struct Croquette_Backend_s
+ *
+ * @brief Operations of a table engine
+ *
+ * Keys are validated and hashed before any operation is called.
+ * A found Entry is reported as the address of its Value, so callers can read or update it in place.
+ */
+struct croquette_backend {
+  const char *name;                                 ///< Name of the Backend (for reports)
+  int non_blocking;                                 ///< Boolean: every operation is safe without the lock (inside an epoch)
+  /** Allocates an empty table of at least capacity Indices, C_Success or C_Error. */
+  int (*init)(Croquette_s *croquette, int capacity);
+  /** Frees the (empty) table and any Backend state. */
+  void (*destroy)(Croquette_s *croquette);
+  /** Returns the address of the Value for a Key, or NULL if No Such Key. */
+  void **(*find)(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+  /** Returns the address of a Value matching value_compare, or NULL if none. */
+  void **(*find_value)(Croquette_s *croquette, const void *value);
+  /** Inserts a Key known to be absent, growing if needed, C_Success or C_Error. */
+  int (*insert)(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+  /** Inserts or updates a Key in one step (NULL to find then insert); see croquette_h_put_n() and putIfAbsent(). */
+  int (*put)(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value,
+             int only_if_absent, void **existing);
+  /** Removes a Key if present (freeing the Value if do_free), shrinking if needed, C_Success or C_Error. */
+  int (*remove)(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+  /** Removes every Entry (freeing Values if do_free) and resets to base_capacity, C_Success or C_Error. */
+  int (*clear)(Croquette_s *croquette);
+  /** Prints every Key with its Index. */
+  void (*print_keys)(Croquette_s *croquette);
+  /** Grows (never shrinks) so n Keys fit without another resize, C_Success or C_Error. */
+  int (*reserve)(Croquette_s *croquette, int n);
+  /** Shrinks to the smallest capacity (from base_capacity) that holds size Keys, C_Success or C_Error. */
+  int (*shrink_to_fit)(Croquette_s *croquette);
+  /** Calls visit on every Entry, returning the first non-zero result (0 if all were visited). */
+  int (*foreach)(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+};
+
+// Backends
+extern const Croquette_Backend_s croquette_robinhood_backend;   // croquette_robinhood.c
+extern const Croquette_Backend_s croquette_swiss_backend;        // croquette_swiss.c
+extern const Croquette_Backend_s croquette_cuckoo_backend;       // croquette_cuckoo.c
+extern const Croquette_Backend_s croquette_bucket_backend;       // croquette_bucket.c
+extern const Croquette_Backend_s croquette_compact_backend;      // croquette_compact.c
+extern const Croquette_Backend_s croquette_small_backend;        // croquette_small.c
+extern const Croquette_Backend_s croquette_splitorder_backend;   // croquette_splitorder.c
+
+/**
+ * @brief Compares a stored Key against a Key, with key_equal if configured or byte-wise
+ *
+ * @return True if the Keys are equal
+ */
+static inline int croquette_key_equal(const Croquette_s *croquette, const char *stored, size_t stored_len,
+                                      const char *key, size_t len) {
+  if(croquette->key_equal != NULL) {
+    return croquette->key_equal(stored, stored_len, key, len) != 0;
+  }
+  return stored_len == len && memcmp(stored, key, len) == 0;
+}
+
+/**
+ * @brief Allocates Entry storage from the Croquette's Slab if it has one, otherwise malloc()
+ *
+ * @return The block, or NULL if out of memory
+ */
+static inline void *croquette_block_alloc(Croquette_s *croquette, size_t size) {
+  if(croquette->slab != NULL) {
+    return croquette_slab_alloc(croquette->slab, size);
+  }
+  return malloc(size);
+}
+
+/**
+ * @brief Frees Entry storage from croquette_block_alloc() (size must match the allocation)
+ */
+static inline void croquette_block_free(Croquette_s *croquette, void *block, size_t size) {
+  if(croquette->slab != NULL) {
+    croquette_slab_free(croquette->slab, block, size);
+    return;
+  }
+  free(block);
+}
+
+#endif
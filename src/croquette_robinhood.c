@@ -0,0 +1,450 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_robinhood.c
+ * @brief Robin Hood Open Addressing Backend for Croquette
+ * - Every Entry is a slot (hash, Key reference, Value) in one contiguous array; no nodes, no chains.
+ * - Linear probing, where an inserted Entry takes the slot of any Entry closer to its home Index,
+ *   so probe lengths stay short and even at load factors up to 0.9.
+ * - A lookup stops as soon as it passes an Entry closer to home than itself would be.
+ * - Removal shifts the following Entries back one slot (no tombstones).
+ * - Capacities are always Powers of Two (mask indexing).
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croquette_internal.h"
+
+// Load Limits (in tenths of the capacity)
+#define RH_MAX_LOAD 9     // Doubles when an insert would pass 0.9
+#define RH_MIN_LOAD 2     // Halves when a removal drops below 0.2 (never below base_capacity)
+
+/**
+ * @struct RH_Slot_s
+ *
+ * @brief One slot of the Robin Hood table (32 bytes on LP64, two per cache line)
+ */
+typedef struct rh_slot {
+  uint64_t hash;          ///< Cached full hash of the Key.
+  char *key;              ///< Key for Croquette (NUL terminated copy).
+  void *value;            ///< Value for Croquette to Store.
+  uint32_t key_len;       ///< Number of bytes in the Key.
+  uint32_t dist;          ///< Distance from the home Index plus one (0 marks an empty slot).
+} RH_Slot_s;
+
+// Internal Prototypes - (Private to this Source File Only)
+static int rh_init(Croquette_s *croquette, int capacity);
+static void rh_destroy(Croquette_s *croquette);
+static void **rh_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void **rh_find_value(Croquette_s *croquette, const void *value);
+static int rh_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static int rh_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int rh_clear(Croquette_s *croquette);
+static void rh_print_keys(Croquette_s *croquette);
+static int rh_reserve(Croquette_s *croquette, int n);
+static int rh_shrink_to_fit(Croquette_s *croquette);
+static int rh_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+static int rh_resize(Croquette_s *croquette, int new_capacity);
+static void rh_place(RH_Slot_s *slots, size_t mask, RH_Slot_s entry);
+static long rh_find_index(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static inline size_t rh_home(uint64_t hash, size_t mask);
+
+// Robin Hood Backend
+const Croquette_Backend_s croquette_robinhood_backend = {
+  .name = "robinhood",
+  .init = rh_init,
+  .destroy = rh_destroy,
+  .find = rh_find,
+  .find_value = rh_find_value,
+  .insert = rh_insert,
+  .remove = rh_remove,
+  .clear = rh_clear,
+  .print_keys = rh_print_keys,
+  .reserve = rh_reserve,
+  .shrink_to_fit = rh_shrink_to_fit,
+  .foreach = rh_foreach
+};
+
+/**
+ * @brief Allocates an empty slot array, rounding the capacity up to a Power of Two
+ *
+ * @param croquette The Croquette being created.
+ * @param capacity Minimum number of slots.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int rh_init(Croquette_s *croquette, int capacity) {
+  int rounded = 1;
+  while(rounded < capacity && rounded < (1 << 30)) {
+    rounded <<= 1;
+  }
+
+  croquette->store = calloc(rounded, sizeof(RH_Slot_s));
+  if(croquette->store == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  croquette->capacity = rounded;
+  return C_Success;
+}
+
+/**
+ * @brief Frees the (empty) slot array
+ *
+ * @param croquette The Croquette being deleted.
+ */
+static void rh_destroy(Croquette_s *croquette) {
+  free(croquette->store);
+  croquette->store = NULL;
+}
+
+/**
+ * @brief Gets the home Index of a hash
+ *
+ * @param hash The hash of the key.
+ * @param mask Capacity - 1.
+ * @return The Index the Key would occupy with no collisions.
+ */
+static inline size_t rh_home(uint64_t hash, size_t mask) {
+  return (size_t)(hash ^ (hash >> 32)) & mask;
+}
+
+/**
+ * @brief Finds the slot Index of a Key
+ *
+ * Probing stops at an empty slot or at an Entry closer to its home than the Key would be,
+ * since the Key would have displaced that Entry on insert.
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Index of the slot if Key Exists
+ * @return -1 if No Such Key
+ */
+static long rh_find_index(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  RH_Slot_s *slots = croquette->store;
+  size_t mask = (size_t)croquette->capacity - 1;
+  size_t index = rh_home(hash, mask);
+  uint32_t dist = 1;
+
+  while(slots[index].dist >= dist) {
+    if(slots[index].hash == hash &&
+       croquette_key_equal(croquette, slots[index].key, slots[index].key_len, key, len)) {
+      return (long)index;
+    }
+    index = (index + 1) & mask;
+    dist++;
+  }
+  return -1;
+}
+
+/**
+ * @brief Finds the Value slot for a Key
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Address of the Entry's Value if Key Exists
+ * @return NULL if No Such Key
+ */
+static void **rh_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  long index = rh_find_index(croquette, key, len, hash);
+  if(index < 0) {
+    return NULL;
+  }
+  return &((RH_Slot_s *)croquette->store)[index].value;
+}
+
+/**
+ * @brief Finds the Value slot of any Entry holding a matching Value
+ *
+ * @param croquette The Croquette to search.
+ * @param value Value to compare against.
+ * @return Address of the Entry's Value if Value Exists
+ * @return NULL if No Such Value
+ */
+static void **rh_find_value(Croquette_s *croquette, const void *value) {
+  RH_Slot_s *slots = croquette->store;
+  int i = 0;
+  for(i = 0; i < croquette->capacity; i++) {
+    if(slots[i].dist != 0 && croquette->value_compare(slots[i].value, value) == 0) {
+      return &slots[i].value;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Places an Entry, taking the slot of any Entry closer to its home Index
+ *
+ * The displaced Entry continues probing from there.  The table must have an empty slot.
+ *
+ * @param slots The slot array.
+ * @param mask Capacity - 1.
+ * @param entry The Entry to place (its dist is reset to 1 here).
+ */
+static void rh_place(RH_Slot_s *slots, size_t mask, RH_Slot_s entry) {
+  RH_Slot_s displaced;
+  size_t index = rh_home(entry.hash, mask);
+
+  entry.dist = 1;
+  while(slots[index].dist != 0) {
+    if(slots[index].dist < entry.dist) {
+      displaced = slots[index];
+      slots[index] = entry;
+      entry = displaced;
+    }
+    index = (index + 1) & mask;
+    entry.dist++;
+  }
+  slots[index] = entry;
+}
+
+/**
+ * @brief Inserts a Key known not to be in the Croquette, doubling first if needed
+ *
+ * @param croquette The Croquette to insert into.
+ * @param key Key bytes to add to the croquette.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Add
+ * @return C_Error on Error (Error String Available)
+ */
+static int rh_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
+  if((long)(croquette->size + 1) * 10 > (long)croquette->capacity * RH_MAX_LOAD) {
+    if(rh_resize(croquette, croquette->capacity << 1) == C_Error) {
+      return C_Error;
+    }
+  }
+
+  RH_Slot_s entry;
+  entry.key = croquette_block_alloc(croquette, len + 1);
+  if(entry.key == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  memcpy(entry.key, key, len);
+  entry.key[len] = '\0';
+  entry.key_len = (uint32_t)len;
+  entry.hash = hash;
+  entry.value = value;
+  entry.dist = 1;
+
+  rh_place(croquette->store, (size_t)croquette->capacity - 1, entry);
+  croquette->size++;
+  return C_Success;
+}
+
+/**
+ * @brief Removes a Key if present, shifting the following Entries back one slot
+ *
+ * @param croquette The Croquette to remove from.
+ * @param key Key bytes to identify which entry to remove.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+static int rh_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  long found = rh_find_index(croquette, key, len, hash);
+  if(found < 0) {
+    return C_Success;
+  }
+
+  RH_Slot_s *slots = croquette->store;
+  size_t mask = (size_t)croquette->capacity - 1;
+  size_t index = (size_t)found;
+  size_t next = (index + 1) & mask;
+
+  if(croquette->do_free == C_Do_Free) {
+    croquette->free_value(slots[index].value);
+  }
+  croquette_block_free(croquette, slots[index].key, slots[index].key_len + 1);
+
+  /* Backward Shift: pull each displaced follower one slot closer to home */
+  while(slots[next].dist > 1) {
+    slots[index] = slots[next];
+    slots[index].dist--;
+    index = next;
+    next = (next + 1) & mask;
+  }
+  memset(&slots[index], 0, sizeof(RH_Slot_s));
+  croquette->size--;
+
+  if(croquette->auto_shrink && croquette->capacity > croquette->base_capacity &&
+     (long)croquette->size * 10 < (long)croquette->capacity * RH_MIN_LOAD) {
+    return rh_resize(croquette, croquette->capacity >> 1);
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Moves every Entry into a new slot array of new_capacity slots
+ *
+ * @param croquette The Croquette to resize.
+ * @param new_capacity Power of Two number of slots (must exceed the size).
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the table is unchanged, Error string set).
+ */
+static int rh_resize(Croquette_s *croquette, int new_capacity) {
+  RH_Slot_s *old_slots = croquette->store;
+  RH_Slot_s *new_slots = calloc(new_capacity, sizeof(RH_Slot_s));
+  int i = 0;
+
+  if(new_slots == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  for(i = 0; i < croquette->capacity; i++) {
+    if(old_slots[i].dist != 0) {
+      rh_place(new_slots, (size_t)new_capacity - 1, old_slots[i]);
+    }
+  }
+  free(old_slots);
+  croquette->store = new_slots;
+  croquette->capacity = new_capacity;
+  return C_Success;
+}
+
+/**
+ * @brief Clears the slot array and resets it to base_capacity
+ *
+ * @param croquette The Croquette to clear.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+static int rh_clear(Croquette_s *croquette) {
+  RH_Slot_s *slots = croquette->store;
+  int i = 0;
+
+  /* With a Slab, Keys go a slab at once, so slots are only visited to free Values */
+  if(croquette->slab == NULL || croquette->do_free == C_Do_Free) {
+    for(i = 0; i < croquette->capacity; i++) {
+      if(slots[i].dist == 0) {
+        continue;
+      }
+      if(croquette->do_free == C_Do_Free) {
+        croquette->free_value(slots[i].value);
+      }
+      if(croquette->slab == NULL) {
+        free(slots[i].key);
+      }
+    }
+  }
+  croquette_slab_reset(croquette->slab);
+  croquette->size = 0;
+
+  /* Reset to Base Capacity */
+  if(croquette->capacity == croquette->base_capacity) {
+    memset(slots, 0, croquette->capacity * sizeof(RH_Slot_s));
+    return C_Success;
+  }
+  RH_Slot_s *base_slots = calloc(croquette->base_capacity, sizeof(RH_Slot_s));
+  if(base_slots == NULL) {
+    memset(slots, 0, croquette->capacity * sizeof(RH_Slot_s));
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  free(slots);
+  croquette->store = base_slots;
+  croquette->capacity = croquette->base_capacity;
+  return C_Success;
+}
+
+/**
+ * @brief Prints all Keys (and their slot Indices) of the Robin Hood table
+ *
+ * @param croquette The Croquette to print.
+ */
+static void rh_print_keys(Croquette_s *croquette) {
+  RH_Slot_s *slots = croquette->store;
+  int i = 0;
+  for(i = 0; i < croquette->capacity; i++) {
+    if(slots[i].dist != 0) {
+      printf("[%2d] %s\n", i, slots[i].key);
+    }
+  }
+}
+
+/**
+ * @brief Doubles a Robin Hood capacity until n Keys stay within RH_MAX_LOAD
+ *
+ * @return The capacity
+ */
+static int rh_fit_capacity(int capacity, int n) {
+  while((long)n * 10 > (long)capacity * RH_MAX_LOAD && capacity < (1 << 30)) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+/**
+ * @brief Doubles the Robin Hood table until n Keys stay within RH_MAX_LOAD (one resize)
+ *
+ * @param croquette The Croquette to grow.
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int rh_reserve(Croquette_s *croquette, int n) {
+  int capacity = rh_fit_capacity(croquette->capacity, n);
+  if(capacity == croquette->capacity) {
+    return C_Success;
+  }
+  return rh_resize(croquette, capacity);
+}
+
+/**
+ * @brief Resizes the Robin Hood table to the smallest doubling of base_capacity within RH_MAX_LOAD
+ *
+ * @param croquette The Croquette to shrink.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int rh_shrink_to_fit(Croquette_s *croquette) {
+  int capacity = rh_fit_capacity(croquette->base_capacity, croquette->size);
+  if(capacity >= croquette->capacity) {
+    return C_Success;
+  }
+  return rh_resize(croquette, capacity);
+}
+
+/**
+ * @brief Visits every Entry of the Robin Hood table in slot order
+ *
+ * @param croquette The Croquette to visit.
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return The first non-zero result of visit, or 0
+ */
+static int rh_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg) {
+  RH_Slot_s *slots = croquette->store;
+  int stop = 0;
+  int i = 0;
+  for(i = 0; i < croquette->capacity; i++) {
+    if(slots[i].dist != 0 && (stop = visit(slots[i].key, slots[i].key_len, slots[i].value, arg)) != 0) {
+      return stop;
+    }
+  }
+  return 0;
+}
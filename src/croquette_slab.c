@@ -0,0 +1,220 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_slab.c
+ * @brief Slab Allocator for Croquette Entries and Key bytes
+ * - Blocks are bump-allocated out of large slabs, so neighbouring entries share cache lines.
+ * - Freed blocks go on a free list per size class (multiples of SLAB_GRANULE) for reuse.
+ * - All slabs are released at once by croquette_slab_reset() (no per-block frees).
+ * - Requests over SLAB_MAX_BLOCK are passed to malloc() but still released by a reset.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include "croquette_slab.h"
+
+#define SLAB_NUM_CLASSES (SLAB_MAX_BLOCK / SLAB_GRANULE)
+
+/**
+ * @struct Slab_Free_s
+ *
+ * @brief A freed block, linked into the free list of its size class.
+ */
+typedef struct slab_free {
+  struct slab_free *next;         ///< Next free block of the same size class.
+} Slab_Free_s;
+
+/**
+ * @struct Slab_Chunk_s
+ *
+ * @brief Header of a slab (or of a large block); the blocks follow the header.
+ */
+typedef struct slab_chunk {
+  struct slab_chunk *next;        ///< Next chunk in the list.
+  struct slab_chunk *prev;        ///< Previous chunk in the list (large blocks only).
+} Slab_Chunk_s;
+
+/**
+ * @struct croquette_slab
+ *
+ * @brief The Slab Allocator: a bump region, free lists per size class and the list of slabs.
+ */
+struct croquette_slab {
+  char *bump;                                 ///< Next unused byte of the current slab.
+  char *bump_end;                             ///< End of the current slab.
+  Slab_Free_s *free_lists[SLAB_NUM_CLASSES];  ///< Freed blocks by size class.
+  Slab_Chunk_s *slabs;                        ///< Every slab allocated.
+  Slab_Chunk_s *large;                        ///< Blocks over SLAB_MAX_BLOCK (malloc'd).
+};
+
+// Header size, rounded to keep blocks aligned to SLAB_GRANULE
+#define SLAB_HEADER (((sizeof(Slab_Chunk_s) + SLAB_GRANULE - 1) / SLAB_GRANULE) * SLAB_GRANULE)
+
+/**
+ * @brief Gets the size class for a request size
+ *
+ * @param size Number of bytes requested (1..SLAB_MAX_BLOCK).
+ * @return Index into free_lists.
+ */
+static inline size_t slab_class(size_t size) {
+  return (size + SLAB_GRANULE - 1) / SLAB_GRANULE - 1;
+}
+
+/**
+ * @brief Creates an empty Slab Allocator
+ *
+ * @return The Slab Allocator on Success
+ * @return NULL if out of memory
+ */
+Croquette_Slab_s *croquette_slab_create() {
+  return calloc(1, sizeof(Croquette_Slab_s));
+}
+
+/**
+ * @brief Allocates a block of at least size bytes (not zeroed)
+ *
+ * Reuses a freed block of the same size class if there is one, otherwise bumps
+ * the current slab, starting a new slab when the current one is exhausted.
+ *
+ * @param slab The Slab Allocator.
+ * @param size Number of bytes needed.
+ * @return The block on Success
+ * @return NULL if out of memory
+ */
+void *croquette_slab_alloc(Croquette_Slab_s *slab, size_t size) {
+  if(size == 0) {
+    size = 1;
+  }
+
+  /* Large blocks are tracked in a list so a reset can still release them */
+  if(size > SLAB_MAX_BLOCK) {
+    Slab_Chunk_s *chunk = malloc(SLAB_HEADER + size);
+    if(chunk == NULL) {
+      return NULL;
+    }
+    chunk->prev = NULL;
+    chunk->next = slab->large;
+    if(slab->large != NULL) {
+      slab->large->prev = chunk;
+    }
+    slab->large = chunk;
+    return (char *)chunk + SLAB_HEADER;
+  }
+
+  size_t class = slab_class(size);
+  Slab_Free_s *block = slab->free_lists[class];
+  if(block != NULL) {
+    slab->free_lists[class] = block->next;
+    return block;
+  }
+
+  size_t block_size = (class + 1) * SLAB_GRANULE;
+  if(slab->bump == NULL || (size_t)(slab->bump_end - slab->bump) < block_size) {
+    Slab_Chunk_s *chunk = malloc(SLAB_CHUNK_SIZE);
+    if(chunk == NULL) {
+      return NULL;
+    }
+    chunk->next = slab->slabs;
+    chunk->prev = NULL;
+    slab->slabs = chunk;
+    slab->bump = (char *)chunk + SLAB_HEADER;
+    slab->bump_end = (char *)chunk + SLAB_CHUNK_SIZE;
+  }
+
+  void *fresh = slab->bump;
+  slab->bump += block_size;
+  return fresh;
+}
+
+/**
+ * @brief Returns a block to the Slab Allocator for reuse
+ *
+ * @param slab The Slab Allocator.
+ * @param block The block from croquette_slab_alloc() (NULL is ignored).
+ * @param size The size that was passed to croquette_slab_alloc().
+ */
+void croquette_slab_free(Croquette_Slab_s *slab, void *block, size_t size) {
+  if(block == NULL) {
+    return;
+  }
+  if(size == 0) {
+    size = 1;
+  }
+
+  if(size > SLAB_MAX_BLOCK) {
+    Slab_Chunk_s *chunk = (Slab_Chunk_s *)((char *)block - SLAB_HEADER);
+    if(chunk->prev != NULL) {
+      chunk->prev->next = chunk->next;
+    }
+    else {
+      slab->large = chunk->next;
+    }
+    if(chunk->next != NULL) {
+      chunk->next->prev = chunk->prev;
+    }
+    free(chunk);
+    return;
+  }
+
+  size_t class = slab_class(size);
+  Slab_Free_s *freed = block;
+  freed->next = slab->free_lists[class];
+  slab->free_lists[class] = freed;
+}
+
+/**
+ * @brief Releases every block at once, freeing all slabs
+ *
+ * @param slab The Slab Allocator, which stays usable.
+ */
+void croquette_slab_reset(Croquette_Slab_s *slab) {
+  Slab_Chunk_s *reaper = NULL;
+  size_t i = 0;
+
+  if(slab == NULL) {
+    return;
+  }
+  while(slab->slabs != NULL) {
+    reaper = slab->slabs;
+    slab->slabs = reaper->next;
+    free(reaper);
+  }
+  while(slab->large != NULL) {
+    reaper = slab->large;
+    slab->large = reaper->next;
+    free(reaper);
+  }
+  for(i = 0; i < SLAB_NUM_CLASSES; i++) {
+    slab->free_lists[i] = NULL;
+  }
+  slab->bump = NULL;
+  slab->bump_end = NULL;
+}
+
+/**
+ * @brief Releases every block and the Slab Allocator itself
+ *
+ * @param slab The Slab Allocator (NULL is ignored).
+ */
+void croquette_slab_destroy(Croquette_Slab_s *slab) {
+  if(slab == NULL) {
+    return;
+  }
+  croquette_slab_reset(slab);
+  free(slab);
+}
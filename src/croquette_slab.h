@@ -0,0 +1,78 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_slab.h
+ * @brief Private Slab Allocator for Croquette Entries and Key bytes
+ *
+ * Not part of the public API; only included by the Croquette sources.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+
+#ifndef CROQUETTE_SLAB_H
+#define CROQUETTE_SLAB_H
+
+#include <stddef.h>
+
+// Slab Sizes
+#define SLAB_GRANULE 16             // Every block is a multiple of this (and aligned to it)
+#define SLAB_MAX_BLOCK 512          // Larger requests fall back to malloc()
+#define SLAB_CHUNK_SIZE 65536       // Bytes requested from malloc() per slab
+
+/**
+ * @brief Handle to a Slab Allocator (private to croquette_slab.c)
+ */
+typedef struct croquette_slab Croquette_Slab_s;
+
+/**
+ * @brief Creates an empty Slab Allocator
+ *
+ * @return The Slab Allocator on Success
+ * @return NULL if out of memory
+ */
+Croquette_Slab_s *croquette_slab_create();
+/**
+ * @brief Allocates a block of at least size bytes (not zeroed)
+ *
+ * @param slab The Slab Allocator.
+ * @param size Number of bytes needed.
+ * @return The block on Success
+ * @return NULL if out of memory
+ */
+void *croquette_slab_alloc(Croquette_Slab_s *slab, size_t size);
+/**
+ * @brief Returns a block to the Slab Allocator for reuse
+ *
+ * @param slab The Slab Allocator.
+ * @param block The block from croquette_slab_alloc() (NULL is ignored).
+ * @param size The size that was passed to croquette_slab_alloc().
+ */
+void croquette_slab_free(Croquette_Slab_s *slab, void *block, size_t size);
+/**
+ * @brief Releases every block at once, freeing all slabs
+ *
+ * @param slab The Slab Allocator, which stays usable.
+ */
+void croquette_slab_reset(Croquette_Slab_s *slab);
+/**
+ * @brief Releases every block and the Slab Allocator itself
+ *
+ * @param slab The Slab Allocator (NULL is ignored).
+ */
+void croquette_slab_destroy(Croquette_Slab_s *slab);
+
+#endif
@@ -0,0 +1,456 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_small.c
+ * @brief Small Map Mode for Croquette: a linear array used until a map outgrows small_size Keys
+ * - Entries (hash, Key, Value) sit in one flat array in insertion order, scanned linearly;
+ *   the cached hash is compared before any Key bytes, and no Index is ever computed.
+ * - The array and a Key arena of SMALL_KEY_BYTES per Entry are one allocation, so creating,
+ *   filling and deleting a small map costs no allocation per Entry.
+ * - Removal shifts the later Entries down (keeping the order); the arena hole is packed out
+ *   when the arena next fills, and longer Keys move the arena to the heap.
+ * - Inserting Key small_size + 1 (or reserving more) upgrades the map to its configured
+ *   Backend for good: every Entry is inserted there and the array is freed.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croquette_internal.h"
+
+// Small Sizes
+#define SMALL_KEY_BYTES 16              // Inline arena bytes per Entry (Keys up to 15 characters)
+
+/**
+ * @struct Small_Entry_s
+ *
+ * @brief An Entry in the flat array; its Key lives in the Key arena
+ */
+typedef struct small_entry {
+  uint64_t hash;          ///< Cached full hash of the Key (compared first, reused on upgrade).
+  void *value;            ///< Value for Croquette to Store.
+  uint32_t key_off;       ///< Offset of the Key in the arena.
+  uint32_t key_len;       ///< Number of bytes in the Key.
+} Small_Entry_s;
+
+/**
+ * @struct Small_Store_s
+ *
+ * @brief State of a small map, allocated with room for small_size Entries and their inline arena
+ */
+typedef struct small_store {
+  char *keys;                 ///< Key arena: the inline bytes after entries, or the heap once outgrown.
+  size_t keys_used;           ///< Bytes of the arena in use, including removed Keys.
+  size_t keys_cap;            ///< Bytes available in the arena.
+  Small_Entry_s entries[];    ///< small_size Entries in insertion order (croquette->size in use).
+} Small_Store_s;
+
+// Internal Prototypes - (Private to this Source File Only)
+static int small_init(Croquette_s *croquette, int capacity);
+static void small_destroy(Croquette_s *croquette);
+static void **small_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void **small_find_value(Croquette_s *croquette, const void *value);
+static int small_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static int small_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int small_clear(Croquette_s *croquette);
+static void small_print_keys(Croquette_s *croquette);
+static int small_reserve(Croquette_s *croquette, int n);
+static int small_shrink_to_fit(Croquette_s *croquette);
+static int small_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+static int small_make_room(Croquette_s *croquette, size_t len);
+static int small_upgrade(Croquette_s *croquette, int n);
+static int small_lookup(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static inline char *small_inline_keys(Croquette_s *croquette);
+
+// Small Backend
+const Croquette_Backend_s croquette_small_backend = {
+  .name = "small",
+  .init = small_init,
+  .destroy = small_destroy,
+  .find = small_find,
+  .find_value = small_find_value,
+  .insert = small_insert,
+  .remove = small_remove,
+  .clear = small_clear,
+  .print_keys = small_print_keys,
+  .reserve = small_reserve,
+  .shrink_to_fit = small_shrink_to_fit,
+  .foreach = small_foreach
+};
+
+/**
+ * @brief Finds the inline Key arena that follows the small_size Entries
+ *
+ * @param croquette The small map.
+ * @return The first inline arena byte
+ */
+static inline char *small_inline_keys(Croquette_s *croquette) {
+  Small_Store_s *store = croquette->store;
+  return (char *)&store->entries[croquette->small_size];
+}
+
+/**
+ * @brief Allocates the flat array and its inline Key arena (capacity is always small_size)
+ *
+ * @param croquette The Croquette being created (small_size set).
+ * @param capacity Ignored; the configured capacity applies to the Backend upgraded to.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int small_init(Croquette_s *croquette, int capacity) {
+  size_t inline_bytes = (size_t)croquette->small_size * SMALL_KEY_BYTES;
+  Small_Store_s *store = malloc(sizeof(Small_Store_s) + croquette->small_size * sizeof(Small_Entry_s) +
+                                inline_bytes);
+  if(store == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  croquette->store = store;
+  store->keys = small_inline_keys(croquette);
+  store->keys_used = 0;
+  store->keys_cap = inline_bytes;
+  croquette->capacity = croquette->small_size;
+  return C_Success;
+}
+
+/**
+ * @brief Frees the (empty) flat array and any heap Key arena
+ *
+ * @param croquette The Croquette being deleted.
+ */
+static void small_destroy(Croquette_s *croquette) {
+  Small_Store_s *store = croquette->store;
+  if(store == NULL) {
+    return;
+  }
+  if(store->keys != small_inline_keys(croquette)) {
+    free(store->keys);
+  }
+  free(store);
+  croquette->store = NULL;
+}
+
+/**
+ * @brief Finds the Entry for a Key with a linear scan (hash first, then Key bytes)
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Position of the Entry, or -1 if No Such Key
+ */
+static int small_lookup(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Small_Store_s *store = croquette->store;
+  int i = 0;
+  for(i = 0; i < croquette->size; i++) {
+    Small_Entry_s *entry = &store->entries[i];
+    if(entry->hash == hash &&
+       croquette_key_equal(croquette, store->keys + entry->key_off, entry->key_len, key, len)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Finds the Value slot for a Key
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Address of the Entry's Value if Key Exists
+ * @return NULL if No Such Key
+ */
+static void **small_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Small_Store_s *store = croquette->store;
+  int index = small_lookup(croquette, key, len, hash);
+  return (index < 0) ? NULL : &store->entries[index].value;
+}
+
+/**
+ * @brief Finds the Value slot of the first Entry whose Value matches, in insertion order
+ *
+ * @param croquette The Croquette to search.
+ * @param value Value to compare against with value_compare.
+ * @return Address of the matching Value, or NULL if none
+ */
+static void **small_find_value(Croquette_s *croquette, const void *value) {
+  Small_Store_s *store = croquette->store;
+  int i = 0;
+  for(i = 0; i < croquette->size; i++) {
+    if(croquette->value_compare(store->entries[i].value, value) == 0) {
+      return &store->entries[i].value;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Makes room in the Key arena for a Key of len bytes
+ *
+ * Packs out the Keys of removed Entries first; if that is not enough, the arena moves to
+ * (or grows on) the heap at twice its size.
+ *
+ * @param croquette The small map.
+ * @param len Number of bytes in the Key to append.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the map is unchanged, Error string set).
+ */
+static int small_make_room(Croquette_s *croquette, size_t len) {
+  Small_Store_s *store = croquette->store;
+  size_t live = 0;
+  int i = 0;
+
+  if(store->keys_used + len + 1 <= store->keys_cap) {
+    return C_Success;
+  }
+
+  /* Entries and their Keys are both in insertion order, so packing can move Keys down in place */
+  for(i = 0; i < croquette->size; i++) {
+    Small_Entry_s *entry = &store->entries[i];
+    memmove(store->keys + live, store->keys + entry->key_off, entry->key_len + 1);
+    entry->key_off = (uint32_t)live;
+    live += entry->key_len + 1;
+  }
+  store->keys_used = live;
+  if(live + len + 1 <= store->keys_cap) {
+    return C_Success;
+  }
+
+  size_t keys_cap = store->keys_cap * 2 + len + 1;
+  char *keys = NULL;
+  if(store->keys == small_inline_keys(croquette)) {
+    keys = malloc(keys_cap);
+    if(keys != NULL) {
+      memcpy(keys, store->keys, store->keys_used);
+    }
+  }
+  else {
+    keys = realloc(store->keys, keys_cap);
+  }
+  if(keys == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  store->keys = keys;
+  store->keys_cap = keys_cap;
+  return C_Success;
+}
+
+/**
+ * @brief Moves every Entry into the configured Backend, which then replaces the small map for good
+ *
+ * The Backend starts at the configured capacity (its base_capacity from then on) and is
+ * reserved for n Keys.  On failure the Backend is released and the small map is left as it was.
+ *
+ * @param croquette The small map to upgrade.
+ * @param n Number of Keys the Backend must hold without resizing.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int small_upgrade(Croquette_s *croquette, int n) {
+  Small_Store_s *small = croquette->store;
+  int count = croquette->size;
+  int base_capacity = croquette->base_capacity;
+  int unpinned_base = croquette->unpinned_base;
+  int do_free = croquette->do_free;
+  int i = 0;
+
+  croquette->store = NULL;
+  croquette->size = 0;
+  croquette->backend = croquette->large_backend;
+  if(croquette->backend->init(croquette, croquette->large_capacity) == C_Success) {
+    croquette->base_capacity = croquette->capacity;
+    if(croquette->pinned) {
+      croquette->unpinned_base = croquette->capacity;
+    }
+    if(croquette->backend->reserve(croquette, n) == C_Success) {
+      for(i = 0; i < count; i++) {
+        Small_Entry_s *entry = &small->entries[i];
+        if(croquette->backend->insert(croquette, small->keys + entry->key_off, entry->key_len,
+                                      entry->hash, entry->value) == C_Error) {
+          break;
+        }
+      }
+    }
+    if(i == count && croquette->size == count) {
+      if(croquette->pinned) {
+        croquette->base_capacity = croquette->capacity;
+      }
+      if(small->keys != (char *)&small->entries[croquette->small_size]) {   // Heap arena
+        free(small->keys);
+      }
+      free(small);
+      return C_Success;
+    }
+
+    /* The Values still belong to the small map */
+    croquette->do_free = C_No_Free;
+    croquette->backend->clear(croquette);
+    croquette->do_free = do_free;
+    croquette->backend->destroy(croquette);
+  }
+
+  croquette->backend = &croquette_small_backend;
+  croquette->store = small;
+  croquette->size = count;
+  croquette->capacity = croquette->small_size;
+  croquette->base_capacity = base_capacity;
+  croquette->unpinned_base = unpinned_base;
+  return C_Error;
+}
+
+/**
+ * @brief Appends a Key known not to be in the Croquette, upgrading once small_size Keys are held
+ *
+ * @param croquette The Croquette to insert into.
+ * @param key Key bytes (copied).
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param value Value to store.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int small_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
+  if(croquette->size == croquette->small_size) {
+    if(small_upgrade(croquette, croquette->size + 1) == C_Error) {
+      return C_Error;
+    }
+    return croquette->backend->insert(croquette, key, len, hash, value);
+  }
+  if(small_make_room(croquette, len) == C_Error) {
+    return C_Error;
+  }
+
+  Small_Store_s *store = croquette->store;
+  Small_Entry_s *entry = &store->entries[croquette->size];
+  entry->hash = hash;
+  entry->value = value;
+  entry->key_off = (uint32_t)store->keys_used;
+  entry->key_len = (uint32_t)len;
+  memcpy(store->keys + store->keys_used, key, len);
+  store->keys[store->keys_used + len] = '\0';
+  store->keys_used += len + 1;
+  croquette->size++;
+  return C_Success;
+}
+
+/**
+ * @brief Removes a Key, shifting the later Entries down to keep the order
+ *
+ * @param croquette The Croquette to remove from.
+ * @param key Key bytes to remove.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return C_Success (removing a missing Key is not an error)
+ */
+static int small_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Small_Store_s *store = croquette->store;
+  int index = small_lookup(croquette, key, len, hash);
+  if(index < 0) {
+    return C_Success;
+  }
+
+  Small_Entry_s *entry = &store->entries[index];
+  if(croquette->do_free == C_Do_Free) {
+    croquette->free_value(entry->value);
+  }
+  memmove(entry, entry + 1, (croquette->size - index - 1) * sizeof(Small_Entry_s));
+  croquette->size--;
+  if(croquette->size == 0) {
+    store->keys_used = 0;
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Clears the small map (keeping any heap Key arena for reuse)
+ *
+ * @param croquette The Croquette to clear.
+ * @return C_Success
+ */
+static int small_clear(Croquette_s *croquette) {
+  Small_Store_s *store = croquette->store;
+  int i = 0;
+  for(i = 0; croquette->do_free == C_Do_Free && i < croquette->size; i++) {
+    croquette->free_value(store->entries[i].value);
+  }
+  croquette->size = 0;
+  store->keys_used = 0;
+  return C_Success;
+}
+
+/**
+ * @brief Prints all Keys (and their positions) in insertion order
+ *
+ * @param croquette The Croquette to print.
+ */
+static void small_print_keys(Croquette_s *croquette) {
+  Small_Store_s *store = croquette->store;
+  int i = 0;
+  for(i = 0; i < croquette->size; i++) {
+    printf("[%2d] %s\n", i, store->keys + store->entries[i].key_off);
+  }
+}
+
+/**
+ * @brief Upgrades to the configured Backend (reserved for n Keys) if n Keys would not fit
+ *
+ * @param croquette The Croquette to grow.
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int small_reserve(Croquette_s *croquette, int n) {
+  if(n <= croquette->small_size) {
+    return C_Success;
+  }
+  return small_upgrade(croquette, n);
+}
+
+/**
+ * @brief A small map is always at its fixed size; there is nothing to shrink
+ *
+ * @return C_Success
+ */
+static int small_shrink_to_fit(Croquette_s *croquette) {
+  return C_Success;
+}
+
+/**
+ * @brief Visits every Entry in insertion order
+ *
+ * @param croquette The Croquette to visit.
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return The first non-zero result of visit, or 0
+ */
+static int small_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg) {
+  Small_Store_s *store = croquette->store;
+  int stop = 0;
+  int i = 0;
+  for(i = 0; i < croquette->size; i++) {
+    Small_Entry_s *entry = &store->entries[i];
+    if((stop = visit(store->keys + entry->key_off, entry->key_len, entry->value, arg)) != 0) {
+      return stop;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,714 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_splitorder.c
+ * @brief Split-Ordered List Backend for Croquette (Shalev and Shavit), lock-free throughout
+ * - Every Entry lives in one sorted lock-free linked list (Harris and Michael), ordered by the
+ *   bit reversed hash, so the Entries of any bucket are contiguous whatever the bucket count.
+ * - A bucket is a shortcut into the list: a sentinel node inserted, on first use, after the
+ *   sentinel of its parent bucket (the bucket with the top bit of its number cleared).
+ * - Growing only doubles the bucket count; no Entry moves, so no operation ever waits on a resize.
+ *   Buckets are never removed, so the table never shrinks.
+ * - Removal marks a node's next link (the logical removal), then unlinks it; nodes and replaced
+ *   Values (with do_free) are retired to epoch based reclamation, and freed in batches.
+ * - Callers hold an epoch (croquette.c does this in place of the lock) around every operation.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croquette_internal.h"
+
+// Split-Ordered Sizes
+#define SO_MAX_LOAD 2                   // Keys per bucket on average before the buckets double
+#define SO_NUM_SEGMENTS 31              // Bucket segments: segment s > 0 holds buckets [2^(s-1), 2^s)
+#define SO_MAX_BUCKETS (1 << (SO_NUM_SEGMENTS - 1))
+#define SO_COLLECT_MIN 128              // Retired blocks held before the first collection is tried
+#define SO_MARK ((uintptr_t)1)          // Low bit of a next link: this node is logically removed
+#define SO_TOP ((uint64_t)1 << 63)      // Set before reversing an Entry's hash, so its key is odd
+
+/**
+ * @enum SO_Retire_e
+ *
+ * @brief What a retired block is
+ */
+typedef enum so_retire {
+  SO_Retire_Node,                 ///< A removed node (its Value is freed too if do_free).
+  SO_Retire_Value                 ///< A Value replaced by an update (do_free).
+} SO_Retire_e;
+
+/**
+ * @struct SO_Retired_s
+ *
+ * @brief A block on the retired stack, waiting for every reader that might hold it to exit
+ */
+typedef struct so_retired {
+  struct so_retired *next;        ///< Next retired block.
+  uint64_t epoch;                 ///< Epoch it was retired in.
+  void *block;                    ///< The node or Value.
+  SO_Retire_e kind;               ///< What block is.
+} SO_Retired_s;
+
+/**
+ * @struct SO_Node_s
+ *
+ * @brief A node of the split-ordered list: an Entry, or the sentinel of a bucket
+ */
+typedef struct so_node {
+  uintptr_t next;                 ///< Next node in split order, | SO_MARK once logically removed.
+  uint64_t so_key;                ///< Bit reversed hash: odd for Entries, even for sentinels.
+  uint64_t hash;                  ///< Full hash of the Key (the bucket number for a sentinel).
+  void *value;                    ///< Value for Croquette to Store.
+  SO_Retired_s retired;           ///< Retired stack link, used once the node is unlinked.
+  size_t key_len;                 ///< Number of bytes in the Key (0 for a sentinel).
+  char key[];                     ///< Key (NUL terminated copy).
+} SO_Node_s;
+
+/**
+ * @struct SO_Store_s
+ *
+ * @brief State of the Split-Ordered table (size and capacity live in Croquette_s, updated atomically)
+ */
+typedef struct so_store {
+  SO_Node_s **segments[SO_NUM_SEGMENTS];  ///< Bucket sentinels, a segment allocated on first use.
+  SO_Retired_s *retired;                  ///< Retired blocks (lock-free stack).
+  int retired_count;                      ///< Number of retired blocks.
+  int collect_at;                         ///< retired_count at which the next collection is tried.
+} SO_Store_s;
+
+// Split-Ordered Prototypes
+static int so_init(Croquette_s *croquette, int capacity);
+static void so_destroy(Croquette_s *croquette);
+static void **so_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void **so_find_value(Croquette_s *croquette, const void *value);
+static int so_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static int so_put(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value,
+                  int only_if_absent, void **existing);
+static int so_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int so_clear(Croquette_s *croquette);
+static void so_print_keys(Croquette_s *croquette);
+static int so_reserve(Croquette_s *croquette, int n);
+static int so_shrink_to_fit(Croquette_s *croquette);
+static int so_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+static int so_search(Croquette_s *croquette, SO_Node_s *start, uint64_t so_key, const char *key, size_t len,
+                     uintptr_t **prev_out, SO_Node_s **curr_out);
+static SO_Node_s *so_bucket(Croquette_s *croquette, uint64_t bucket);
+static SO_Node_s *so_node_create(const char *key, size_t len, uint64_t so_key, uint64_t hash, void *value);
+static void so_retire(Croquette_s *croquette, SO_Retired_s *retired, void *block, SO_Retire_e kind);
+static void so_collect(Croquette_s *croquette);
+static void so_release(Croquette_s *croquette, SO_Retired_s *retired);
+static int so_buckets_for(long n);
+static inline uint64_t so_reverse(uint64_t bits);
+
+// Split-Ordered Backend
+const Croquette_Backend_s croquette_splitorder_backend = {
+  .name = "split-ordered",
+  .non_blocking = 1,
+  .init = so_init,
+  .destroy = so_destroy,
+  .find = so_find,
+  .find_value = so_find_value,
+  .insert = so_insert,
+  .put = so_put,
+  .remove = so_remove,
+  .clear = so_clear,
+  .print_keys = so_print_keys,
+  .reserve = so_reserve,
+  .shrink_to_fit = so_shrink_to_fit,
+  .foreach = so_foreach
+};
+
+/**
+ * @brief Reverses the bits of a 64 bit word
+ *
+ * @param bits The word to reverse.
+ * @return bits with bit 0 swapped for bit 63, bit 1 for bit 62, ...
+ */
+static inline uint64_t so_reverse(uint64_t bits) {
+  bits = ((bits >> 1) & 0x5555555555555555ull) | ((bits & 0x5555555555555555ull) << 1);
+  bits = ((bits >> 2) & 0x3333333333333333ull) | ((bits & 0x3333333333333333ull) << 2);
+  bits = ((bits >> 4) & 0x0f0f0f0f0f0f0f0full) | ((bits & 0x0f0f0f0f0f0f0f0full) << 4);
+  return __builtin_bswap64(bits);
+}
+
+/**
+ * @brief Gets the Power of Two bucket count that holds n Keys within SO_MAX_LOAD
+ *
+ * @param n Number of Keys.
+ * @return Bucket count (at least 1, at most SO_MAX_BUCKETS)
+ */
+static int so_buckets_for(long n) {
+  int buckets = 1;
+  while(buckets < SO_MAX_BUCKETS && (long)buckets * SO_MAX_LOAD < n) {
+    buckets <<= 1;
+  }
+  return buckets;
+}
+
+/**
+ * @brief Creates the list with the sentinel of bucket 0 (the head of the list)
+ *
+ * @param croquette The Croquette being created.
+ * @param capacity Initial bucket count (rounded up to a Power of Two).
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int so_init(Croquette_s *croquette, int capacity) {
+  SO_Store_s *store = calloc(1, sizeof(SO_Store_s));
+  SO_Node_s **segment = calloc(1, sizeof(SO_Node_s *));
+  SO_Node_s *head = so_node_create(NULL, 0, 0, 0, NULL);
+  if(store == NULL || segment == NULL || head == NULL) {
+    free(store);
+    free(segment);
+    free(head);
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  segment[0] = head;
+  store->segments[0] = segment;
+  store->collect_at = SO_COLLECT_MIN;
+  croquette->store = store;
+  croquette->capacity = so_buckets_for((long)capacity * SO_MAX_LOAD);
+  return C_Success;
+}
+
+/**
+ * @brief Frees every node, retired block and bucket segment (no other thread may be using the Croquette)
+ *
+ * @param croquette The Croquette being deleted.
+ */
+static void so_destroy(Croquette_s *croquette) {
+  SO_Store_s *store = croquette->store;
+  SO_Node_s *node = store->segments[0][0];
+  SO_Node_s *next = NULL;
+  SO_Retired_s *retired = NULL;
+  int s = 0;
+
+  /* Nodes still linked (including any marked but not yet unlinked) belong to the list */
+  while(node != NULL) {
+    next = (SO_Node_s *)(node->next & ~SO_MARK);
+    if(node->key_len > 0 && croquette->do_free == C_Do_Free) {
+      croquette->free_value(node->value);
+    }
+    free(node);
+    node = next;
+  }
+  while(store->retired != NULL) {
+    retired = store->retired;
+    store->retired = retired->next;
+    so_release(croquette, retired);
+  }
+  for(s = 0; s < SO_NUM_SEGMENTS; s++) {
+    free(store->segments[s]);
+  }
+  free(store);
+  croquette->store = NULL;
+}
+
+/**
+ * @brief Allocates a node with its Key copied in
+ *
+ * @param key Key bytes (NULL for a sentinel).
+ * @param len Number of bytes in the key.
+ * @param so_key Split-order key of the node.
+ * @param hash Hash of the Key, or the bucket number of a sentinel.
+ * @param value Value for the Entry.
+ * @return The node on Success
+ * @return NULL if out of memory
+ */
+static SO_Node_s *so_node_create(const char *key, size_t len, uint64_t so_key, uint64_t hash, void *value) {
+  SO_Node_s *node = malloc(sizeof(SO_Node_s) + len + 1);
+  if(node == NULL) {
+    return NULL;
+  }
+  node->next = 0;
+  node->so_key = so_key;
+  node->hash = hash;
+  node->value = value;
+  node->key_len = len;
+  if(len > 0) {
+    memcpy(node->key, key, len);
+  }
+  node->key[len] = '\0';
+  return node;
+}
+
+/**
+ * @brief Searches the list from a sentinel for a node, unlinking marked nodes on the way
+ *
+ * Stops at the first node ordered after so_key.  Entries that share a split-order key (equal
+ * hashes but for the top bit) are compared by Key; new Entries go after all of them.
+ * Whoever unlinks a marked node retires it, so each removed node is retired exactly once.
+ *
+ * @param croquette The Croquette to search.
+ * @param start The sentinel to start from (ordered before so_key).
+ * @param so_key Split-order key to find.
+ * @param key Key bytes to find (NULL to find a sentinel).
+ * @param len Number of bytes in the key.
+ * @param prev_out Set to the link that points at curr_out (where a new node would be linked).
+ * @param curr_out Set to the node found, or the first node after it (NULL at the end).
+ * @return 1 if found
+ * @return 0 if not found
+ */
+static int so_search(Croquette_s *croquette, SO_Node_s *start, uint64_t so_key, const char *key, size_t len,
+                     uintptr_t **prev_out, SO_Node_s **curr_out) {
+  uintptr_t *prev = NULL;
+  SO_Node_s *curr = NULL;
+  uintptr_t succ = 0;
+  uintptr_t expected = 0;
+  int restart = 1;
+
+  while(restart) {
+    restart = 0;
+    prev = &start->next;
+    curr = (SO_Node_s *)__atomic_load_n(prev, __ATOMIC_ACQUIRE);
+    while(curr != NULL) {
+      succ = __atomic_load_n(&curr->next, __ATOMIC_ACQUIRE);
+      /* Help finish a removal; if prev changed meanwhile, start over from the sentinel */
+      if(succ & SO_MARK) {
+        expected = (uintptr_t)curr;
+        if(!__atomic_compare_exchange_n(prev, &expected, succ & ~SO_MARK, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+          restart = 1;
+          break;
+        }
+        so_retire(croquette, &curr->retired, curr, SO_Retire_Node);
+        curr = (SO_Node_s *)(succ & ~SO_MARK);
+        continue;
+      }
+      if(curr->so_key > so_key) {
+        break;
+      }
+      if(curr->so_key == so_key &&
+         (key == NULL || croquette_key_equal(croquette, curr->key, curr->key_len, key, len))) {
+        *prev_out = prev;
+        *curr_out = curr;
+        return 1;
+      }
+      prev = &curr->next;
+      curr = (SO_Node_s *)succ;
+    }
+  }
+  *prev_out = prev;
+  *curr_out = curr;
+  return 0;
+}
+
+/**
+ * @brief Gets the sentinel of a bucket, inserting it (and its parents) on first use
+ *
+ * If memory runs out the nearest initialized parent is returned instead: searching from any
+ * earlier sentinel is still correct, only longer.
+ *
+ * @param croquette The Croquette.
+ * @param bucket The bucket number (under the bucket count).
+ * @return The sentinel to search from
+ */
+static SO_Node_s *so_bucket(Croquette_s *croquette, uint64_t bucket) {
+  SO_Store_s *store = croquette->store;
+  int s = (bucket == 0) ? 0 : 64 - __builtin_clzll(bucket);
+  uint64_t offset = (s == 0) ? 0 : bucket - ((uint64_t)1 << (s - 1));
+
+  SO_Node_s **segment = __atomic_load_n(&store->segments[s], __ATOMIC_ACQUIRE);
+  if(segment == NULL) {
+    SO_Node_s **fresh = calloc((size_t)1 << (s - 1), sizeof(SO_Node_s *));
+    if(fresh == NULL) {
+      return so_bucket(croquette, bucket ^ ((uint64_t)1 << (s - 1)));
+    }
+    segment = NULL;
+    if(__atomic_compare_exchange_n(&store->segments[s], &segment, fresh, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      segment = fresh;
+    }
+    else {
+      free(fresh);
+    }
+  }
+  SO_Node_s *sentinel = __atomic_load_n(&segment[offset], __ATOMIC_ACQUIRE);
+  if(sentinel != NULL) {
+    return sentinel;
+  }
+
+  /* Link a sentinel after the parent's; a racing thread may link the same one first */
+  SO_Node_s *parent = so_bucket(croquette, bucket ^ ((uint64_t)1 << (s - 1)));
+  SO_Node_s *fresh = so_node_create(NULL, 0, so_reverse(bucket), bucket, NULL);
+  uintptr_t *prev = NULL;
+  SO_Node_s *curr = NULL;
+  if(fresh == NULL) {
+    return parent;
+  }
+  uintptr_t expected = 0;
+  while(1) {
+    if(so_search(croquette, parent, fresh->so_key, NULL, 0, &prev, &curr)) {
+      free(fresh);
+      sentinel = curr;
+      break;
+    }
+    fresh->next = expected = (uintptr_t)curr;
+    if(__atomic_compare_exchange_n(prev, &expected, (uintptr_t)fresh, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+      sentinel = fresh;
+      break;
+    }
+  }
+  __atomic_store_n(&segment[offset], sentinel, __ATOMIC_RELEASE);
+  return sentinel;
+}
+
+/**
+ * @brief Finds the Value slot for a Key
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key (from hash_code()).
+ * @return Address of the Entry's Value if Key Exists (valid until the caller's epoch ends)
+ * @return NULL if No Such Key
+ */
+static void **so_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  int buckets = __atomic_load_n(&croquette->capacity, __ATOMIC_ACQUIRE);
+  SO_Node_s *start = so_bucket(croquette, hash & (uint64_t)(buckets - 1));
+  uintptr_t *prev = NULL;
+  SO_Node_s *curr = NULL;
+  if(so_search(croquette, start, so_reverse(hash | SO_TOP), key, len, &prev, &curr)) {
+    return &curr->value;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Finds the Value slot of any Entry holding a matching Value (a walk of the whole list)
+ *
+ * @param croquette The Croquette to search.
+ * @param value Value to compare against.
+ * @return Address of the Entry's Value if Value Exists
+ * @return NULL if No Such Value
+ */
+static void **so_find_value(Croquette_s *croquette, const void *value) {
+  SO_Store_s *store = croquette->store;
+  SO_Node_s *node = store->segments[0][0];
+  uintptr_t next = 0;
+  while(node != NULL) {
+    next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    if(node->key_len > 0 && !(next & SO_MARK) &&
+       croquette->value_compare(__atomic_load_n(&node->value, __ATOMIC_ACQUIRE), value) == 0) {
+      return &node->value;
+    }
+    node = (SO_Node_s *)(next & ~SO_MARK);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Inserts a Key known to be absent (croquette.c puts through so_put() instead)
+ *
+ * @return C_Success or C_Error (Error string set)
+ */
+static int so_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
+  return so_put(croquette, key, len, hash, value, 1, NULL);
+}
+
+/**
+ * @brief Inserts a Key, or updates (or with only_if_absent, reports) the Value of an existing one
+ *
+ * An insert is one compare-and-swap of the link before its place in the list; an update is a
+ * compare-and-swap of the Value.  A Value replaced with do_free is retired, not freed, as other
+ * threads may be comparing against it.  An insert that takes the load past SO_MAX_LOAD doubles
+ * the bucket count; the new buckets are filled in as they are first used.
+ *
+ * @param croquette The Croquette.
+ * @param key Key bytes.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key (from hash_code()).
+ * @param value Value to put.
+ * @param only_if_absent Boolean: leave an existing Value as it is.
+ * @param existing If not NULL, set to the existing Value (NULL if the Key was inserted).
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int so_put(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value,
+                  int only_if_absent, void **existing) {
+  int buckets = __atomic_load_n(&croquette->capacity, __ATOMIC_ACQUIRE);
+  SO_Node_s *start = so_bucket(croquette, hash & (uint64_t)(buckets - 1));
+  uint64_t so_key = so_reverse(hash | SO_TOP);
+  SO_Node_s *fresh = NULL;
+  SO_Retired_s *retired = NULL;
+  uintptr_t *prev = NULL;
+  SO_Node_s *curr = NULL;
+  uintptr_t expected = 0;
+  void *old = NULL;
+
+  if(existing != NULL) {
+    *existing = NULL;
+  }
+  while(1) {
+    if(so_search(croquette, start, so_key, key, len, &prev, &curr)) {
+      free(fresh);
+      old = __atomic_load_n(&curr->value, __ATOMIC_ACQUIRE);
+      if(only_if_absent) {
+        if(existing != NULL) {
+          *existing = old;
+        }
+        return C_Success;
+      }
+      if(croquette->value_compare(old, value) == 0) {
+        return C_Success;
+      }
+      if(croquette->do_free == C_Do_Free && (retired = malloc(sizeof(SO_Retired_s))) == NULL) {
+        croquette_set_error(C_Insufficient_Memory);
+        return C_Error;
+      }
+      while(!__atomic_compare_exchange_n(&curr->value, &old, value, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      }
+      if(retired != NULL) {
+        so_retire(croquette, retired, old, SO_Retire_Value);
+        so_collect(croquette);
+      }
+      return C_Success;
+    }
+    if(fresh == NULL && (fresh = so_node_create(key, len, so_key, hash, value)) == NULL) {
+      croquette_set_error(C_Insufficient_Memory);
+      return C_Error;
+    }
+    fresh->next = expected = (uintptr_t)curr;
+    if(__atomic_compare_exchange_n(prev, &expected, (uintptr_t)fresh, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+      break;
+    }
+  }
+
+  int size = __atomic_add_fetch(&croquette->size, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&croquette->inserts, 1, __ATOMIC_RELAXED);
+  if((long)size > (long)buckets * SO_MAX_LOAD && buckets < SO_MAX_BUCKETS) {
+    __atomic_compare_exchange_n(&croquette->capacity, &buckets, buckets << 1, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Removes a Key if present: marks its node, then unlinks it (or leaves that to the next search)
+ *
+ * @param croquette The Croquette.
+ * @param key Key bytes to remove.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key (from hash_code()).
+ * @return C_Success (removed, or no such Key)
+ */
+static int so_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  int buckets = __atomic_load_n(&croquette->capacity, __ATOMIC_ACQUIRE);
+  SO_Node_s *start = so_bucket(croquette, hash & (uint64_t)(buckets - 1));
+  uint64_t so_key = so_reverse(hash | SO_TOP);
+  uintptr_t *prev = NULL;
+  SO_Node_s *curr = NULL;
+  uintptr_t succ = 0;
+
+  while(1) {
+    if(!so_search(croquette, start, so_key, key, len, &prev, &curr)) {
+      return C_Success;
+    }
+    succ = __atomic_load_n(&curr->next, __ATOMIC_ACQUIRE);
+    if(!(succ & SO_MARK) &&
+       __atomic_compare_exchange_n(&curr->next, &succ, succ | SO_MARK, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      break;
+    }
+  }
+  __atomic_sub_fetch(&croquette->size, 1, __ATOMIC_RELAXED);
+
+  uintptr_t expected = (uintptr_t)curr;
+  if(__atomic_compare_exchange_n(prev, &expected, succ, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    so_retire(croquette, &curr->retired, curr, SO_Retire_Node);
+  }
+  else {
+    so_search(croquette, start, so_key, key, len, &prev, &curr);
+  }
+  so_collect(croquette);
+  return C_Success;
+}
+
+/**
+ * @brief Removes every Entry, one at a time (Entries put meanwhile by other threads may remain)
+ *
+ * Buckets are kept: the table never shrinks.
+ *
+ * @param croquette The Croquette to clear.
+ * @return C_Success
+ */
+static int so_clear(Croquette_s *croquette) {
+  SO_Store_s *store = croquette->store;
+  SO_Node_s *node = store->segments[0][0];
+  uintptr_t next = 0;
+  while(node != NULL) {
+    next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    if(node->key_len > 0 && !(next & SO_MARK)) {
+      so_remove(croquette, node->key, node->key_len, node->hash);
+    }
+    node = (SO_Node_s *)(next & ~SO_MARK);
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Prints every Key with its bucket, in split order
+ *
+ * @param croquette The Croquette to print.
+ */
+static void so_print_keys(Croquette_s *croquette) {
+  SO_Store_s *store = croquette->store;
+  SO_Node_s *node = store->segments[0][0];
+  uintptr_t next = 0;
+  int buckets = __atomic_load_n(&croquette->capacity, __ATOMIC_ACQUIRE);
+  while(node != NULL) {
+    next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    if(node->key_len > 0 && !(next & SO_MARK)) {
+      printf("[%2lu] %s\n", (unsigned long)(node->hash & (uint64_t)(buckets - 1)), node->key);
+    }
+    node = (SO_Node_s *)(next & ~SO_MARK);
+  }
+}
+
+/**
+ * @brief Raises the bucket count so n Keys fit within SO_MAX_LOAD (never lowers it)
+ *
+ * @param croquette The Croquette to grow.
+ * @param n Number of Keys to make room for.
+ * @return C_Success
+ */
+static int so_reserve(Croquette_s *croquette, int n) {
+  int target = so_buckets_for(n);
+  int buckets = __atomic_load_n(&croquette->capacity, __ATOMIC_ACQUIRE);
+  while(buckets < target &&
+        !__atomic_compare_exchange_n(&croquette->capacity, &buckets, target, 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Does nothing: sentinels are shortcuts other threads may be using, so buckets are never removed
+ *
+ * @return C_Success
+ */
+static int so_shrink_to_fit(Croquette_s *croquette) {
+  return C_Success;
+}
+
+/**
+ * @brief Visits every Entry in split order (Entries put or removed meanwhile may or may not be seen)
+ *
+ * @param croquette The Croquette to visit.
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return The first non-zero result of visit, or 0
+ */
+static int so_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg) {
+  SO_Store_s *store = croquette->store;
+  SO_Node_s *node = store->segments[0][0];
+  uintptr_t next = 0;
+  int stop = 0;
+  while(node != NULL) {
+    next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    if(node->key_len > 0 && !(next & SO_MARK) &&
+       (stop = visit(node->key, node->key_len, __atomic_load_n(&node->value, __ATOMIC_ACQUIRE), arg)) != 0) {
+      return stop;
+    }
+    node = (SO_Node_s *)(next & ~SO_MARK);
+  }
+  return 0;
+}
+
+/**
+ * @brief Pushes a block onto the retired stack, tagged with the current epoch
+ *
+ * @param croquette The Croquette the block came from.
+ * @param retired The stack link (inside a node, or allocated for a Value).
+ * @param block The node or Value.
+ * @param kind What block is.
+ */
+static void so_retire(Croquette_s *croquette, SO_Retired_s *retired, void *block, SO_Retire_e kind) {
+  SO_Store_s *store = croquette->store;
+  retired->block = block;
+  retired->kind = kind;
+  retired->epoch = croquette_epoch_current();
+  retired->next = __atomic_load_n(&store->retired, __ATOMIC_RELAXED);
+  while(!__atomic_compare_exchange_n(&store->retired, &retired->next, retired, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+  }
+  __atomic_add_fetch(&store->retired_count, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Frees the retired blocks no reader can still hold, once enough have built up
+ *
+ * The whole stack is taken in one exchange, so concurrent collectors work on disjoint batches;
+ * blocks still held are pushed back, and the next collection waits for the stack to double.
+ * The caller's own epoch holds the global epoch back by at most one step, which only delays it.
+ *
+ * @param croquette The Croquette owning the retired stack.
+ */
+static void so_collect(Croquette_s *croquette) {
+  SO_Store_s *store = croquette->store;
+  if(__atomic_load_n(&store->retired_count, __ATOMIC_RELAXED) < __atomic_load_n(&store->collect_at, __ATOMIC_RELAXED)) {
+    return;
+  }
+
+  croquette_epoch_advance();
+  uint64_t epoch = croquette_epoch_advance();
+  SO_Retired_s *batch = __atomic_exchange_n(&store->retired, NULL, __ATOMIC_ACQUIRE);
+  SO_Retired_s *kept = NULL;
+  SO_Retired_s *kept_tail = NULL;
+  SO_Retired_s *retired = NULL;
+  int freed = 0;
+  int held = 0;
+  while(batch != NULL) {
+    retired = batch;
+    batch = batch->next;
+    if(retired->epoch + 2 <= epoch) {
+      so_release(croquette, retired);
+      freed++;
+    }
+    else {
+      retired->next = kept;
+      kept_tail = (kept == NULL) ? retired : kept_tail;
+      kept = retired;
+      held++;
+    }
+  }
+  if(kept != NULL) {
+    kept_tail->next = __atomic_load_n(&store->retired, __ATOMIC_RELAXED);
+    while(!__atomic_compare_exchange_n(&store->retired, &kept_tail->next, kept, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+  }
+  __atomic_sub_fetch(&store->retired_count, freed, __ATOMIC_RELAXED);
+  __atomic_store_n(&store->collect_at, (held * 2 > SO_COLLECT_MIN) ? held * 2 : SO_COLLECT_MIN, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Frees a retired block according to its kind
+ *
+ * @param croquette The Croquette the block came from.
+ * @param retired The retired block.
+ */
+static void so_release(Croquette_s *croquette, SO_Retired_s *retired) {
+  if(retired->kind == SO_Retire_Node) {
+    SO_Node_s *node = retired->block;
+    if(croquette->do_free == C_Do_Free) {
+      croquette->free_value(node->value);
+    }
+    free(node);
+    return;
+  }
+  if(croquette->do_free == C_Do_Free) {
+    croquette->free_value(retired->block);
+  }
+  free(retired);
+}
@@ -0,0 +1,585 @@
+/*  Croquette: A non-floating point library providing a C implementation of a Dictionary.
+    Copyright (C) 2023 Kevin Andrea
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/** @file croquette_swiss.c
+ * @brief SwissTable style Open Addressing Backend for Croquette
+ * - A control byte per slot holds 7 bits of the hash (full), or the Empty or Deleted state.
+ * - Control bytes are scanned a group of 16 at a time: one SSE2 compare finds every slot in the
+ *   group whose tag matches, so most misses finish without reading a single Key.
+ * - Groups are probed triangularly; a group with an Empty slot ends the search.
+ * - Builds without SSE2 (or with CROQUETTE_NO_SIMD defined) use a portable scalar group scan.
+ * - Capacities are Powers of Two, at least one group, and grow past a 7/8 load.
+ *
+ * @author Kevin Andrea (kandrea)
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croquette_internal.h"
+
+#if defined(__SSE2__) && !defined(CROQUETTE_NO_SIMD)
+#include <emmintrin.h>
+#define SWISS_SSE2 1
+#endif
+
+// Control Bytes (full slots hold the 7-bit tag, 0..127)
+#define SWISS_EMPTY ((int8_t)-128)    // 0b10000000
+#define SWISS_DELETED ((int8_t)-2)    // 0b11111110
+#define SWISS_GROUP 16                // Slots scanned per group
+
+/**
+ * @struct Swiss_Slot_s
+ *
+ * @brief One slot of the SwissTable (32 bytes on LP64); only read after a tag match
+ */
+typedef struct swiss_slot {
+  uint64_t hash;          ///< Cached full hash of the Key (resizes never rehash).
+  char *key;              ///< Key for Croquette (NUL terminated copy).
+  void *value;            ///< Value for Croquette to Store.
+  size_t key_len;         ///< Number of bytes in the Key.
+} Swiss_Slot_s;
+
+/**
+ * @struct Swiss_Store_s
+ *
+ * @brief State of the SwissTable
+ *
+ * ctrl has capacity + SWISS_GROUP bytes: the first group is mirrored after the end,
+ * so a group starting at any Index can be loaded without wrapping.
+ */
+typedef struct swiss_store {
+  int8_t *ctrl;           ///< Control bytes (tags, Empty, Deleted).
+  Swiss_Slot_s *slots;    ///< Entries, parallel to ctrl.
+  int deleted;            ///< Number of Deleted control bytes (tombstones).
+} Swiss_Store_s;
+
+// Internal Prototypes - (Private to this Source File Only)
+static int swiss_init(Croquette_s *croquette, int capacity);
+static void swiss_destroy(Croquette_s *croquette);
+static void **swiss_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static void **swiss_find_value(Croquette_s *croquette, const void *value);
+static int swiss_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value);
+static int swiss_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static int swiss_clear(Croquette_s *croquette);
+static void swiss_print_keys(Croquette_s *croquette);
+static int swiss_reserve(Croquette_s *croquette, int n);
+static int swiss_shrink_to_fit(Croquette_s *croquette);
+static int swiss_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg);
+static int swiss_alloc_table(Swiss_Store_s *store, int capacity);
+static int swiss_resize(Croquette_s *croquette, int new_capacity);
+static long swiss_find_index(Croquette_s *croquette, const char *key, size_t len, uint64_t hash);
+static size_t swiss_find_free(const int8_t *ctrl, size_t mask, uint64_t hash);
+static inline void swiss_set_ctrl(int8_t *ctrl, size_t capacity, size_t index, int8_t tag);
+static inline int8_t swiss_tag(uint64_t hash);
+static inline uint32_t swiss_match(const int8_t *group, int8_t tag);
+static inline uint32_t swiss_match_free(const int8_t *group);
+
+// SwissTable Backend
+const Croquette_Backend_s croquette_swiss_backend = {
+  .name = "swiss",
+  .init = swiss_init,
+  .destroy = swiss_destroy,
+  .find = swiss_find,
+  .find_value = swiss_find_value,
+  .insert = swiss_insert,
+  .remove = swiss_remove,
+  .clear = swiss_clear,
+  .print_keys = swiss_print_keys,
+  .reserve = swiss_reserve,
+  .shrink_to_fit = swiss_shrink_to_fit,
+  .foreach = swiss_foreach
+};
+
+/**
+ * @brief Gets the 7-bit tag of a hash (its top bits; the low bits pick the group)
+ *
+ * @param hash The hash of the key.
+ * @return Control byte for a full slot (0..127)
+ */
+static inline int8_t swiss_tag(uint64_t hash) {
+  return (int8_t)(hash >> 57);
+}
+
+/**
+ * @brief Matches a tag against a group of control bytes
+ *
+ * @param group SWISS_GROUP control bytes.
+ * @param tag The control byte to look for.
+ * @return Bit mask with bit i set if group[i] == tag
+ */
+static inline uint32_t swiss_match(const int8_t *group, int8_t tag) {
+#ifdef SWISS_SSE2
+  __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+  return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl));
+#else
+  uint32_t mask = 0;
+  int i = 0;
+  for(i = 0; i < SWISS_GROUP; i++) {
+    mask |= (uint32_t)(group[i] == tag) << i;
+  }
+  return mask;
+#endif
+}
+
+/**
+ * @brief Matches the Empty and Deleted control bytes of a group (the ones with the high bit set)
+ *
+ * @param group SWISS_GROUP control bytes.
+ * @return Bit mask with bit i set if group[i] is Empty or Deleted
+ */
+static inline uint32_t swiss_match_free(const int8_t *group) {
+#ifdef SWISS_SSE2
+  return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+  uint32_t mask = 0;
+  int i = 0;
+  for(i = 0; i < SWISS_GROUP; i++) {
+    mask |= (uint32_t)(group[i] < 0) << i;
+  }
+  return mask;
+#endif
+}
+
+/**
+ * @brief Sets a control byte, keeping the mirrored first group in step
+ *
+ * @param ctrl The control bytes.
+ * @param capacity Number of slots.
+ * @param index Slot Index.
+ * @param tag New control byte.
+ */
+static inline void swiss_set_ctrl(int8_t *ctrl, size_t capacity, size_t index, int8_t tag) {
+  ctrl[index] = tag;
+  if(index < SWISS_GROUP) {
+    ctrl[capacity + index] = tag;
+  }
+}
+
+/**
+ * @brief Allocates empty control bytes and slots for capacity slots
+ *
+ * @param store The store to fill in.
+ * @param capacity Power of Two number of slots, at least SWISS_GROUP.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set, store unchanged).
+ */
+static int swiss_alloc_table(Swiss_Store_s *store, int capacity) {
+  int8_t *ctrl = malloc(capacity + SWISS_GROUP);
+  Swiss_Slot_s *slots = malloc(capacity * sizeof(Swiss_Slot_s));
+  if(ctrl == NULL || slots == NULL) {
+    free(ctrl);
+    free(slots);
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  memset(ctrl, SWISS_EMPTY, capacity + SWISS_GROUP);
+  store->ctrl = ctrl;
+  store->slots = slots;
+  store->deleted = 0;
+  return C_Success;
+}
+
+/**
+ * @brief Allocates an empty SwissTable, rounding the capacity up to a Power of Two (at least a group)
+ *
+ * @param croquette The Croquette being created.
+ * @param capacity Minimum number of slots.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int swiss_init(Croquette_s *croquette, int capacity) {
+  int rounded = SWISS_GROUP;
+  while(rounded < capacity && rounded < (1 << 30)) {
+    rounded <<= 1;
+  }
+
+  Swiss_Store_s *store = calloc(1, sizeof(Swiss_Store_s));
+  if(store == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  if(swiss_alloc_table(store, rounded) == C_Error) {
+    free(store);
+    return C_Error;
+  }
+  croquette->store = store;
+  croquette->capacity = rounded;
+  return C_Success;
+}
+
+/**
+ * @brief Frees the (empty) SwissTable
+ *
+ * @param croquette The Croquette being deleted.
+ */
+static void swiss_destroy(Croquette_s *croquette) {
+  Swiss_Store_s *store = croquette->store;
+  if(store == NULL) {
+    return;
+  }
+  free(store->ctrl);
+  free(store->slots);
+  free(store);
+  croquette->store = NULL;
+}
+
+/**
+ * @brief Finds the slot Index of a Key
+ *
+ * Keys are only compared in slots whose tag matches; the probe ends at the first
+ * group with an Empty slot, since an insert would have stopped there.
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Index of the slot if Key Exists
+ * @return -1 if No Such Key
+ */
+static long swiss_find_index(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  Swiss_Store_s *store = croquette->store;
+  size_t mask = (size_t)croquette->capacity - 1;
+  size_t pos = (size_t)hash & mask;
+  size_t stride = 0;
+  int8_t tag = swiss_tag(hash);
+  uint32_t matches = 0;
+  size_t index = 0;
+
+  for(;;) {
+    const int8_t *group = store->ctrl + pos;
+    for(matches = swiss_match(group, tag); matches != 0; matches &= matches - 1) {
+      index = (pos + __builtin_ctz(matches)) & mask;
+      Swiss_Slot_s *slot = &store->slots[index];
+      if(slot->hash == hash && croquette_key_equal(croquette, slot->key, slot->key_len, key, len)) {
+        return (long)index;
+      }
+    }
+    if(swiss_match(group, SWISS_EMPTY) != 0) {
+      return -1;
+    }
+    stride += SWISS_GROUP;
+    pos = (pos + stride) & mask;
+  }
+}
+
+/**
+ * @brief Finds the first Empty or Deleted slot on a hash's probe sequence
+ *
+ * @param ctrl The control bytes (the table must have a free slot).
+ * @param mask Capacity - 1.
+ * @param hash The hash of the key.
+ * @return Index of the free slot
+ */
+static size_t swiss_find_free(const int8_t *ctrl, size_t mask, uint64_t hash) {
+  size_t pos = (size_t)hash & mask;
+  size_t stride = 0;
+  uint32_t free_slots = 0;
+
+  for(;;) {
+    free_slots = swiss_match_free(ctrl + pos);
+    if(free_slots != 0) {
+      return (pos + __builtin_ctz(free_slots)) & mask;
+    }
+    stride += SWISS_GROUP;
+    pos = (pos + stride) & mask;
+  }
+}
+
+/**
+ * @brief Finds the Value slot for a Key
+ *
+ * @param croquette The Croquette to search.
+ * @param key Key bytes to find.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return Address of the Entry's Value if Key Exists
+ * @return NULL if No Such Key
+ */
+static void **swiss_find(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  long index = swiss_find_index(croquette, key, len, hash);
+  if(index < 0) {
+    return NULL;
+  }
+  return &((Swiss_Store_s *)croquette->store)->slots[index].value;
+}
+
+/**
+ * @brief Finds the Value slot of any Entry holding a matching Value
+ *
+ * @param croquette The Croquette to search.
+ * @param value Value to compare against.
+ * @return Address of the Entry's Value if Value Exists
+ * @return NULL if No Such Value
+ */
+static void **swiss_find_value(Croquette_s *croquette, const void *value) {
+  Swiss_Store_s *store = croquette->store;
+  int i = 0;
+  for(i = 0; i < croquette->capacity; i++) {
+    if(store->ctrl[i] >= 0 && croquette->value_compare(store->slots[i].value, value) == 0) {
+      return &store->slots[i].value;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Inserts a Key known not to be in the Croquette
+ *
+ * Grows past a 7/8 load (counting tombstones); if tombstones alone fill the table,
+ * it is rebuilt at the same capacity to reclaim them.
+ *
+ * @param croquette The Croquette to insert into.
+ * @param key Key bytes to add to the croquette.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @param value Generic value to put in to the croquette at the key.
+ * @return C_Success on Successful Add
+ * @return C_Error on Error (Error String Available)
+ */
+static int swiss_insert(Croquette_s *croquette, const char *key, size_t len, uint64_t hash, void *value) {
+  Swiss_Store_s *store = croquette->store;
+  long limit = (long)croquette->capacity - (croquette->capacity >> 3);
+
+  if(croquette->size + store->deleted + 1 > limit) {
+    int new_capacity = (croquette->size + 1 > (limit >> 1))?croquette->capacity << 1:croquette->capacity;
+    if(swiss_resize(croquette, new_capacity) == C_Error) {
+      return C_Error;
+    }
+    store = croquette->store;
+  }
+
+  char *copy = croquette_block_alloc(croquette, len + 1);
+  if(copy == NULL) {
+    croquette_set_error(C_Insufficient_Memory);
+    return C_Error;
+  }
+  memcpy(copy, key, len);
+  copy[len] = '\0';
+
+  size_t index = swiss_find_free(store->ctrl, (size_t)croquette->capacity - 1, hash);
+  if(store->ctrl[index] == SWISS_DELETED) {
+    store->deleted--;
+  }
+  swiss_set_ctrl(store->ctrl, croquette->capacity, index, swiss_tag(hash));
+  store->slots[index].hash = hash;
+  store->slots[index].key = copy;
+  store->slots[index].key_len = len;
+  store->slots[index].value = value;
+  croquette->size++;
+  return C_Success;
+}
+
+/**
+ * @brief Removes a Key if present
+ *
+ * The slot becomes Empty if no probe could have passed over it (its window of 16 slots
+ * was never full), otherwise it becomes Deleted so later probes continue past it.
+ *
+ * @param croquette The Croquette to remove from.
+ * @param key Key bytes to identify which entry to remove.
+ * @param len Number of bytes in the key.
+ * @param hash The hash of the key.
+ * @return C_Success on Successful Removal (or if no Entry was Present)
+ * @return C_Error on any Failure (Error string set).
+ */
+static int swiss_remove(Croquette_s *croquette, const char *key, size_t len, uint64_t hash) {
+  long found = swiss_find_index(croquette, key, len, hash);
+  if(found < 0) {
+    return C_Success;
+  }
+
+  Swiss_Store_s *store = croquette->store;
+  size_t mask = (size_t)croquette->capacity - 1;
+  size_t index = (size_t)found;
+  Swiss_Slot_s *slot = &store->slots[index];
+
+  if(croquette->do_free == C_Do_Free) {
+    croquette->free_value(slot->value);
+  }
+  croquette_block_free(croquette, slot->key, slot->key_len + 1);
+
+  /* Empty slots just before and after bound every group load that covers this slot */
+  uint32_t empty_after = swiss_match(store->ctrl + index, SWISS_EMPTY);
+  uint32_t empty_before = swiss_match(store->ctrl + ((index - SWISS_GROUP) & mask), SWISS_EMPTY);
+  int never_full = empty_before != 0 && empty_after != 0 &&
+                   (__builtin_ctz(empty_after) + __builtin_clz(empty_before << 16)) < SWISS_GROUP;
+  if(never_full) {
+    swiss_set_ctrl(store->ctrl, croquette->capacity, index, SWISS_EMPTY);
+  }
+  else {
+    swiss_set_ctrl(store->ctrl, croquette->capacity, index, SWISS_DELETED);
+    store->deleted++;
+  }
+  croquette->size--;
+
+  if(croquette->auto_shrink && croquette->capacity > croquette->base_capacity &&
+     croquette->size < (croquette->capacity >> 2)) {
+    return swiss_resize(croquette, croquette->capacity >> 1);
+  }
+  return C_Success;
+}
+
+/**
+ * @brief Moves every Entry into a new table of new_capacity slots (dropping tombstones)
+ *
+ * @param croquette The Croquette to resize.
+ * @param new_capacity Power of Two number of slots, at least SWISS_GROUP.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (the table is unchanged, Error string set).
+ */
+static int swiss_resize(Croquette_s *croquette, int new_capacity) {
+  Swiss_Store_s *store = croquette->store;
+  Swiss_Store_s fresh;
+  size_t index = 0;
+  int i = 0;
+
+  if(swiss_alloc_table(&fresh, new_capacity) == C_Error) {
+    return C_Error;
+  }
+  for(i = 0; i < croquette->capacity; i++) {
+    if(store->ctrl[i] >= 0) {
+      index = swiss_find_free(fresh.ctrl, (size_t)new_capacity - 1, store->slots[i].hash);
+      swiss_set_ctrl(fresh.ctrl, new_capacity, index, store->ctrl[i]);
+      fresh.slots[index] = store->slots[i];
+    }
+  }
+  free(store->ctrl);
+  free(store->slots);
+  *store = fresh;
+  croquette->capacity = new_capacity;
+  return C_Success;
+}
+
+/**
+ * @brief Clears the SwissTable and resets it to base_capacity
+ *
+ * @param croquette The Croquette to clear.
+ * @return C_Success on Success
+ * @return C_Error on any Failure (Error string set).
+ */
+static int swiss_clear(Croquette_s *croquette) {
+  Swiss_Store_s *store = croquette->store;
+  int i = 0;
+
+  /* With a Slab, Keys go a slab at once, so slots are only visited to free Values */
+  if(croquette->slab == NULL || croquette->do_free == C_Do_Free) {
+    for(i = 0; i < croquette->capacity; i++) {
+      if(store->ctrl[i] < 0) {
+        continue;
+      }
+      if(croquette->do_free == C_Do_Free) {
+        croquette->free_value(store->slots[i].value);
+      }
+      if(croquette->slab == NULL) {
+        free(store->slots[i].key);
+      }
+    }
+  }
+  croquette_slab_reset(croquette->slab);
+  croquette->size = 0;
+  memset(store->ctrl, SWISS_EMPTY, croquette->capacity + SWISS_GROUP);
+  store->deleted = 0;
+
+  /* Reset to Base Capacity */
+  if(croquette->capacity == croquette->base_capacity) {
+    return C_Success;
+  }
+  return swiss_resize(croquette, croquette->base_capacity);
+}
+
+/**
+ * @brief Prints all Keys (and their slot Indices) of the SwissTable
+ *
+ * @param croquette The Croquette to print.
+ */
+static void swiss_print_keys(Croquette_s *croquette) {
+  Swiss_Store_s *store = croquette->store;
+  int i = 0;
+  for(i = 0; i < croquette->capacity; i++) {
+    if(store->ctrl[i] >= 0) {
+      printf("[%2d] %s\n", i, store->slots[i].key);
+    }
+  }
+}
+
+/**
+ * @brief Doubles a Swiss capacity until n Keys stay within its 7/8 limit
+ *
+ * @return The capacity
+ */
+static int swiss_fit_capacity(int capacity, int n) {
+  while(n > capacity - (capacity >> 3) && capacity < (1 << 30)) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+/**
+ * @brief Doubles the Swiss table until n Keys stay within its 7/8 limit (one resize)
+ *
+ * @param croquette The Croquette to grow.
+ * @param n Number of Keys to make room for.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int swiss_reserve(Croquette_s *croquette, int n) {
+  int capacity = swiss_fit_capacity(croquette->capacity, n);
+  if(capacity == croquette->capacity) {
+    return C_Success;
+  }
+  return swiss_resize(croquette, capacity);
+}
+
+/**
+ * @brief Resizes the Swiss table to the smallest doubling of base_capacity within its 7/8 limit
+ *
+ * Rebuilding at the same capacity still drops the tombstones.
+ *
+ * @param croquette The Croquette to shrink.
+ * @return C_Success on Success
+ * @return C_Error if out of memory (Error string set).
+ */
+static int swiss_shrink_to_fit(Croquette_s *croquette) {
+  Swiss_Store_s *store = croquette->store;
+  int capacity = swiss_fit_capacity(croquette->base_capacity, croquette->size);
+  if(capacity > croquette->capacity || (capacity == croquette->capacity && store->deleted == 0)) {
+    return C_Success;
+  }
+  return swiss_resize(croquette, capacity);
+}
+
+/**
+ * @brief Visits every Entry of the SwissTable in slot order
+ *
+ * @param croquette The Croquette to visit.
+ * @param visit Function to call for each Entry.
+ * @param arg Passed through to visit.
+ * @return The first non-zero result of visit, or 0
+ */
+static int swiss_foreach(Croquette_s *croquette, Croquette_Visit_f visit, void *arg) {
+  Swiss_Store_s *store = croquette->store;
+  int stop = 0;
+  int i = 0;
+  for(i = 0; i < croquette->capacity; i++) {
+    if(store->ctrl[i] >= 0 &&
+       (stop = visit(store->slots[i].key, store->slots[i].key_len, store->slots[i].value, arg)) != 0) {
+      return stop;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,1291 @@
+/** @file croquette_bench.c
+ * @brief Benchmarks for the Croquette Library
+ * - Each benchmark is a function registered in the benchmarks[] table below.
+ * - Run all benchmarks with no arguments, or name the benchmarks to run.
+ *
+ * @author Kevin Andrea (kandrea)
+ * - Copyright Kevin Andrea - 2023
+ */
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "croquette.h"
+
+// Benchmark Data
+#define BENCH_KEY_LEN 64        // Buffer size for generated keys
+#define BENCH_NUM_KEYS 200000   // Number of keys for the table benchmarks
+#define BENCH_HASH_ROUNDS 20    // Passes over the key set when timing hashes
+#define BENCH_STRIDE 7919       // Prime step for visiting keys out of creation order
+
+typedef char Bench_Key_t[BENCH_KEY_LEN];
+
+// Every Backend, for the benchmarks comparing them
+static const Croquette_Backend_e bench_backend_kinds[] = {
+  C_Backend_Chained, C_Backend_RobinHood, C_Backend_Swiss, C_Backend_Cuckoo, C_Backend_Bucketized,
+  C_Backend_Compact
+};
+static const char *bench_backend_labels[] = {"chained", "robinhood", "swiss", "cuckoo", "bucketized", "compact"};
+
+// Benchmark Support Functions
+static double now_ns();
+static Bench_Key_t *make_url_keys(int count);
+static int compare_ptr(const void *value1, const void *value2);
+static long legacy_hash_code(const char *key);
+static int compare_double(const void *value1, const void *value2);
+static uint64_t flood_hash(const char *key, size_t len, uint64_t seed);
+static void bench_config_init(Croquette_Config_s *config);
+static Bench_Key_t *make_crafted_keys(int count, int bits);
+static long heap_in_use();
+static int visit_sum(const char *key, size_t len, void *value, void *arg);
+static void bench_table_ops(const char *label, const Croquette_Config_s *config, Bench_Key_t *keys, int count);
+
+// Benchmark Prototypes
+static void bench_hash();
+static void bench_capacity();
+static void bench_latency();
+static void bench_alloc();
+static void bench_backends();
+static void bench_cuckoo();
+static void bench_flood();
+static void bench_crafted();
+static void bench_memory();
+static void bench_iterate();
+static void bench_reload();
+static void bench_oscillate();
+static void bench_tiny();
+static void bench_readers();
+static void bench_segments();
+static void bench_readmostly();
+static void bench_nonblocking();
+
+/**
+ * @struct Benchmark_s
+ *
+ * @brief A named benchmark that can be selected from the command line.
+ */
+typedef struct benchmark {
+  const char *name;
+  void (*run)();
+} Benchmark_s;
+
+static const Benchmark_s benchmarks[] = {
+  {"hash", bench_hash},
+  {"capacity", bench_capacity},
+  {"latency", bench_latency},
+  {"alloc", bench_alloc},
+  {"backends", bench_backends},
+  {"cuckoo", bench_cuckoo},
+  {"flood", bench_flood},
+  {"crafted", bench_crafted},
+  {"memory", bench_memory},
+  {"iterate", bench_iterate},
+  {"reload", bench_reload},
+  {"oscillate", bench_oscillate},
+  {"tiny", bench_tiny},
+  {"readers", bench_readers},
+  {"segments", bench_segments},
+  {"readmostly", bench_readmostly},
+  {"nonblocking", bench_nonblocking},
+};
+
+/**
+ * @brief main Function to run the Benchmarks on Croquette
+ *
+ * @return EXIT_SUCCESS on successful execution.
+ */
+int main(int argc, char *argv[]) {
+  int num_benchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+  int i = 0;
+  int j = 0;
+
+  printf("Beginning Croquette Benchmarks...\n");
+  for(i = 0; i < num_benchmarks; i++) {
+    int selected = (argc < 2);
+    for(j = 1; j < argc; j++) {
+      selected |= !strcmp(argv[j], benchmarks[i].name);
+    }
+    if(selected) {
+      printf("[Bench] %s\n", benchmarks[i].name);
+      printf(".======================\n");
+      benchmarks[i].run();
+      printf("\\______________________\n\n");
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Reads the monotonic clock
+ *
+ * @return Current time in nanoseconds.
+ */
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Creates URL-like keys that share long prefixes and suffixes
+ * - Keys use dynamic memory, must be freed.
+ *
+ * @param count Number of keys to create.
+ * @return Array of count keys.
+ */
+static Bench_Key_t *make_url_keys(int count) {
+  Bench_Key_t *keys = calloc(count, sizeof(Bench_Key_t));
+  int i = 0;
+  for(i = 0; keys != NULL && i < count; i++) {
+    snprintf(keys[i], BENCH_KEY_LEN, "https://example.com/api/v1/item/%d/details.json", i);
+  }
+  return keys;
+}
+
+/**
+ * @brief Sets a Configuration to the Defaults with a fixed hash seed, so runs are reproducible
+ *
+ * @param config The Configuration to initialize.
+ */
+static void bench_config_init(Croquette_Config_s *config) {
+  croquette_config_init(config);
+  config->fixed_seed = 1;
+  config->seed = CROQUETTE_DEFAULT_SEED;
+}
+
+/**
+ * @brief Value comparison passed into Croquette; values are opaque pointers here.
+ *
+ * @return 0 if the pointers are equal, non-zero otherwise.
+ */
+static int compare_ptr(const void *value1, const void *value2) {
+  return value1 != value2;
+}
+
+/**
+ * @brief qsort() comparison for latency samples.
+ *
+ * @return <0, 0 or >0 as value1 is less than, equal to or greater than value2.
+ */
+static int compare_double(const void *value1, const void *value2) {
+  double d1 = *(const double *)value1;
+  double d2 = *(const double *)value2;
+  return (d1 > d2) - (d1 < d2);
+}
+
+/**
+ * @brief The original shift-add hash_code() from croquette.c, kept for comparison.
+ *
+ * @return The Hash Code from the Key
+ */
+static long legacy_hash_code(const char *key) {
+  long code = 0;
+  int i = 0;
+  int size = strlen(key);
+
+  for(i = 0; i < size; i++) {
+    code += key[i];
+    if(size == 1 || i < (size - 1)) {
+      code <<= 7;
+    }
+  }
+
+  return code;
+}
+
+/**
+ * @brief Times put, get (hits), get (misses) and remove over a key set for one configuration
+ *
+ * @param label Name to print for the configuration.
+ * @param config Configuration to create the table with (value_compare is set here).
+ * @param keys Keys to insert.
+ * @param count Number of keys.
+ */
+static void bench_table_ops(const char *label, const Croquette_Config_s *config, Bench_Key_t *keys, int count) {
+  Croquette_Config_s table_config = *config;
+  volatile uintptr_t sink = 0;
+  double put_ns = 0;
+  double get_ns = 0;
+  double miss_ns = 0;
+  double remove_ns = 0;
+  double start = 0;
+  int i = 0;
+
+  table_config.value_compare = compare_ptr;
+  croquette_t *table = croquette_new_config(&table_config);
+  if(table == NULL) {
+    printf("| %-12s could not be created\n", label);
+    return;
+  }
+
+  start = now_ns();
+  for(i = 0; i < count; i++) {
+    croquette_h_put(table, keys[i], keys[i]);
+  }
+  put_ns = (now_ns() - start) / count;
+  start = now_ns();
+  for(i = 0; i < count; i++) {
+    sink += (uintptr_t)croquette_h_get(table, keys[i]);
+  }
+  get_ns = (now_ns() - start) / count;
+  start = now_ns();
+  for(i = 0; i < count; i++) {
+    sink += (uintptr_t)croquette_h_get_n(table, keys[i], strlen(keys[i]) - 1);  // Distinct prefixes, never keys
+  }
+  miss_ns = (now_ns() - start) / count;
+  start = now_ns();
+  for(i = 0; i < count; i++) {
+    croquette_h_remove(table, keys[i]);
+  }
+  remove_ns = (now_ns() - start) / count;
+
+  printf("| %-12s put %8.2f  get %8.2f  miss %8.2f  remove %8.2f ns/op\n",
+         label, put_ns, get_ns, miss_ns, remove_ns);
+  croquette_delete(table);
+}
+
+/**
+ * @brief Prints the bucket distribution of a set of hash codes over a capacity
+ *
+ * @param label Name of the hash function.
+ * @param codes Hash codes of all keys.
+ * @param count Number of codes.
+ * @param capacity Number of buckets to distribute over.
+ */
+static void print_distribution(const char *label, const uint64_t *codes, int count, int capacity) {
+  int *chains = calloc(capacity, sizeof(int));
+  int i = 0;
+  int empty = 0;
+  int longest = 0;
+  double probes = 0;
+
+  if(chains == NULL) {
+    return;
+  }
+  for(i = 0; i < count; i++) {
+    chains[codes[i] % capacity]++;
+  }
+  for(i = 0; i < capacity; i++) {
+    empty += (chains[i] == 0);
+    longest = (chains[i] > longest)?chains[i]:longest;
+    probes += (double)chains[i] * (chains[i] + 1) / 2;  // Nodes visited to find every key
+  }
+  printf("| %-8s buckets used %6.2f%%, longest chain %6d, avg nodes per hit %8.2f\n",
+         label, 100.0 * (capacity - empty) / capacity, longest, probes / count);
+  free(chains);
+}
+
+/**
+ * @brief Compares the legacy hash_code() against croquette_hash()
+ * - Bucket distribution of URL-like keys at the capacity Croquette would grow to.
+ * - Hashing cost in ns/key.
+ * - End to end put/get cost in ns/op with croquette_hash() in the table.
+ */
+static void bench_hash() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  uint64_t *codes = calloc(BENCH_NUM_KEYS, sizeof(uint64_t));
+  volatile uint64_t sink = 0;
+  double start = 0;
+  int capacity = CROQUETTE_DEFAULT_INITIAL_SIZE;
+  int round = 0;
+  int i = 0;
+
+  if(keys == NULL || codes == NULL) {
+    free(keys);
+    free(codes);
+    return;
+  }
+
+  // Same growth rule as Croquette: double while size > 3/4 capacity
+  while(BENCH_NUM_KEYS > (capacity >> 1) + (capacity >> 2)) {
+    capacity <<= 1;
+  }
+  printf("| %d URL-like keys over %d buckets\n", BENCH_NUM_KEYS, capacity);
+
+  for(i = 0; i < BENCH_NUM_KEYS; i++) {
+    codes[i] = (uint64_t)legacy_hash_code(keys[i]);
+  }
+  print_distribution("legacy", codes, BENCH_NUM_KEYS, capacity);
+  for(i = 0; i < BENCH_NUM_KEYS; i++) {
+    codes[i] = croquette_hash(keys[i], strlen(keys[i]), CROQUETTE_DEFAULT_SEED);
+  }
+  print_distribution("wyhash", codes, BENCH_NUM_KEYS, capacity);
+
+  start = now_ns();
+  for(round = 0; round < BENCH_HASH_ROUNDS; round++) {
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      sink += legacy_hash_code(keys[i]);
+    }
+  }
+  printf("| %-8s %8.2f ns/key\n", "legacy", (now_ns() - start) / ((double)BENCH_HASH_ROUNDS * BENCH_NUM_KEYS));
+
+  start = now_ns();
+  for(round = 0; round < BENCH_HASH_ROUNDS; round++) {
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      sink += croquette_hash(keys[i], strlen(keys[i]), CROQUETTE_DEFAULT_SEED);
+    }
+  }
+  printf("| %-8s %8.2f ns/key\n", "wyhash", (now_ns() - start) / ((double)BENCH_HASH_ROUNDS * BENCH_NUM_KEYS));
+
+  croquette_t *table = croquette_new(C_Default_Capacity, C_No_Free, NULL, compare_ptr);
+  if(table != NULL) {
+    start = now_ns();
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      croquette_h_put(table, keys[i], keys[i]);
+    }
+    printf("| table put %8.2f ns/op\n", (now_ns() - start) / BENCH_NUM_KEYS);
+    start = now_ns();
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      sink += (uintptr_t)croquette_h_get(table, keys[i]);
+    }
+    printf("| table get %8.2f ns/op\n", (now_ns() - start) / BENCH_NUM_KEYS);
+    croquette_delete(table);
+  }
+
+  free(keys);
+  free(codes);
+}
+
+/**
+ * @brief Compares modulo indexing (exact capacities) against mask indexing (powers of two)
+ */
+static void bench_capacity() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Config_s config;
+
+  if(keys == NULL) {
+    return;
+  }
+
+  bench_config_init(&config);
+  config.capacity_mode = C_Capacity_Exact;
+  bench_table_ops("exact (mod)", &config, keys, BENCH_NUM_KEYS);
+  config.capacity_mode = C_Capacity_Pow2;
+  bench_table_ops("pow2 (mask)", &config, keys, BENCH_NUM_KEYS);
+
+  free(keys);
+}
+
+/**
+ * @brief Put latency percentiles with all-at-once and Incremental Rehash
+ * - Each put is timed individually; resizes show up in the tail (p99.9 and max).
+ */
+static void bench_latency() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  double *samples = calloc(BENCH_NUM_KEYS, sizeof(double));
+  int steps[] = {0, 1, 16};
+  Croquette_Config_s config;
+  double start = 0;
+  int s = 0;
+  int i = 0;
+
+  if(keys == NULL || samples == NULL) {
+    free(keys);
+    free(samples);
+    return;
+  }
+
+  for(s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+    bench_config_init(&config);
+    config.value_compare = compare_ptr;
+    config.rehash_step = steps[s];
+    croquette_t *table = croquette_new_config(&config);
+    if(table == NULL) {
+      continue;
+    }
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      start = now_ns();
+      croquette_h_put(table, keys[i], keys[i]);
+      samples[i] = now_ns() - start;
+    }
+    croquette_delete(table);
+
+    qsort(samples, BENCH_NUM_KEYS, sizeof(double), compare_double);
+    printf("| rehash_step %2d  put p50 %8.0f  p99 %8.0f  p99.9 %10.0f  max %10.0f ns\n", steps[s],
+           samples[BENCH_NUM_KEYS / 2], samples[(int)(BENCH_NUM_KEYS * 0.99)],
+           samples[(int)(BENCH_NUM_KEYS * 0.999)], samples[BENCH_NUM_KEYS - 1]);
+  }
+
+  free(keys);
+  free(samples);
+}
+
+/**
+ * @brief Compares malloc() Entries against the Slab Allocator
+ * - Table operations, then repeated fill and clear cycles (clear releases whole slabs).
+ */
+static void bench_alloc() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Allocator_e allocators[] = {C_Alloc_Malloc, C_Alloc_Slab};
+  const char *labels[] = {"malloc", "slab"};
+  Croquette_Config_s config;
+  double fill_ns = 0;
+  double clear_ns = 0;
+  double start = 0;
+  int a = 0;
+  int round = 0;
+  int i = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+
+  for(a = 0; a < sizeof(allocators) / sizeof(allocators[0]); a++) {
+    bench_config_init(&config);
+    config.allocator = allocators[a];
+    bench_table_ops(labels[a], &config, keys, BENCH_NUM_KEYS);
+  }
+
+  for(a = 0; a < sizeof(allocators) / sizeof(allocators[0]); a++) {
+    bench_config_init(&config);
+    config.value_compare = compare_ptr;
+    config.allocator = allocators[a];
+    croquette_t *table = croquette_new_config(&config);
+    if(table == NULL) {
+      continue;
+    }
+    fill_ns = 0;
+    clear_ns = 0;
+    for(round = 0; round < 5; round++) {
+      start = now_ns();
+      for(i = 0; i < BENCH_NUM_KEYS; i++) {
+        croquette_h_put(table, keys[i], keys[i]);
+      }
+      fill_ns += now_ns() - start;
+      start = now_ns();
+      croquette_h_clear(table);
+      clear_ns += now_ns() - start;
+    }
+    printf("| %-12s fill %8.2f ns/put  clear %8.2f ns/entry\n", labels[a],
+           fill_ns / (5.0 * BENCH_NUM_KEYS), clear_ns / (5.0 * BENCH_NUM_KEYS));
+    croquette_delete(table);
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Compares the table Backends behind the same API (default settings for each)
+ */
+static void bench_backends() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Config_s config;
+  int b = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+
+  for(b = 0; b < sizeof(bench_backend_kinds) / sizeof(bench_backend_kinds[0]); b++) {
+    bench_config_init(&config);
+    config.backend = bench_backend_kinds[b];
+    bench_table_ops(bench_backend_labels[b], &config, keys, BENCH_NUM_KEYS);
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Cuckoo load factor and insert failures
+ * - Fixed size tables are filled until the first insert has to resize (achieved load).
+ * - Then all keys go into a default table, reporting the final load and insert failure rate.
+ */
+static void bench_cuckoo() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  int capacities[] = {1024, 16384, 131072};
+  Croquette_Config_s config;
+  Croquette_Stats_s stats;
+  int c = 0;
+  int i = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+
+  bench_config_init(&config);
+  config.value_compare = compare_ptr;
+  config.backend = C_Backend_Cuckoo;
+  for(c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++) {
+    config.initial_capacity = capacities[c];
+    croquette_t *table = croquette_new_config(&config);
+    if(table == NULL) {
+      continue;
+    }
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      croquette_h_put(table, keys[i], keys[i]);
+      croquette_h_stats(table, &stats);
+      if(stats.insert_failures > 0) {
+        break;
+      }
+    }
+    printf("| %7d slots  first insert failure at key %7d  (load %3d.%d%%)\n", capacities[c], i,
+           (int)((long)i * 100 / capacities[c]), (int)((long)i * 1000 / capacities[c] % 10));
+    croquette_delete(table);
+  }
+
+  config.initial_capacity = C_Default_Capacity;
+  croquette_t *table = croquette_new_config(&config);
+  if(table != NULL) {
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      croquette_h_put(table, keys[i], keys[i]);
+    }
+    croquette_h_stats(table, &stats);
+    printf("| %d keys: capacity %d  load %d.%d%%  insert failures %ld (%ld per million inserts)\n",
+           stats.size, stats.capacity, stats.load_permille / 10, stats.load_permille % 10,
+           stats.insert_failures, stats.insert_failures * 1000000 / stats.inserts);
+    croquette_delete(table);
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Hash sending every key to the same Index (a worst case collision flood)
+ */
+static uint64_t flood_hash(const char *key, size_t len, uint64_t seed) {
+  return 0x5eed;
+}
+
+/**
+ * @brief Chained table operations when every key collides
+ * - Per-op cost grows with log(keys) once the chain is a Tree Bin (it grew linearly as a chain).
+ */
+static void bench_flood() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  int counts[] = {1000, 4000, 16000};
+  Croquette_Config_s config;
+  char label[32];
+  int c = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+
+  bench_config_init(&config);
+  config.hash_fn = flood_hash;
+  for(c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+    snprintf(label, sizeof(label), "%d keys", counts[c]);
+    bench_table_ops(label, &config, keys, counts[c]);
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Creates keys that share one Power of Two Index under croquette_hash() with CROQUETTE_DEFAULT_SEED
+ * - Found by brute force, as an attacker who knows the seed would (about 2^bits tries per key).
+ * - Matches the Power of Two Index, which folds the high half of the hash into the low bits.
+ * - Keys use dynamic memory, must be freed.
+ *
+ * @param count Number of keys to create.
+ * @param bits Number of Index bits every key shares (a table of 2^bits Indices).
+ * @return Array of count keys.
+ */
+static Bench_Key_t *make_crafted_keys(int count, int bits) {
+  Bench_Key_t *keys = calloc(count, sizeof(Bench_Key_t));
+  uint64_t mask = ((uint64_t)1 << bits) - 1;
+  unsigned long attempt = 0;
+  int found = 0;
+
+  while(keys != NULL && found < count) {
+    int len = snprintf(keys[found], BENCH_KEY_LEN, "user/%lu/session", attempt++);
+    uint64_t hash = croquette_hash(keys[found], len, CROQUETTE_DEFAULT_SEED);
+    if(((hash ^ (hash >> 32)) & mask) == 0) {
+      found++;
+    }
+  }
+  return keys;
+}
+
+/**
+ * @brief Table operations on keys crafted to collide under a known seed
+ * - With the seed the keys were crafted for, every key lands on one Index.
+ * - With a random seed per instance (the default), the same keys spread like any others.
+ */
+static void bench_crafted() {
+  int count = 2000;             // A Power of Two table holding 2000 keys has 4096 Indices
+  Bench_Key_t *crafted = make_crafted_keys(count, 12);
+  Bench_Key_t *plain = make_url_keys(count);
+  Croquette_Config_s config;
+
+  if(crafted != NULL && plain != NULL) {
+    bench_config_init(&config);
+    config.capacity_mode = C_Capacity_Pow2;
+    bench_table_ops("plain", &config, plain, count);
+    bench_table_ops("crafted", &config, crafted, count);
+    config.fixed_seed = 0;
+    bench_table_ops("crafted/rnd", &config, crafted, count);
+  }
+
+  free(crafted);
+  free(plain);
+}
+
+/**
+ * @brief Reads the bytes of heap currently allocated
+ *
+ * @return Bytes in use, or -1 if the C library cannot report it.
+ */
+static long heap_in_use() {
+#ifdef __GLIBC__
+  struct mallinfo2 info = mallinfo2();
+  return (long)(info.uordblks + info.hblkhd);
+#else
+  return -1;
+#endif
+}
+
+/**
+ * @brief Heap bytes per Key for each Backend (tables, Entries and Keys; Values are not allocated)
+ * - Short keys (8 characters) and the URL keys, both at the load reached after all inserts.
+ */
+static void bench_memory() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Bench_Key_t *short_keys = calloc(BENCH_NUM_KEYS, sizeof(Bench_Key_t));
+  Croquette_Config_s config;
+  long before = 0;
+  long bytes[2] = {0};
+  int b = 0;
+  int k = 0;
+  int i = 0;
+
+  if(keys != NULL && short_keys != NULL && heap_in_use() >= 0) {
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      snprintf(short_keys[i], BENCH_KEY_LEN, "k%07d", i);
+    }
+    for(b = 0; b < sizeof(bench_backend_kinds) / sizeof(bench_backend_kinds[0]); b++) {
+      for(k = 0; k < 2; k++) {
+        Bench_Key_t *set = (k == 0) ? short_keys : keys;
+        bench_config_init(&config);
+        config.value_compare = compare_ptr;
+        config.backend = bench_backend_kinds[b];
+        before = heap_in_use();
+        croquette_t *table = croquette_new_config(&config);
+        for(i = 0; table != NULL && i < BENCH_NUM_KEYS; i++) {
+          croquette_h_put(table, set[i], set[i]);
+        }
+        bytes[k] = heap_in_use() - before;
+        croquette_delete(table);
+      }
+      printf("| %-12s short keys %6.1f  url keys %6.1f bytes/key\n", bench_backend_labels[b],
+             (double)bytes[0] / BENCH_NUM_KEYS, (double)bytes[1] / BENCH_NUM_KEYS);
+    }
+  }
+  else {
+    printf("| heap usage is not available\n");
+  }
+
+  free(keys);
+  free(short_keys);
+}
+
+/**
+ * @brief Visitor for croquette_foreach(); adds up the Key lengths.
+ *
+ * @return 0 to visit every Entry.
+ */
+static int visit_sum(const char *key, size_t len, void *value, void *arg) {
+  *(size_t *)arg += len;
+  return 0;
+}
+
+/**
+ * @brief Full sweeps of each Backend: croquette_foreach() and a containsValue miss
+ * - The tables have grown to hold the keys and then lost half of them.
+ */
+static void bench_iterate() {
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Config_s config;
+  volatile size_t sink = 0;
+  size_t total = 0;
+  double foreach_ns = 0;
+  double scan_ns = 0;
+  double start = 0;
+  int b = 0;
+  int i = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+
+  for(b = 0; b < sizeof(bench_backend_kinds) / sizeof(bench_backend_kinds[0]); b++) {
+    bench_config_init(&config);
+    config.value_compare = compare_ptr;
+    config.backend = bench_backend_kinds[b];
+    croquette_t *table = croquette_new_config(&config);
+    if(table == NULL) {
+      continue;
+    }
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      croquette_h_put(table, keys[i], keys[i]);
+    }
+    for(i = 0; i < BENCH_NUM_KEYS; i += 2) {
+      croquette_h_remove(table, keys[i]);
+    }
+
+    start = now_ns();
+    for(i = 0; i < 10; i++) {
+      total = 0;
+      croquette_h_foreach(table, visit_sum, &total);
+      sink += total;
+    }
+    foreach_ns = (now_ns() - start) / (10.0 * croquette_h_size(table));
+    start = now_ns();
+    for(i = 0; i < 10; i++) {
+      sink += croquette_h_containsValue(table, &total);
+    }
+    scan_ns = (now_ns() - start) / (10.0 * croquette_h_size(table));
+
+    printf("| %-12s foreach %6.2f  containsValue %6.2f ns/entry\n", bench_backend_labels[b], foreach_ns, scan_ns);
+    croquette_delete(table);
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Nightly reloads (clear, then load every key) of each Backend: plain, reserved, and reserved + pinned
+ * - Resizes counts every capacity change over the first night and over each later night.
+ */
+static void bench_reload() {
+  const char *modes[] = {"plain", "reserve", "pinned"};
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Config_s config;
+  double start = 0;
+  double later_ns = 0;
+  int resizes[2] = {0};
+  int capacity = 0;
+  int night = 0;
+  int m = 0;
+  int b = 0;
+  int i = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+
+  for(b = 0; b < sizeof(bench_backend_kinds) / sizeof(bench_backend_kinds[0]); b++) {
+    for(m = 0; m < 3; m++) {
+      bench_config_init(&config);
+      config.value_compare = compare_ptr;
+      config.backend = bench_backend_kinds[b];
+      croquette_t *table = croquette_new_config(&config);
+      if(table == NULL) {
+        continue;
+      }
+      resizes[0] = resizes[1] = 0;
+      later_ns = 0;
+      for(night = 0; night < 4; night++) {
+        capacity = croquette_h_capacity(table);
+        start = now_ns();
+        croquette_h_clear(table);
+        resizes[night > 0] += (croquette_h_capacity(table) != capacity);
+        capacity = croquette_h_capacity(table);
+        if(m > 0) {
+          croquette_h_reserve(table, BENCH_NUM_KEYS);
+        }
+        if(m == 2) {
+          croquette_h_pin_capacity(table);
+        }
+        resizes[night > 0] += (croquette_h_capacity(table) != capacity);
+        for(i = 0; i < BENCH_NUM_KEYS; i++) {
+          capacity = croquette_h_capacity(table);
+          croquette_h_put(table, keys[i], keys[i]);
+          resizes[night > 0] += (croquette_h_capacity(table) != capacity);
+        }
+        later_ns += (night > 0) ? now_ns() - start : 0;
+      }
+      printf("| %-12s %-8s resizes first %2d  later %2d  reload %6.1f ns/key\n", bench_backend_labels[b],
+             modes[m], resizes[0], resizes[1] / 3, later_ns / (3.0 * BENCH_NUM_KEYS));
+      croquette_delete(table);
+    }
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Separate Chaining load swinging 8% either side of its growth threshold, per load factor setting
+ * - Each round inserts then removes 8% of the capacity around a 75% load; counts resizes and times it.
+ * - A narrow gap (75/35) halves on every dip and doubles on every rise; the default gap does not.
+ */
+static void bench_oscillate() {
+  const int max_loads[] = {75, 75, 90, 75};
+  const int min_loads[] = {35, 25, 40, 25};
+  const int shrinks[] = {1, 1, 1, 0};
+  const int base = 1 << 16;
+  const int level = base / 4 * 3;
+  const int swing = base / 100 * 8;
+  const int rounds = 50;
+  Bench_Key_t *keys = calloc(level + swing, sizeof(Bench_Key_t));
+  Croquette_Config_s config;
+  double start = 0;
+  int capacity = 0;
+  int resizes = 0;
+  int s = 0;
+  int r = 0;
+  int i = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+  for(i = 0; i < level + swing; i++) {
+    snprintf(keys[i], BENCH_KEY_LEN, "osc-%d", i);
+  }
+
+  for(s = 0; s < sizeof(max_loads) / sizeof(max_loads[0]); s++) {
+    bench_config_init(&config);
+    config.value_compare = compare_ptr;
+    config.initial_capacity = base;
+    config.capacity_mode = C_Capacity_Pow2;
+    config.max_load = max_loads[s];
+    config.min_load = min_loads[s];
+    config.auto_shrink = shrinks[s];
+    croquette_t *table = croquette_new_config(&config);
+    if(table == NULL) {
+      continue;
+    }
+    for(i = 0; i < level - swing; i++) {
+      croquette_h_put(table, keys[i], keys[i]);
+    }
+
+    resizes = 0;
+    start = now_ns();
+    for(r = 0; r < rounds; r++) {
+      for(i = level - swing; i < level + swing; i++) {
+        capacity = croquette_h_capacity(table);
+        croquette_h_put(table, keys[i], keys[i]);
+        resizes += (croquette_h_capacity(table) != capacity);
+      }
+      for(i = level - swing; i < level + swing; i++) {
+        capacity = croquette_h_capacity(table);
+        croquette_h_remove(table, keys[i]);
+        resizes += (croquette_h_capacity(table) != capacity);
+      }
+    }
+    printf("| max %2d%% min %2d%% %-9s resizes %4d  %7.1f ns/op\n", max_loads[s], min_loads[s],
+           shrinks[s] ? "" : "no shrink", resizes, (now_ns() - start) / (4.0 * rounds * swing));
+    croquette_delete(table);
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Lifetime of many tiny maps: create, put n keys, get each, delete; hashed table vs small map mode
+ * - The random seed column draws a fresh per-instance seed (one getrandom() call per map).
+ */
+static void bench_tiny() {
+  const int sizes[] = {4, 8, 15};
+  const int maps = 100000;
+  Bench_Key_t keys[16];
+  Croquette_Config_s config;
+  volatile long sink = 0;
+  double ns[2] = {0};
+  double start = 0;
+  int small = 0;
+  int seeded = 0;
+  int s = 0;
+  int m = 0;
+  int i = 0;
+
+  for(i = 0; i < 16; i++) {
+    snprintf(keys[i], BENCH_KEY_LEN, "field_%d", i);
+  }
+
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    for(small = 0; small < 2; small++) {
+      for(seeded = 0; seeded < 2; seeded++) {
+        bench_config_init(&config);
+        config.value_compare = compare_ptr;
+        config.small_size = small ? 16 : 0;
+        config.fixed_seed = !seeded;
+        start = now_ns();
+        for(m = 0; m < maps; m++) {
+          croquette_t *table = croquette_new_config(&config);
+          for(i = 0; i < sizes[s]; i++) {
+            croquette_h_put(table, keys[i], keys[i]);
+          }
+          for(i = 0; i < sizes[s]; i++) {
+            sink += (croquette_h_get(table, keys[i]) != NULL);
+          }
+          croquette_delete(table);
+        }
+        ns[seeded] = (now_ns() - start) / maps;
+      }
+      printf("| %2d keys %-7s %7.1f ns/map  (random seed %7.1f ns/map)\n", sizes[s], small ? "small" : "hashed",
+             ns[0], ns[1]);
+    }
+  }
+}
+
+/**
+ * @struct Reader_Work_s
+ *
+ * @brief Lookups for one bench_readers() thread
+ */
+typedef struct reader_work {
+  croquette_t *table;       ///< Croquette shared by every thread.
+  Bench_Key_t *keys;        ///< Keys to look up (all present).
+  int first;                ///< Key to start from, so threads spread over the table.
+  int lookups;              ///< Number of lookups to do.
+  long found;               ///< Keys found (result, keeps the lookups live).
+} Reader_Work_s;
+
+/**
+ * @brief Thread body for bench_readers(): looks up keys round robin from its first key
+ *
+ * @return NULL
+ */
+static void *reader_work(void *arg) {
+  Reader_Work_s *work = arg;
+  int k = work->first;
+  int i = 0;
+  for(i = 0; i < work->lookups; i++) {
+    work->found += (croquette_h_get(work->table, work->keys[k]) != NULL);
+    k = (k + 1 == BENCH_NUM_KEYS) ? 0 : k + 1;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Read throughput from 1 to 2x the online cores (at most 16 threads), without and with thread_safe
+ * - Every thread does the same number of lookups on one shared table; Mops/s is for all threads.
+ */
+static void bench_readers() {
+  const int lookups = 500000;
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Config_s config;
+  Reader_Work_s work[16];
+  pthread_t threads[16];
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  double start = 0;
+  double mops = 0;
+  double single = 0;
+  int locked = 0;
+  int count = 0;
+  int t = 0;
+  int i = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+  printf("| %ld online cores\n", cores);
+
+  for(locked = 0; locked < 2; locked++) {
+    bench_config_init(&config);
+    config.value_compare = compare_ptr;
+    config.thread_safe = locked;
+    croquette_t *table = croquette_new_config(&config);
+    if(table == NULL) {
+      continue;
+    }
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      croquette_h_put(table, keys[i], keys[i]);
+    }
+
+    for(count = 1; count <= 16 && count <= 2 * cores; count <<= 1) {
+      start = now_ns();
+      for(t = 0; t < count; t++) {
+        work[t].table = table;
+        work[t].keys = keys;
+        work[t].first = (int)((long)BENCH_NUM_KEYS * t / count);
+        work[t].lookups = lookups;
+        work[t].found = 0;
+        pthread_create(&threads[t], NULL, reader_work, &work[t]);
+      }
+      for(t = 0; t < count; t++) {
+        pthread_join(threads[t], NULL);
+      }
+      mops = (double)lookups * count / ((now_ns() - start) / 1e3);
+      single = (count == 1) ? mops : single;
+      printf("| %-9s %2d threads %7.2f Mops/s (%4.2fx)\n", locked ? "rwlock" : "unlocked", count, mops, mops / single);
+    }
+    croquette_delete(table);
+  }
+
+  free(keys);
+}
+
+/**
+ * @struct Writer_Work_s
+ *
+ * @brief Keys for one bench_segments() thread
+ */
+typedef struct writer_work {
+  croquette_t *table;       ///< Croquette shared by every thread.
+  Bench_Key_t *keys;        ///< This thread's own Keys.
+  int count;                ///< Number of Keys.
+} Writer_Work_s;
+
+/**
+ * @brief Thread body for bench_segments(): puts its Keys, then removes them again
+ *
+ * @return NULL
+ */
+static void *writer_work(void *arg) {
+  Writer_Work_s *work = arg;
+  int i = 0;
+  for(i = 0; i < work->count; i++) {
+    croquette_h_put(work->table, work->keys[i], work->keys[i]);
+  }
+  for(i = 0; i < work->count; i++) {
+    croquette_h_remove(work->table, work->keys[i]);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Write throughput of 1 to 8 threads against one thread_safe table and 1 to 64 Segments
+ * - The threads split BENCH_NUM_KEYS between them, each putting then removing its own; every
+ *   put and remove takes a write lock, so only Segments let writers run side by side.
+ * - Then single threaded Swiss and Bucketized timings unsegmented and with 16 and 1024 Segments:
+ *   their hash tags must stay as selective (misses as fast) in a Segment as in a whole table.
+ */
+static void bench_segments() {
+  const int segments[] = {0, 1, 4, 16, 64};
+  const int tag_segments[] = {0, 16, 1024};
+  const Croquette_Backend_e tagged[] = {C_Backend_Swiss, C_Backend_Bucketized};
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Config_s config;
+  Writer_Work_s work[8];
+  pthread_t threads[8];
+  double start = 0;
+  double mops = 0;
+  char label[32] = {0};
+  int s = 0;
+  int b = 0;
+  int count = 0;
+  int t = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+  printf("| %ld online cores\n", sysconf(_SC_NPROCESSORS_ONLN));
+
+  for(s = 0; s < sizeof(segments) / sizeof(segments[0]); s++) {
+    if(s == 0) {
+      printf("| rwlock     ");
+    }
+    else {
+      printf("| %2d segments", segments[s]);
+    }
+    for(count = 1; count <= 8; count <<= 1) {
+      bench_config_init(&config);
+      config.value_compare = compare_ptr;
+      config.thread_safe = 1;
+      config.segments = segments[s];
+      croquette_t *table = croquette_new_config(&config);
+      if(table == NULL) {
+        continue;
+      }
+      start = now_ns();
+      for(t = 0; t < count; t++) {
+        work[t].table = table;
+        work[t].keys = keys + (long)BENCH_NUM_KEYS * t / count;
+        work[t].count = BENCH_NUM_KEYS / count;
+        pthread_create(&threads[t], NULL, writer_work, &work[t]);
+      }
+      for(t = 0; t < count; t++) {
+        pthread_join(threads[t], NULL);
+      }
+      mops = 2.0 * (BENCH_NUM_KEYS / count) * count / ((now_ns() - start) / 1e3);
+      printf(" %d thr %6.2f", count, mops);
+      croquette_delete(table);
+    }
+    printf(" Mops/s\n");
+  }
+
+  /* Swiss and Bucketized tags are top hash bits: misses stay flat only if routing leaves them varied */
+  for(b = 0; b < 2; b++) {
+    for(s = 0; s < sizeof(tag_segments) / sizeof(tag_segments[0]); s++) {
+      bench_config_init(&config);
+      config.backend = tagged[b];
+      config.segments = tag_segments[s];
+      snprintf(label, sizeof(label), "%s/%d", (b == 0) ? "swiss" : "bucket", tag_segments[s]);
+      bench_table_ops(label, &config, keys, BENCH_NUM_KEYS);
+    }
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Thread body for bench_readmostly(): 99 lookups then 1 put, striding over the keys from its first key
+ * - Keys are visited out of creation order, as a lookup path would, so no table is helped by
+ *   Entries that happen to sit in memory in the order they are read.
+ *
+ * @return NULL
+ */
+static void *readmostly_work(void *arg) {
+  Reader_Work_s *work = arg;
+  int k = work->first;
+  int i = 0;
+  for(i = 0; i < work->lookups; i++) {
+    if(i % 100 == 99) {
+      croquette_h_put(work->table, work->keys[k], work->keys[k]);
+    }
+    else {
+      work->found += (croquette_h_get(work->table, work->keys[k]) != NULL);
+    }
+    k = (k + BENCH_STRIDE) % BENCH_NUM_KEYS;
+  }
+  return NULL;
+}
+
+/**
+ * @brief 99% read throughput from 1 to 2x the online cores (at most 16 threads), rwlock vs lock_free_reads
+ * - Lookups under rwlock all write the lock's reader count; lock-free lookups write only their own epoch record.
+ */
+static void bench_readmostly() {
+  const int operations = 500000;
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Config_s config;
+  Reader_Work_s work[16];
+  pthread_t threads[16];
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  double start = 0;
+  double mops = 0;
+  double single = 0;
+  int lock_free = 0;
+  int count = 0;
+  int t = 0;
+  int i = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+  printf("| %ld online cores\n", cores);
+
+  for(lock_free = 0; lock_free < 2; lock_free++) {
+    bench_config_init(&config);
+    config.value_compare = compare_ptr;
+    config.thread_safe = 1;
+    config.lock_free_reads = lock_free;
+    croquette_t *table = croquette_new_config(&config);
+    if(table == NULL) {
+      continue;
+    }
+    for(i = 0; i < BENCH_NUM_KEYS; i++) {
+      croquette_h_put(table, keys[i], keys[i]);
+    }
+
+    for(count = 1; count <= 16 && count <= 2 * cores; count <<= 1) {
+      start = now_ns();
+      for(t = 0; t < count; t++) {
+        work[t].table = table;
+        work[t].keys = keys;
+        work[t].first = (int)((long)BENCH_NUM_KEYS * t / count);
+        work[t].lookups = operations;
+        work[t].found = 0;
+        pthread_create(&threads[t], NULL, readmostly_work, &work[t]);
+      }
+      for(t = 0; t < count; t++) {
+        pthread_join(threads[t], NULL);
+      }
+      mops = (double)operations * count / ((now_ns() - start) / 1e3);
+      single = (count == 1) ? mops : single;
+      printf("| %-9s %2d threads %7.2f Mops/s (%4.2fx)\n", lock_free ? "lock-free" : "rwlock", count, mops, mops / single);
+    }
+    croquette_delete(table);
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief Thread body for bench_nonblocking(): 80% lookups, 10% puts and 10% removes, striding over the keys
+ *
+ * @return NULL
+ */
+static void *mixed_work(void *arg) {
+  Reader_Work_s *work = arg;
+  int k = work->first;
+  int i = 0;
+  for(i = 0; i < work->lookups; i++) {
+    switch(i % 10) {
+      case 0:
+        croquette_h_put(work->table, work->keys[k], work->keys[k]);
+        break;
+      case 5:
+        croquette_h_remove(work->table, work->keys[k]);
+        break;
+      default:
+        work->found += (croquette_h_get(work->table, work->keys[k]) != NULL);
+        break;
+    }
+    k = (k + BENCH_STRIDE) % BENCH_NUM_KEYS;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Mixed read/write throughput of 1 to 8 threads: the locked modes against the split-ordered Backend
+ * - rwlock serializes every change, Segments one lock per Segment, lock_free_reads frees only
+ *   the lookups; the split-ordered list takes no lock for any operation, resizes included.
+ * - Half the keys are put first; the puts and removes then keep the table near that size.
+ */
+static void bench_nonblocking() {
+  const char *labels[] = {"rwlock", "16 segments", "lock-free reads", "split-ordered"};
+  const int operations = 500000;
+  Bench_Key_t *keys = make_url_keys(BENCH_NUM_KEYS);
+  Croquette_Config_s config;
+  Reader_Work_s work[8];
+  pthread_t threads[8];
+  double start = 0;
+  double mops = 0;
+  int mode = 0;
+  int count = 0;
+  int t = 0;
+  int i = 0;
+
+  if(keys == NULL) {
+    return;
+  }
+  printf("| %ld online cores\n", sysconf(_SC_NPROCESSORS_ONLN));
+
+  for(mode = 0; mode < 4; mode++) {
+    printf("| %-15s", labels[mode]);
+    for(count = 1; count <= 8; count <<= 1) {
+      bench_config_init(&config);
+      config.value_compare = compare_ptr;
+      config.thread_safe = 1;
+      config.segments = (mode == 1) ? 16 : 0;
+      config.lock_free_reads = (mode == 2);
+      config.backend = (mode == 3) ? C_Backend_SplitOrdered : C_Backend_Chained;
+      croquette_t *table = croquette_new_config(&config);
+      if(table == NULL) {
+        continue;
+      }
+      for(i = 0; i < BENCH_NUM_KEYS; i += 2) {
+        croquette_h_put(table, keys[i], keys[i]);
+      }
+      start = now_ns();
+      for(t = 0; t < count; t++) {
+        work[t].table = table;
+        work[t].keys = keys;
+        work[t].first = (int)((long)BENCH_NUM_KEYS * t / count);
+        work[t].lookups = operations / count;
+        work[t].found = 0;
+        pthread_create(&threads[t], NULL, mixed_work, &work[t]);
+      }
+      for(t = 0; t < count; t++) {
+        pthread_join(threads[t], NULL);
+      }
+      mops = (double)(operations / count) * count / ((now_ns() - start) / 1e3);
+      printf(" %d thr %6.2f", count, mops);
+      croquette_delete(table);
+    }
+    printf(" Mops/s\n");
+  }
+
+  free(keys);
+}
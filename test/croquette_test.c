@@ -7,14 +7,19 @@
  * - Copyright Kevin Andrea - 2023
  */
 #include <assert.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <stdlib.h>
 
 #include "croquette.h"
 
 // Testing Data
 static int test_number = 0; // Simple tracker of Test Number
+static uint64_t recorded_seed = 0; // Last seed seen by hash_record_seed()
 enum test_results { Test_Success = 0, Test_Failure };
 
 #define MAX_NAME_LEN 50
@@ -34,6 +39,29 @@ static int test_croquette_put();
 static int test_croquette_remove_dofree();
 static int test_croquette_remove_nofree();
 static int test_croquette_clear();
+static int test_croquette_instances();
+static int test_croquette_hash();
+static int test_croquette_key_functions();
+static int test_croquette_length_keys();
+static int test_croquette_pow2_capacity();
+static int test_croquette_incremental_rehash();
+static int test_croquette_slab_allocator();
+static int test_croquette_inline_keys();
+static int test_croquette_robinhood();
+static int test_croquette_swiss();
+static int test_croquette_cuckoo();
+static int test_croquette_treeify();
+static int test_croquette_random_seed();
+static int test_croquette_bucketized();
+static int test_croquette_compact();
+static int test_croquette_reserve();
+static int test_croquette_load_factors();
+static int test_croquette_small_map();
+static int test_croquette_thread_safe();
+static int test_croquette_segments();
+static int test_croquette_lock_free_reads();
+static int test_croquette_split_ordered();
+static int test_croquette_sharded();
 
 // Testing Struct Definitions
 /**
@@ -71,6 +99,158 @@ static int compare_elem(const void *elem1, const void *elem2) {
   return(e1->value - e2->value);
 }
 
+/**
+ * @brief Case-insensitive Key hash; pass into Croquette via the Configuration.
+ *
+ * @return Hash of the lowercased Key.
+ */
+static uint64_t hash_nocase(const char *key, size_t len, uint64_t seed) {
+  char lower[MAX_KEY_SIZE + 1] = {0};
+  size_t i = 0;
+  for(i = 0; i < len && i < MAX_KEY_SIZE; i++) {
+    lower[i] = tolower((unsigned char)key[i]);
+  }
+  return croquette_hash(lower, i, seed);
+}
+
+/**
+ * @brief Case-insensitive Key equality; pass into Croquette via the Configuration.
+ *
+ * @return True if the Keys match ignoring case.
+ */
+static int equal_nocase(const char *key1, size_t len1, const char *key2, size_t len2) {
+  return len1 == len2 && strncasecmp(key1, key2, len1) == 0;
+}
+
+/**
+ * @brief Key hash sending every Key to the same bucket; forces full chain walks.
+ *
+ * @return A constant hash.
+ */
+static uint64_t hash_constant(const char *key, size_t len, uint64_t seed) {
+  return 42;
+}
+
+/**
+ * @brief Key hash with only its low 32 bits set, like many user hash functions.
+ *
+ * @return croquette_hash() of the Key, truncated to 32 bits.
+ */
+static uint64_t hash_low32(const char *key, size_t len, uint64_t seed) {
+  return croquette_hash(key, len, seed) & 0xffffffffull;
+}
+
+/**
+ * @brief Key hash that records the seed it was given; pass into Croquette via the Configuration.
+ *
+ * @return croquette_hash() of the Key.
+ */
+static uint64_t hash_record_seed(const char *key, size_t len, uint64_t seed) {
+  recorded_seed = seed;
+  return croquette_hash(key, len, seed);
+}
+
+/**
+ * @struct Visit_Log_s
+ *
+ * @brief Record of the Entries seen by visit_log(); pass into croquette_foreach() as arg.
+ */
+typedef struct visit_log {
+  int count;          ///< Entries visited.
+  long value_sum;     ///< Sum of the visited Element values.
+  int stop_after;     ///< Stop after this many Entries (0 to visit all).
+  int in_order;       ///< Boolean: every Element value was larger than the one before.
+  int last;           ///< Element value of the last Entry visited.
+} Visit_Log_s;
+
+/**
+ * @brief Visitor for croquette_foreach(); checks each Key names its Element and logs it.
+ *
+ * @return Non-zero to stop once stop_after Entries were seen.
+ */
+static int visit_log(const char *key, size_t len, void *value, void *arg) {
+  Visit_Log_s *log = arg;
+  Element_s *elem = value;
+  assert(strlen(key) == len && strcmp(key, elem->name) == 0);
+  log->in_order &= (log->count == 0 || elem->value > log->last);
+  log->last = elem->value;
+  log->value_sum += elem->value;
+  log->count++;
+  return log->stop_after != 0 && log->count == log->stop_after;
+}
+
+/**
+ * @struct Reader_Args_s
+ *
+ * @brief Work for reader_thread(): Keys "stable0".."stable<count-1>" that must always be found.
+ */
+typedef struct reader_args {
+  croquette_t *table;       ///< Thread safe Croquette to read.
+  Element_s *elems;         ///< Element stored under each stable Key.
+  int count;                ///< Number of stable Keys.
+  int rounds;               ///< Passes over the stable Keys.
+  int misses;               ///< Stable Keys not found, or found with the wrong Element (result).
+  int started;              ///< Set once the first pass is done, so a writer can wait for the readers.
+} Reader_Args_s;
+
+/**
+ * @brief Thread body looking up the stable Keys while another thread changes the Croquette.
+ *
+ * @return NULL
+ */
+static void *reader_thread(void *arg) {
+  Reader_Args_s *args = arg;
+  char key[MAX_NAME_LEN] = {0};
+  int r = 0;
+  int i = 0;
+  for(r = 0; r < args->rounds; r++) {
+    for(i = 0; i < args->count; i++) {
+      sprintf(key, "stable%d", i);
+      args->misses += (croquette_h_get(args->table, key) != &args->elems[i]);
+      args->misses += (croquette_h_containsKey(args->table, key) != 1);
+    }
+    __atomic_store_n(&args->started, 1, __ATOMIC_RELEASE);
+  }
+  return NULL;
+}
+
+/**
+ * @struct Writer_Args_s
+ *
+ * @brief Work for writer_thread(): Keys "w<id>_0".."w<id>_<count-1>", disjoint between writers.
+ */
+typedef struct writer_args {
+  croquette_t *table;       ///< Thread safe Croquette to change.
+  Element_s *elems;         ///< Element stored under each Key.
+  int id;                   ///< Writer number (part of every Key).
+  int count;                ///< Number of Keys.
+} Writer_Args_s;
+
+/**
+ * @brief Thread body putting its Keys, removing the odd ones and updating the even ones.
+ *
+ * @return NULL
+ */
+static void *writer_thread(void *arg) {
+  Writer_Args_s *args = arg;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+  for(i = 0; i < args->count; i++) {
+    sprintf(key, "w%d_%d", args->id, i);
+    croquette_h_put(args->table, key, &args->elems[0]);
+  }
+  for(i = 0; i < args->count; i++) {
+    sprintf(key, "w%d_%d", args->id, i);
+    if(i % 2 == 1) {
+      croquette_h_remove(args->table, key);
+    }
+    else {
+      croquette_h_put(args->table, key, &args->elems[i]);
+    }
+  }
+  return NULL;
+}
+
 /**
  * @brief Function to create an element for testing purposes.
  * - Element uses dynamic memory, must be freed.
@@ -87,6 +267,84 @@ static Element_s *create_elem(char *name, int val) {
   return elem;
 }
 
+/**
+ * @struct Race_Args_s
+ *
+ * @brief Work for the split-ordered stress threads: Keys "<prefix><i>" for i under count.
+ */
+typedef struct race_args {
+  croquette_t *table;       ///< Croquette shared by every thread.
+  Element_s *elems;         ///< This thread's Element for each Key (race_thread()).
+  int *won;                 ///< Set to 1 for each Key this thread inserted (race_thread()).
+  int *phase;               ///< 0 while the Keys go in, 1 while they come out, 2 once done (order_reader()).
+  int count;                ///< Number of Keys.
+  int rounds;               ///< Passes over the Keys (update_thread()).
+  int violations;           ///< Orders seen that no sequential history allows (result).
+} Race_Args_s;
+
+/**
+ * @brief Thread body racing the other threads to putIfAbsent the same Keys.
+ *
+ * @return NULL
+ */
+static void *race_thread(void *arg) {
+  Race_Args_s *args = arg;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+  for(i = 0; i < args->count; i++) {
+    sprintf(key, "race%d", i);
+    args->won[i] = (croquette_h_putIfAbsent(args->table, key, &args->elems[i]) == NULL);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Thread body checking that Keys put (then removed) in ascending order are seen in that order.
+ * - While inserting, "order<j>" present means "order<j-1>" is present; while removing, absent means absent.
+ *
+ * @return NULL
+ */
+static void *order_reader(void *arg) {
+  Race_Args_s *args = arg;
+  char key[MAX_NAME_LEN] = {0};
+  int phase = 0;
+  int later = 0;
+  int earlier = 0;
+  int j = 1;
+  while((phase = __atomic_load_n(args->phase, __ATOMIC_SEQ_CST)) != 2) {
+    sprintf(key, "order%d", j);
+    later = croquette_h_containsKey(args->table, key);
+    sprintf(key, "order%d", j - 1);
+    earlier = croquette_h_containsKey(args->table, key);
+    if(__atomic_load_n(args->phase, __ATOMIC_SEQ_CST) == phase) {
+      args->violations += (phase == 0 && later && !earlier) || (phase == 1 && !later && earlier);
+    }
+    j = (j + 1 < args->count) ? j + 1 : 1;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Thread body replacing and removing the same few Keys as the other threads (do_free).
+ *
+ * @return NULL
+ */
+static void *update_thread(void *arg) {
+  Race_Args_s *args = arg;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+  for(i = 0; i < args->rounds; i++) {
+    sprintf(key, "hot%d", i % args->count);
+    if(i % 7 == 6) {
+      croquette_h_remove(args->table, key);
+    }
+    else {
+      croquette_h_put(args->table, key, create_elem(key, i));
+    }
+  }
+  return NULL;
+}
+
 /**
  * @brief main Function to run the Unit Tests on Croquette
  *
@@ -133,6 +391,98 @@ int main() {
   ret = test_croquette_clear();
   test_end(ret);
 
+  test_start("Testing Independent Instances (Handle API)");
+  ret = test_croquette_instances();
+  test_end(ret);
+
+  test_start("Testing Key Hash Function");
+  ret = test_croquette_hash();
+  test_end(ret);
+
+  test_start("Testing Custom Key Hash and Equality Functions");
+  ret = test_croquette_key_functions();
+  test_end(ret);
+
+  test_start("Testing Length-Aware Keys (_n Functions)");
+  ret = test_croquette_length_keys();
+  test_end(ret);
+
+  test_start("Testing Power of Two Capacity Mode");
+  ret = test_croquette_pow2_capacity();
+  test_end(ret);
+
+  test_start("Testing Incremental Rehash");
+  ret = test_croquette_incremental_rehash();
+  test_end(ret);
+
+  test_start("Testing Slab Allocator");
+  ret = test_croquette_slab_allocator();
+  test_end(ret);
+
+  test_start("Testing Inline Key Storage (Short and Long Keys)");
+  ret = test_croquette_inline_keys();
+  test_end(ret);
+
+  test_start("Testing Robin Hood Backend");
+  ret = test_croquette_robinhood();
+  test_end(ret);
+
+  test_start("Testing SwissTable Backend");
+  ret = test_croquette_swiss();
+  test_end(ret);
+
+  test_start("Testing Cuckoo Backend and Stats");
+  ret = test_croquette_cuckoo();
+  test_end(ret);
+
+  test_start("Testing Tree Bins for Colliding Keys");
+  ret = test_croquette_treeify();
+  test_end(ret);
+
+  test_start("Testing Random and Fixed Hash Seeds");
+  ret = test_croquette_random_seed();
+  test_end(ret);
+
+  test_start("Testing Bucketized Chaining Backend");
+  ret = test_croquette_bucketized();
+  test_end(ret);
+
+  test_start("Testing Compact Backend and Iteration (croquette_foreach)");
+  ret = test_croquette_compact();
+  test_end(ret);
+
+  test_start("Testing Reserve and Pinned Capacity");
+  ret = test_croquette_reserve();
+  test_end(ret);
+
+  test_start("Testing Load Factors, Hysteresis and Shrink to Fit");
+  ret = test_croquette_load_factors();
+  test_end(ret);
+
+  test_start("Testing Small Map Mode and Upgrading");
+  ret = test_croquette_small_map();
+  test_end(ret);
+
+  test_start("Testing Thread Safe Mode (Concurrent Readers and a Writer)");
+  ret = test_croquette_thread_safe();
+  test_end(ret);
+
+  test_start("Testing Segmented Croquette (Lock Striping)");
+  ret = test_croquette_segments();
+  test_end(ret);
+
+  test_start("Testing Lock-Free Reads with Epoch Based Reclamation");
+  ret = test_croquette_lock_free_reads();
+  test_end(ret);
+
+  test_start("Testing Split-Ordered Backend (Non-Blocking) and Linearizability");
+  ret = test_croquette_split_ordered();
+  test_end(ret);
+
+  test_start("Testing Sharded Croquette (Per-Shard Instances and Routing)");
+  ret = test_croquette_sharded();
+  test_end(ret);
+
   return EXIT_SUCCESS;
 }
 
@@ -513,7 +863,7 @@ static int test_croquette_remove_dofree() {
   assert(!croquette_containsKey("bee"));
   assert(croquette_containsKey("cee"));
   assert(croquette_size() == 3);
-  assert(croquette_capacity() == 4);
+  assert(croquette_capacity() == 8);
   assert(ret == C_Success);
 
   test_comment("Single Key Remove - Last (eee)");
@@ -521,7 +871,7 @@ static int test_croquette_remove_dofree() {
   assert(!croquette_containsKey("eee"));
   assert(croquette_containsKey("dee"));
   assert(croquette_size() == 2);
-  assert(croquette_capacity() == 4);
+  assert(croquette_capacity() == 8);
   assert(ret == C_Success);
 
   test_comment("Adding in a new bee");
@@ -529,7 +879,7 @@ static int test_croquette_remove_dofree() {
   assert(croquette_containsKey("bee"));
   assert(croquette_containsKey("cee"));
   assert(croquette_size() == 3);
-  assert(croquette_capacity() == 4);
+  assert(croquette_capacity() == 8);
 
   croquette_print_keys();
 
@@ -587,7 +937,7 @@ static int test_croquette_remove_nofree() {
   assert(!croquette_containsKey("bee"));
   assert(croquette_containsKey("cee"));
   assert(croquette_size() == 3);
-  assert(croquette_capacity() == 4);
+  assert(croquette_capacity() == 8);
   assert(ret == C_Success);
 
   test_comment("Single Key Remove - Last (eee)");
@@ -595,7 +945,7 @@ static int test_croquette_remove_nofree() {
   assert(!croquette_containsKey("eee"));
   assert(croquette_containsKey("dee"));
   assert(croquette_size() == 2);
-  assert(croquette_capacity() == 4);
+  assert(croquette_capacity() == 8);
   assert(ret == C_Success);
 
   test_comment("Adding in a new bee");
@@ -603,7 +953,7 @@ static int test_croquette_remove_nofree() {
   assert(croquette_containsKey("bee"));
   assert(croquette_containsKey("cee"));
   assert(croquette_size() == 3);
-  assert(croquette_capacity() == 4);
+  assert(croquette_capacity() == 8);
 
   croquette_print_keys();
 
@@ -669,3 +1019,1936 @@ static int test_croquette_clear() {
   return Test_Success;
 }
 
+
+/**
+ * @brief Function to Test Multiple Independent Croquette Instances
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_instances() {
+  // Test Setup
+  Element_s *a = create_elem("aaa", 21);
+  Element_s *b = create_elem("bee", 22);
+  Element_s *c = create_elem("cee", 23);
+  Element_s *elem = NULL;
+  int ret = 0;
+
+  croquette_t *first = croquette_new(1, C_Do_Free, free_elem, compare_elem);
+  croquette_t *second = croquette_new(C_Default_Capacity, C_No_Free, NULL, compare_elem);
+  assert(first != NULL && second != NULL);
+
+  // Testing
+  test_comment("Checking NULL Handle is Uninitialized");
+  ret = croquette_h_size(NULL);
+  assert(ret == C_Error && croquette_get_error() == C_Uninitialized);
+  ret = croquette_h_put(NULL, "aaa", a);
+  assert(ret == C_Error && croquette_get_error() == C_Uninitialized);
+
+  test_comment("Checking Invalid Creation Returns NULL");
+  assert(croquette_new(0, C_Do_Free, NULL, compare_elem) == NULL);
+  assert(croquette_get_error() == C_FreeValue_Missing);
+
+  test_comment("Putting Keys in Separate Instances");
+  croquette_h_put(first, a->name, a);
+  croquette_h_put(first, b->name, b);
+  croquette_h_put(second, c->name, c);
+  assert(croquette_h_size(first) == 2 && croquette_h_capacity(first) == 4);
+  assert(croquette_h_size(second) == 1);
+  assert(croquette_h_capacity(second) == CROQUETTE_DEFAULT_INITIAL_SIZE);
+
+  test_comment("Checking Keys are not Shared Between Instances");
+  assert(croquette_h_containsKey(first, "aaa") && !croquette_h_containsKey(second, "aaa"));
+  assert(croquette_h_containsKey(second, "cee") && !croquette_h_containsKey(first, "cee"));
+  elem = croquette_h_get(first, "bee");
+  assert(elem == b);
+  assert(croquette_h_containsValue(second, c) > 0);
+
+  test_comment("Checking Default Croquette is Unaffected");
+  assert(croquette_size() == C_Error && croquette_get_error() == C_Uninitialized);
+
+  test_comment("Removing from One Instance");
+  ret = croquette_h_remove(first, "aaa");
+  assert(ret == C_Success && !croquette_h_containsKey(first, "aaa"));
+  assert(croquette_h_size(second) == 1);
+
+  // Test Teardown
+  croquette_delete(first);
+  croquette_delete(second);
+  free(c);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test croquette_hash()
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_hash() {
+  // Test Setup
+  const char *long_a = "https://example.com/api/v1/item/1/details.json";
+  const char *long_b = "https://example.com/api/v1/item/2/details.json";
+  char buffer[128] = {0};
+  uint64_t code = 0;
+  int len = 0;
+
+  // Testing
+  test_comment("Checking Hash is Deterministic for a Seed");
+  code = croquette_hash("aaa", 3, CROQUETTE_DEFAULT_SEED);
+  assert(code == croquette_hash("aaa", 3, CROQUETTE_DEFAULT_SEED));
+  assert(code != croquette_hash("aaa", 3, CROQUETTE_DEFAULT_SEED + 1));
+
+  test_comment("Checking Long Keys with Shared Suffix Differ");
+  assert(croquette_hash(long_a, strlen(long_a), CROQUETTE_DEFAULT_SEED) !=
+         croquette_hash(long_b, strlen(long_b), CROQUETTE_DEFAULT_SEED));
+
+  test_comment("Checking Every Length Hashes Only its Own Bytes (0..100)");
+  memset(buffer, 'x', sizeof(buffer));
+  for(len = 0; len <= 100; len++) {
+    code = croquette_hash(buffer, len, CROQUETTE_DEFAULT_SEED);
+    buffer[len] = 'y';  // Bytes past the length must not change the hash
+    assert(code == croquette_hash(buffer, len, CROQUETTE_DEFAULT_SEED));
+    assert(code != croquette_hash(buffer, len + 1, CROQUETTE_DEFAULT_SEED));
+    buffer[len] = 'x';
+  }
+
+  // Test Teardown
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Custom hash_fn and key_equal in the Configuration
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_key_functions() {
+  // Test Setup
+  Element_s *a = create_elem("aaa", 21);
+  Element_s *b = create_elem("bee", 22);
+  Element_s *c = create_elem("cee", 23);
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+
+  // Testing
+  test_comment("Creating with a NULL Configuration (Error)");
+  assert(croquette_new_config(NULL) == NULL && croquette_get_error() == C_Invalid_Config);
+
+  test_comment("Creating with Case-Insensitive Key Functions");
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  config.hash_fn = hash_nocase;
+  config.key_equal = equal_nocase;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+
+  test_comment("Checking Keys Differing Only in Case are the Same Key");
+  croquette_h_put(table, "AAA", a);
+  assert(croquette_h_get(table, "aaa") == a);
+  assert(croquette_h_putIfAbsent(table, "aAa", b) == a);
+  assert(croquette_h_size(table) == 1);
+  croquette_h_remove(table, "aaA");
+  assert(croquette_h_isEmpty(table) == 1);
+  croquette_delete(table);
+
+  test_comment("Checking Every Key Colliding Still Finds Each Key");
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  config.hash_fn = hash_constant;
+  table = croquette_new_config(&config);
+  croquette_h_put(table, a->name, a);
+  croquette_h_put(table, b->name, b);
+  croquette_h_put(table, c->name, c);
+  assert(croquette_h_get(table, "aaa") == a);
+  assert(croquette_h_get(table, "bee") == b);
+  assert(croquette_h_get(table, "cee") == c);
+  croquette_h_remove(table, "bee");
+  assert(!croquette_h_containsKey(table, "bee") && croquette_h_containsKey(table, "cee"));
+
+  // Test Teardown
+  croquette_delete(table);
+  free(a);
+  free(b);
+  free(c);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the Length-Aware (_n) Functions
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_length_keys() {
+  // Test Setup
+  Element_s *a = create_elem("aaa", 21);
+  Element_s *b = create_elem("aaab", 22);
+  Element_s *l = create_elem("long", 23);
+  const char *buffer = "aaabcdef";  // Keys are slices of a larger buffer (no NUL)
+  char long_key[MAX_KEY_SIZE + 2] = {0};
+  int ret = 0;
+
+  croquette_create(C_Default_Capacity, C_Do_Free, free_elem, compare_elem);
+
+  // Testing
+  test_comment("Putting Slices of a Buffer as Keys");
+  ret = croquette_put_n(buffer, 3, a);
+  assert(ret == C_Success);
+  ret = croquette_put_n(buffer, 4, b);
+  assert(ret == C_Success && croquette_size() == 2);
+
+  test_comment("Checking Slices Match the NUL Terminated Keys");
+  assert(croquette_get("aaa") == a);
+  assert(croquette_get_n("aaab", 4) == b);
+  assert(croquette_get_n(buffer, 2) == NULL && croquette_get_error() == C_No_Error);
+
+  test_comment("Checking Zero Length and Over-Long Keys (Error)");
+  assert(croquette_get_n(buffer, 0) == NULL && croquette_get_error() == C_Invalid_Key);
+  ret = croquette_put_n(NULL, 3, a);
+  assert(ret == C_Error && croquette_get_error() == C_Invalid_Key);
+  memset(long_key, 'k', MAX_KEY_SIZE + 1);
+  ret = croquette_put(long_key, l);
+  assert(ret == C_Error && croquette_get_error() == C_Invalid_Key);
+  ret = croquette_put_n(long_key, MAX_KEY_SIZE, l);
+  assert(ret == C_Success && croquette_get_n(long_key, MAX_KEY_SIZE) == l);
+  croquette_remove_n(long_key, MAX_KEY_SIZE);
+
+  test_comment("Removing by Slice");
+  ret = croquette_remove_n(buffer, 3);
+  assert(ret == C_Success && !croquette_containsKey("aaa") && croquette_containsKey("aaab"));
+
+  // Test Teardown
+  croquette_destroy();
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the Power of Two Capacity Mode
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_pow2_capacity() {
+  // Test Setup
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  config.capacity_mode = C_Capacity_Pow2;
+
+  // Testing
+  test_comment("Checking Default Capacity Rounds Up to 16");
+  table = croquette_new_config(&config);
+  assert(table != NULL && croquette_h_capacity(table) == 16);
+  croquette_delete(table);
+
+  test_comment("Checking Invalid Capacity Mode (Error)");
+  config.capacity_mode = 7;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+
+  test_comment("Checking 100 Keys Grow by Doubling and are Found");
+  config.capacity_mode = C_Capacity_Pow2;
+  config.initial_capacity = 3;
+  table = croquette_new_config(&config);
+  assert(croquette_h_capacity(table) == 4);
+  for(i = 0; i < 100; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_put(table, key, table);
+  }
+  assert(croquette_h_size(table) == 100 && croquette_h_capacity(table) == 256);
+  for(i = 0; i < 100; i++) {
+    sprintf(key, "key%d", i);
+    assert(croquette_h_get(table, key) == table);
+  }
+
+  test_comment("Checking Removes Halve and Clear Resets to 4");
+  for(i = 0; i < 90; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_remove(table, key);
+  }
+  assert(croquette_h_size(table) == 10 && croquette_h_capacity(table) == 32);
+  assert(croquette_h_get(table, "key95") == table);
+  croquette_h_clear(table);
+  assert(croquette_h_capacity(table) == 4);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Incremental Rehashing (rehash_step)
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_incremental_rehash() {
+  // Test Setup
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+  int j = 0;
+
+  croquette_config_init(&config);
+  config.initial_capacity = 1;
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+  config.rehash_step = 1;
+
+  // Testing
+  test_comment("Checking Negative Step (Error)");
+  config.rehash_step = -1;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.rehash_step = 1;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+
+  test_comment("Putting 500 Keys, Checking Every Key After Each Put");
+  for(i = 0; i < 500; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+    for(j = 0; j <= i; j += 37) {
+      sprintf(key, "key%d", j);
+      elem = croquette_h_get(table, key);
+      assert(elem != NULL && elem->value == j);
+    }
+  }
+  assert(croquette_h_size(table) == 500);
+
+  test_comment("Updating and Finding Values Mid-Migration");
+  croquette_h_put(table, "key3", create_elem("key3", 1337));
+  elem = croquette_h_get(table, "key3");
+  assert(elem->value == 1337 && croquette_h_containsValue(table, elem));
+
+  test_comment("Removing 450 Keys, Checking Remaining Keys");
+  for(i = 0; i < 450; i++) {
+    sprintf(key, "key%d", i);
+    assert(croquette_h_remove(table, key) == C_Success);
+    assert(!croquette_h_containsKey(table, key));
+  }
+  assert(croquette_h_size(table) == 50);
+  for(i = 450; i < 500; i++) {
+    sprintf(key, "key%d", i);
+    elem = croquette_h_get(table, key);
+    assert(elem != NULL && elem->value == i);
+  }
+
+  test_comment("Clearing Mid-Migration");
+  assert(croquette_h_clear(table) == C_Success);
+  assert(croquette_h_size(table) == 0 && croquette_h_capacity(table) == 1);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Builds a unique Key of 1 to MAX_KEY_SIZE bytes for the i-th Entry (spans every size class).
+ *
+ * @return void
+ */
+static void slab_key(char *key, int i) {
+  int len = (i % MAX_KEY_SIZE) + 1;
+  int digits = sprintf(key, "%d", i);
+  if(len > digits) {
+    memset(key + digits, 'a' + (i % 26), len - digits);
+    key[len] = '\0';
+  }
+}
+
+/**
+ * @brief Function to Test the Slab Allocator (C_Alloc_Slab)
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_slab_allocator() {
+  // Test Setup
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_KEY_SIZE + 1] = {0};
+  int i = 0;
+  int round = 0;
+
+  croquette_config_init(&config);
+  config.initial_capacity = 4;
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+  config.allocator = C_Alloc_Slab;
+
+  // Testing
+  test_comment("Checking Invalid Allocator (Error)");
+  config.allocator = (Croquette_Allocator_e)7;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.allocator = C_Alloc_Slab;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+
+  test_comment("Putting and Removing Keys of Varying Length (Block Reuse)");
+  for(round = 0; round < 3; round++) {
+    for(i = 0; i < 2000; i++) {
+      slab_key(key, i);
+      croquette_h_put(table, key, create_elem(key, i));
+    }
+    assert(croquette_h_size(table) == 2000);
+    for(i = 0; i < 2000; i += 2) {
+      slab_key(key, i);
+      assert(croquette_h_remove(table, key) == C_Success);
+    }
+    assert(croquette_h_size(table) == 1000);
+    for(i = 1; i < 2000; i += 2) {
+      slab_key(key, i);
+      elem = croquette_h_get(table, key);
+      assert(elem != NULL && elem->value == i);
+    }
+    test_comment("Clearing (Releases Whole Slabs)");
+    assert(croquette_h_clear(table) == C_Success);
+    assert(croquette_h_size(table) == 0 && croquette_h_capacity(table) == 4);
+  }
+
+  test_comment("Reusing the Croquette after Clear, then Deleting with Entries");
+  croquette_h_put(table, "survivor", create_elem("survivor", 42));
+  elem = croquette_h_get(table, "survivor");
+  assert(elem != NULL && elem->value == 42);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Keys Stored Inline in their Entry (around the short Key limit)
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_inline_keys() {
+  // Test Setup
+  croquette_t *table = croquette_new(C_Default_Capacity, C_Do_Free, free_elem, compare_elem);
+  Element_s *elem = NULL;
+  char key[MAX_KEY_SIZE + 1] = {0};
+  int len = 0;
+
+  assert(table != NULL);
+
+  // Testing
+  test_comment("Putting Prefix Keys of Length 1 to 40");
+  for(len = 1; len <= 40; len++) {
+    memset(key, 'x', len);
+    key[len] = '\0';
+    croquette_h_put(table, key, create_elem(key, len));
+  }
+  assert(croquette_h_size(table) == 40);
+
+  test_comment("Getting Each Key (No Prefix Matches Another)");
+  for(len = 1; len <= 40; len++) {
+    memset(key, 'x', len);
+    key[len] = '\0';
+    elem = croquette_h_get_n(table, key, len);
+    assert(elem != NULL && elem->value == len);
+  }
+
+  test_comment("Checking Keys Differing Only in the Last Byte or by Embedded NULs");
+  memset(key, 'x', 23);
+  key[22] = 'y';
+  assert(croquette_h_get_n(table, key, 23) == NULL);
+  key[22] = '\0';
+  assert(croquette_h_get_n(table, key, 23) == NULL);
+  croquette_h_put_n(table, key, 23, create_elem("nul", 99));
+  elem = croquette_h_get_n(table, key, 23);
+  assert(elem != NULL && elem->value == 99);
+  elem = croquette_h_get_n(table, key, 22);
+  assert(elem != NULL && elem->value == 22);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Runs a deterministic mix of puts, updates and removes on a Croquette, checking
+ *   every result against a plain array of the expected contents.
+ * - Shared by the Backend tests; the table must be empty, with do_free and compare_elem set.
+ *
+ * @return void (asserts on any mismatch)
+ */
+static void exercise_backend(croquette_t *table, int key_space, int operations) {
+  int *expected = calloc(key_space, sizeof(int));  // 0 if absent, else value + 1
+  char key[MAX_NAME_LEN] = {0};
+  Element_s *elem = NULL;
+  unsigned int rng = 12345;
+  int size = 0;
+  int i = 0;
+  int k = 0;
+
+  assert(expected != NULL);
+  for(i = 0; i < operations; i++) {
+    rng = rng * 1103515245u + 12345u;
+    k = (int)((rng >> 8) % key_space);
+    sprintf(key, "key-%d", k);
+    if((rng >> 4) % 3 != 0) {
+      croquette_h_put(table, key, create_elem(key, i));
+      size += (expected[k] == 0);
+      expected[k] = i + 1;
+    }
+    else {
+      assert(croquette_h_remove(table, key) == C_Success);
+      size -= (expected[k] != 0);
+      expected[k] = 0;
+    }
+    assert(croquette_h_size(table) == size);
+  }
+  for(k = 0; k < key_space; k++) {
+    sprintf(key, "key-%d", k);
+    elem = croquette_h_get(table, key);
+    assert((elem == NULL) == (expected[k] == 0));
+    assert(elem == NULL || elem->value == expected[k] - 1);
+  }
+  free(expected);
+}
+
+/**
+ * @brief Function to Test the Robin Hood Open Addressing Backend
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_robinhood() {
+  // Test Setup
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.initial_capacity = 8;
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+  config.backend = C_Backend_RobinHood;
+
+  // Testing
+  test_comment("Checking Unsupported Incremental Rehash and Unknown Backend (Errors)");
+  config.rehash_step = 4;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.rehash_step = 0;
+  config.backend = (Croquette_Backend_e)99;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.backend = C_Backend_RobinHood;
+  table = croquette_new_config(&config);
+  assert(table != NULL && croquette_h_capacity(table) == 8);
+
+  test_comment("Filling to a 0.9 Load Factor Before Doubling");
+  for(i = 0; i < 7; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  assert(croquette_h_capacity(table) == 8);
+  croquette_h_put(table, "key7", create_elem("key7", 7));
+  assert(croquette_h_capacity(table) == 16 && croquette_h_size(table) == 8);
+
+  test_comment("Getting, Updating and Finding Values");
+  elem = croquette_h_get(table, "key3");
+  assert(elem != NULL && elem->value == 3);
+  croquette_h_put(table, "key3", create_elem("key3", 33));
+  elem = croquette_h_get(table, "key3");
+  assert(elem->value == 33 && croquette_h_containsValue(table, elem));
+  assert(croquette_h_putIfAbsent(table, "key3", NULL) == elem);
+  assert(!croquette_h_containsKey(table, "key8"));
+
+  test_comment("Running 20000 Mixed Operations (Backward Shift Deletes)");
+  assert(croquette_h_clear(table) == C_Success);
+  assert(croquette_h_capacity(table) == 8);
+  exercise_backend(table, 3000, 20000);
+
+  test_comment("Removing Everything Shrinks to the Base Capacity");
+  for(i = 0; i < 3000; i++) {
+    sprintf(key, "key-%d", i);
+    croquette_h_remove(table, key);
+  }
+  assert(croquette_h_size(table) == 0 && croquette_h_capacity(table) == 8);
+
+  test_comment("Running with the Slab Allocator");
+  croquette_delete(table);
+  config.allocator = C_Alloc_Slab;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  exercise_backend(table, 500, 5000);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the SwissTable (control byte) Backend
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_swiss() {
+  // Test Setup
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.initial_capacity = 5;
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+  config.backend = C_Backend_Swiss;
+
+  // Testing
+  test_comment("Checking the Capacity is at Least One Group of 16");
+  table = croquette_new_config(&config);
+  assert(table != NULL && croquette_h_capacity(table) == 16);
+
+  test_comment("Filling to a 7/8 Load Factor Before Doubling");
+  for(i = 0; i < 14; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  assert(croquette_h_capacity(table) == 16);
+  croquette_h_put(table, "key14", create_elem("key14", 14));
+  assert(croquette_h_capacity(table) == 32 && croquette_h_size(table) == 15);
+
+  test_comment("Getting, Updating and Missing Keys");
+  elem = croquette_h_get(table, "key9");
+  assert(elem != NULL && elem->value == 9);
+  croquette_h_put(table, "key9", create_elem("key9", 99));
+  elem = croquette_h_get(table, "key9");
+  assert(elem->value == 99 && croquette_h_containsValue(table, elem));
+  assert(croquette_h_get(table, "key15") == NULL);
+
+  test_comment("Churning One Key Set (Tombstones are Reclaimed)");
+  for(i = 0; i < 5000; i++) {
+    sprintf(key, "churn%d", i % 20);
+    if(i % 2 == 0) {
+      croquette_h_put(table, key, create_elem(key, i));
+    }
+    else {
+      croquette_h_remove(table, key);
+    }
+  }
+  assert(croquette_h_capacity(table) <= 64);
+
+  test_comment("Running 20000 Mixed Operations");
+  assert(croquette_h_clear(table) == C_Success);
+  assert(croquette_h_size(table) == 0 && croquette_h_capacity(table) == 16);
+  exercise_backend(table, 3000, 20000);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the Cuckoo Hashing Backend and croquette_h_stats()
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_cuckoo() {
+  // Test Setup
+  Croquette_Config_s config;
+  Croquette_Stats_s stats;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.initial_capacity = 64;
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+  config.backend = C_Backend_Cuckoo;
+
+  // Testing
+  test_comment("Checking Stats Arguments (Error)");
+  table = croquette_new_config(&config);
+  assert(table != NULL && croquette_h_capacity(table) == 64);
+  assert(croquette_h_stats(table, NULL) == C_Error && croquette_get_error() == C_Entry_NULL);
+  assert(croquette_h_stats(NULL, &stats) == C_Error && croquette_get_error() == C_Uninitialized);
+
+  test_comment("Filling 16 Buckets Past Half Full Without a Resize");
+  for(i = 0; i < 40; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  assert(croquette_h_stats(table, &stats) == C_Success);
+  assert(stats.size == 40 && stats.capacity == 64 && stats.load_permille == 625);
+  assert(stats.inserts == 40 && stats.insert_failures == 0);
+
+  test_comment("Getting Every Key After Displacements");
+  for(i = 0; i < 40; i++) {
+    sprintf(key, "key%d", i);
+    elem = croquette_h_get(table, key);
+    assert(elem != NULL && elem->value == i);
+  }
+
+  test_comment("Growing Only on Insert Failures");
+  for(i = 40; i < 2000; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  assert(croquette_h_stats(table, &stats) == C_Success);
+  assert(stats.size == 2000 && stats.insert_failures > 0 && stats.load_permille > 400);
+  for(i = 0; i < 2000; i++) {
+    sprintf(key, "key%d", i);
+    elem = croquette_h_get(table, key);
+    assert(elem != NULL && elem->value == i);
+  }
+
+  test_comment("Running 20000 Mixed Operations");
+  assert(croquette_h_clear(table) == C_Success);
+  assert(croquette_h_capacity(table) == 64);
+  exercise_backend(table, 3000, 20000);
+  croquette_delete(table);
+
+  test_comment("Filling Past Half With a 32 Bit Hash (Other Bucket Not Just Bucket ^ 1)");
+  config.hash_fn = hash_low32;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(i = 0; i < 4000; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  assert(croquette_h_stats(table, &stats) == C_Success);
+  assert(stats.size == 4000 && stats.load_permille > 400);
+  croquette_delete(table);
+
+  test_comment("Stashing Keys That Share a Hash Instead of Growing");
+  config.hash_fn = hash_constant;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(i = 0; i < 200; i++) {
+    sprintf(key, "key%d", i);
+    assert(croquette_h_put(table, key, create_elem(key, i)) == C_Success);
+  }
+  assert(croquette_h_stats(table, &stats) == C_Success);
+  assert(stats.size == 200 && stats.capacity == 64 && stats.insert_failures == 192);
+  for(i = 0; i < 200; i++) {
+    sprintf(key, "key%d", i);
+    elem = croquette_h_get(table, key);
+    assert(elem != NULL && elem->value == i);
+  }
+  assert(croquette_h_get(table, "missing") == NULL);
+
+  test_comment("Removing Stashed and Placed Keys");
+  for(i = 0; i < 200; i += 2) {
+    sprintf(key, "key%d", i);
+    assert(croquette_h_remove(table, key) == C_Success);
+  }
+  assert(croquette_h_size(table) == 100);
+  for(i = 0; i < 200; i++) {
+    sprintf(key, "key%d", i);
+    elem = croquette_h_get(table, key);
+    assert((i % 2 == 0) ? elem == NULL : (elem != NULL && elem->value == i));
+  }
+  assert(croquette_h_clear(table) == C_Success && croquette_h_size(table) == 0);
+  assert(croquette_h_get(table, "key1") == NULL);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Tree Bins (chains of colliding Keys converted to trees and back)
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_treeify() {
+  // Test Setup
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int step = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+  config.hash_fn = hash_constant;
+
+  // Testing
+  for(step = 0; step <= 2; step += 2) {
+    config.rehash_step = step;
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    test_comment(step == 0 ? "Flooding One Index with 3000 Keys" :
+                             "Flooding One Index with 3000 Keys (Incremental Rehash)");
+    for(i = 0; i < 3000; i++) {
+      sprintf(key, "flood%d", i);
+      croquette_h_put(table, key, create_elem(key, i));
+    }
+    assert(croquette_h_size(table) == 3000);
+    for(i = 0; i < 3000; i++) {
+      sprintf(key, "flood%d", i);
+      elem = croquette_h_get(table, key);
+      assert(elem != NULL && elem->value == i);
+    }
+    assert(croquette_h_get(table, "flood3000") == NULL);
+
+    test_comment("Updating and Finding Values in the Tree Bin");
+    croquette_h_put(table, "flood7", create_elem("flood7", 7777));
+    elem = croquette_h_get(table, "flood7");
+    assert(elem->value == 7777 && croquette_h_containsValue(table, elem));
+
+    test_comment("Removing Down to 4 Keys (Back to a Chain)");
+    for(i = 4; i < 3000; i++) {
+      sprintf(key, "flood%d", i);
+      assert(croquette_h_remove(table, key) == C_Success);
+      if(i % 500 == 0) {
+        sprintf(key, "flood%d", i + 1);
+        elem = croquette_h_get(table, key);
+        assert(elem != NULL && elem->value == i + 1);
+      }
+    }
+    assert(croquette_h_size(table) == 4);
+    for(i = 0; i < 4; i++) {
+      sprintf(key, "flood%d", i);
+      elem = croquette_h_get(table, key);
+      assert(elem != NULL && elem->value == i);
+    }
+    croquette_delete(table);
+  }
+
+  test_comment("Colliding Keys with a Custom key_equal (Case Insensitive)");
+  config.rehash_step = 0;
+  config.key_equal = equal_nocase;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(i = 0; i < 200; i++) {
+    sprintf(key, "Mixed%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  for(i = 0; i < 200; i++) {
+    sprintf(key, "mIXED%d", i);
+    elem = croquette_h_get(table, key);
+    assert(elem != NULL && elem->value == i);
+  }
+  sprintf(key, "MIXED%d", 50);
+  assert(croquette_h_remove(table, key) == C_Success);
+  assert(croquette_h_size(table) == 199 && croquette_h_get(table, "mixed50") == NULL);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the per instance random seed and the fixed_seed option
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_random_seed() {
+  // Test Setup
+  Croquette_Config_s config;
+  croquette_t *table1 = NULL;
+  croquette_t *table2 = NULL;
+  uint64_t seed1 = 0;
+  uint64_t seed2 = 0;
+  char key[16] = {0};
+  uint32_t half = 0;
+  uint64_t code = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  config.hash_fn = hash_record_seed;
+
+  // Testing
+  test_comment("Checking a Fixed Seed is Passed to the Hash as Given");
+  config.fixed_seed = 1;
+  config.seed = 1234;
+  table1 = croquette_new_config(&config);
+  assert(table1 != NULL);
+  croquette_h_put(table1, "aaa", NULL);
+  assert(recorded_seed == 1234);
+  croquette_delete(table1);
+
+  test_comment("Checking Each Instance Draws its Own Random Seed");
+  config.fixed_seed = 0;
+  table1 = croquette_new_config(&config);
+  table2 = croquette_new_config(&config);
+  assert(table1 != NULL && table2 != NULL);
+  croquette_h_put(table1, "aaa", NULL);
+  seed1 = recorded_seed;
+  croquette_h_put(table2, "aaa", NULL);
+  seed2 = recorded_seed;
+  assert(seed1 != seed2);
+  assert(croquette_h_containsKey(table1, "aaa") == 1);
+  assert(recorded_seed == seed1);
+  croquette_delete(table1);
+  croquette_delete(table2);
+
+  test_comment("Checking Keys Cannot Zero the Hash Multiply (Seed Independent Collisions)");
+  // The first 8 bytes cancel the multiplier constant, which used to erase the seed and the tail
+  half = 0xe7037ed1u;
+  memcpy(key, &half, sizeof(half));
+  half = 0xa0b428dbu;
+  memcpy(key + 4, &half, sizeof(half));
+  code = croquette_hash(key, sizeof(key), CROQUETTE_DEFAULT_SEED);
+  for(i = 1; i < 64; i++) {
+    key[8 + (i & 7)] = (char)i;
+    assert(croquette_hash(key, sizeof(key), CROQUETTE_DEFAULT_SEED) != code);
+  }
+
+  // Test Teardown
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the Bucketized Chaining Backend (64 byte lines of tagged Entries)
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_bucketized() {
+  // Test Setup
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.initial_capacity = 5;
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+  config.backend = C_Backend_Bucketized;
+
+  // Testing
+  test_comment("Checking the Capacity Rounds to a Power of Two and Doubles Past 4 Keys per Index");
+  table = croquette_new_config(&config);
+  assert(table != NULL && croquette_h_capacity(table) == 8);
+  for(i = 0; i < 32; i++) {
+    sprintf(key, "key%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  assert(croquette_h_capacity(table) == 8);
+  croquette_h_put(table, "key32", create_elem("key32", 32));
+  assert(croquette_h_capacity(table) == 16 && croquette_h_size(table) == 33);
+
+  test_comment("Getting, Updating and Missing Keys");
+  elem = croquette_h_get(table, "key9");
+  assert(elem != NULL && elem->value == 9);
+  croquette_h_put(table, "key9", create_elem("key9", 99));
+  elem = croquette_h_get(table, "key9");
+  assert(elem->value == 99 && croquette_h_containsValue(table, elem));
+  assert(croquette_h_get(table, "key33") == NULL);
+
+  test_comment("Running 20000 Mixed Operations");
+  assert(croquette_h_clear(table) == C_Success);
+  assert(croquette_h_size(table) == 0 && croquette_h_capacity(table) == 8);
+  exercise_backend(table, 3000, 20000);
+  croquette_delete(table);
+
+  test_comment("Chaining 200 Colliding Keys Through Overflow Lines (Slab Allocator)");
+  config.hash_fn = hash_constant;
+  config.allocator = C_Alloc_Slab;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(i = 0; i < 200; i++) {
+    sprintf(key, "line%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  for(i = 0; i < 200; i += 3) {
+    sprintf(key, "line%d", i);
+    assert(croquette_h_remove(table, key) == C_Success);
+  }
+  for(i = 0; i < 200; i++) {
+    sprintf(key, "line%d", i);
+    elem = croquette_h_get(table, key);
+    assert((i % 3 == 0) == (elem == NULL));
+    assert(elem == NULL || elem->value == i);
+  }
+  assert(croquette_h_size(table) == 133);
+  assert(croquette_h_clear(table) == C_Success);
+  exercise_backend(table, 300, 5000);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the Compact (Insertion Ordered) Backend and croquette_foreach()
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_compact() {
+  // Test Setup
+  Croquette_Backend_e backends[] = {C_Backend_Chained, C_Backend_RobinHood, C_Backend_Swiss,
+                                    C_Backend_Cuckoo, C_Backend_Bucketized, C_Backend_Compact};
+  Croquette_Config_s config;
+  Visit_Log_s log;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int b = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+
+  // Testing
+  test_comment("Checking foreach Arguments (Error)");
+  assert(croquette_h_foreach(NULL, visit_log, &log) == C_Error && croquette_get_error() == C_Uninitialized);
+  config.backend = C_Backend_Compact;
+  table = croquette_new_config(&config);
+  assert(table != NULL && croquette_h_capacity(table) == 16);
+  assert(croquette_h_foreach(table, NULL, &log) == C_Error && croquette_get_error() == C_Entry_NULL);
+
+  test_comment("Iterating in Insertion Order Across 8, 16 and 32 bit Indices");
+  for(i = 0; i < 40000; i++) {
+    sprintf(key, "order%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+    if(i == 50 || i == 5000 || i == 39999) {
+      memset(&log, 0, sizeof(log));
+      log.in_order = 1;
+      assert(croquette_h_foreach(table, visit_log, &log) == C_Success);
+      assert(log.count == i + 1 && log.in_order && log.last == i);
+    }
+  }
+
+  test_comment("Keeping the Order Through Removals and Rebuilds");
+  for(i = 0; i < 40000; i++) {
+    if(i % 4 != 0) {
+      sprintf(key, "order%d", i);
+      assert(croquette_h_remove(table, key) == C_Success);
+    }
+  }
+  for(i = 40000; i < 50000; i++) {
+    sprintf(key, "order%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  memset(&log, 0, sizeof(log));
+  log.in_order = 1;
+  croquette_h_foreach(table, visit_log, &log);
+  assert(log.count == 20000 && log.in_order && croquette_h_size(table) == 20000);
+  sprintf(key, "order%d", 39996);
+  elem = croquette_h_get(table, key);
+  assert(elem != NULL && elem->value == 39996 && croquette_h_containsValue(table, elem));
+  assert(croquette_h_get(table, "order39997") == NULL);
+
+  test_comment("Updating a Value in Place (Keeps its Position)");
+  croquette_h_put(table, "order0", create_elem("order0", -1));
+  memset(&log, 0, sizeof(log));
+  log.stop_after = 1;
+  croquette_h_foreach(table, visit_log, &log);
+  assert(log.count == 1 && log.last == -1);
+
+  test_comment("Running 20000 Mixed Operations");
+  assert(croquette_h_clear(table) == C_Success);
+  assert(croquette_h_size(table) == 0 && croquette_h_capacity(table) == 16);
+  exercise_backend(table, 3000, 20000);
+  croquette_delete(table);
+
+  test_comment("Visiting Every Entry Once on Every Backend (and Stopping Early)");
+  for(b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+    config.backend = backends[b];
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    for(i = 0; i < 500; i++) {
+      sprintf(key, "visit%d", i);
+      croquette_h_put(table, key, create_elem(key, i));
+    }
+    memset(&log, 0, sizeof(log));
+    assert(croquette_h_foreach(table, visit_log, &log) == C_Success);
+    assert(log.count == 500 && log.value_sum == 499 * 500 / 2);
+    memset(&log, 0, sizeof(log));
+    log.stop_after = 10;
+    assert(croquette_h_foreach(table, visit_log, &log) == C_Success && log.count == 10);
+    croquette_delete(table);
+  }
+
+  // Test Teardown
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test croquette_reserve() and Pinned Capacities on Every Backend
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_reserve() {
+  // Test Setup
+  Croquette_Backend_e backends[] = {C_Backend_Chained, C_Backend_RobinHood, C_Backend_Swiss,
+                                    C_Backend_Cuckoo, C_Backend_Bucketized, C_Backend_Compact};
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int base = 0;
+  int reserved = 0;
+  int b = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+
+  // Testing
+  test_comment("Checking Reserve and Pin Arguments (Error)");
+  assert(croquette_h_reserve(NULL, 10) == C_Error && croquette_get_error() == C_Uninitialized);
+  assert(croquette_h_pin_capacity(NULL) == C_Error && croquette_get_error() == C_Uninitialized);
+  assert(croquette_h_unpin_capacity(NULL) == C_Error && croquette_get_error() == C_Uninitialized);
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  assert(croquette_h_reserve(table, -1) == C_Error && croquette_get_error() == C_Invalid_Capacity);
+  assert(croquette_h_unpin_capacity(table) == C_Success);
+  croquette_delete(table);
+
+  for(b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+    config.backend = backends[b];
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    base = croquette_h_capacity(table);
+
+    test_comment("Reserving 5000 Keys (No Resize While Loading Them)");
+    assert(croquette_h_reserve(table, 5000) == C_Success);
+    reserved = croquette_h_capacity(table);
+    assert(reserved > base);
+    for(i = 0; i < 5000; i++) {
+      sprintf(key, "reserve%d", i);
+      croquette_h_put(table, key, create_elem(key, i));
+      assert(croquette_h_capacity(table) == reserved);
+    }
+    assert(croquette_h_reserve(table, 100) == C_Success && croquette_h_capacity(table) == reserved);
+
+    test_comment("Keeping a Pinned Capacity Through Removals and Clear");
+    assert(croquette_h_pin_capacity(table) == C_Success);
+    for(i = 0; i < 5000; i++) {
+      sprintf(key, "reserve%d", i);
+      assert(croquette_h_remove(table, key) == C_Success);
+    }
+    assert(croquette_h_size(table) == 0 && croquette_h_capacity(table) == reserved);
+    for(i = 0; i < 5000; i++) {
+      sprintf(key, "reload%d", i);
+      croquette_h_put(table, key, create_elem(key, i));
+    }
+    assert(croquette_h_clear(table) == C_Success && croquette_h_capacity(table) == reserved);
+
+    test_comment("Raising the Pinned Floor with Reserve");
+    assert(croquette_h_reserve(table, 20000) == C_Success && croquette_h_capacity(table) > reserved);
+    reserved = croquette_h_capacity(table);
+    assert(croquette_h_clear(table) == C_Success && croquette_h_capacity(table) == reserved);
+
+    test_comment("Unpinning Lets Clear Reset to the Base Capacity");
+    assert(croquette_h_unpin_capacity(table) == C_Success);
+    assert(croquette_h_clear(table) == C_Success && croquette_h_capacity(table) == base);
+    exercise_backend(table, 300, 3000);
+    croquette_delete(table);
+  }
+
+  // Test Teardown
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Configurable Load Factors, auto_shrink and croquette_shrink_to_fit()
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_load_factors() {
+  // Test Setup
+  Croquette_Backend_e backends[] = {C_Backend_Chained, C_Backend_RobinHood, C_Backend_Swiss,
+                                    C_Backend_Cuckoo, C_Backend_Bucketized, C_Backend_Compact};
+  Croquette_Config_s config;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int capacity = 0;
+  int changes = 0;
+  int b = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+
+  // Testing
+  test_comment("Checking Invalid Load Factors (Error)");
+  assert(croquette_h_shrink_to_fit(NULL) == C_Error && croquette_get_error() == C_Uninitialized);
+  config.max_load = 0;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.max_load = 75;
+  config.min_load = 40;    // No gap: halving at 40% would land at 80%, over max_load
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.min_load = -1;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.min_load = C_Default_Min_Load;
+  config.max_load = 90;
+  config.backend = C_Backend_RobinHood;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.backend = C_Backend_Chained;
+
+  test_comment("Growing and Shrinking at Configured Loads (50% and 10%)");
+  config.initial_capacity = 16;
+  config.max_load = 50;
+  config.min_load = 10;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(i = 0; i < 9; i++) {
+    sprintf(key, "load%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+    assert(croquette_h_capacity(table) == ((i < 8) ? 16 : 32));
+  }
+  for(i = 0; i < 6; i++) {
+    sprintf(key, "load%d", i);
+    croquette_h_remove(table, key);
+    assert(croquette_h_capacity(table) == ((i < 5) ? 32 : 16));
+  }
+  croquette_delete(table);
+
+  test_comment("Alternating Insert and Remove at the Growth Threshold (No Thrashing)");
+  config.max_load = C_Default_Max_Load;
+  config.min_load = C_Default_Min_Load;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(i = 0; i < 12; i++) {
+    sprintf(key, "edge%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+  }
+  capacity = croquette_h_capacity(table);
+  for(i = 0; i < 1000; i++) {
+    croquette_h_put(table, "edge", create_elem("edge", i));
+    changes += (croquette_h_capacity(table) != capacity);
+    capacity = croquette_h_capacity(table);
+    croquette_h_remove(table, "edge");
+    changes += (croquette_h_capacity(table) != capacity);
+    capacity = croquette_h_capacity(table);
+  }
+  assert(changes <= 1 && croquette_h_size(table) == 12);
+  croquette_delete(table);
+
+  test_comment("Disabling auto_shrink and Shrinking to Fit on Every Backend");
+  config.initial_capacity = 0;
+  config.auto_shrink = 0;
+  for(b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+    config.backend = backends[b];
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    capacity = croquette_h_capacity(table);
+    for(i = 0; i < 4000; i++) {
+      sprintf(key, "fit%d", i);
+      croquette_h_put(table, key, create_elem(key, i));
+    }
+    assert(croquette_h_capacity(table) > capacity);
+    capacity = croquette_h_capacity(table);
+    for(i = 0; i < 3900; i++) {
+      sprintf(key, "fit%d", i);
+      assert(croquette_h_remove(table, key) == C_Success);
+    }
+    assert(croquette_h_size(table) == 100 && croquette_h_capacity(table) == capacity);
+    assert(croquette_h_shrink_to_fit(table) == C_Success && croquette_h_capacity(table) < capacity);
+    capacity = croquette_h_capacity(table);
+    assert(croquette_h_shrink_to_fit(table) == C_Success && croquette_h_capacity(table) == capacity);
+    for(i = 3900; i < 4000; i++) {
+      sprintf(key, "fit%d", i);
+      elem = croquette_h_get(table, key);
+      assert(elem != NULL && elem->value == i);
+    }
+    assert(croquette_h_clear(table) == C_Success);
+    exercise_backend(table, 300, 3000);
+    croquette_delete(table);
+  }
+
+  // Test Teardown
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Small Map Mode (a linear array until small_size Keys) on Every Backend
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_small_map() {
+  // Test Setup
+  Croquette_Backend_e backends[] = {C_Backend_Chained, C_Backend_RobinHood, C_Backend_Swiss,
+                                    C_Backend_Cuckoo, C_Backend_Bucketized, C_Backend_Compact};
+  Croquette_Config_s config;
+  Visit_Log_s log;
+  croquette_t *table = NULL;
+  Element_s *elem = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int b = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  config.value_compare = compare_elem;
+
+  // Testing
+  test_comment("Checking Invalid Small Sizes (Error)");
+  config.small_size = -1;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.small_size = C_Max_Small_Size + 1;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.small_size = 8;
+
+  for(b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+    config.backend = backends[b];
+    table = croquette_new_config(&config);
+    assert(table != NULL && croquette_h_capacity(table) == 8);
+
+    test_comment("Filling, Updating and Removing Within the Small Map");
+    for(i = 0; i < 8; i++) {
+      sprintf(key, (i % 2) ? "small%d" : "a-much-longer-small-map-key-%d", i);
+      croquette_h_put(table, key, create_elem(key, i));
+    }
+    assert(croquette_h_size(table) == 8 && croquette_h_capacity(table) == 8);
+    croquette_h_put(table, "small3", create_elem("small3", 33));
+    elem = croquette_h_get(table, "small3");
+    assert(elem != NULL && elem->value == 33 && croquette_h_containsValue(table, elem));
+    assert(croquette_h_remove(table, "a-much-longer-small-map-key-2") == C_Success);
+    assert(croquette_h_get(table, "a-much-longer-small-map-key-2") == NULL && croquette_h_size(table) == 7);
+    memset(&log, 0, sizeof(log));
+    log.in_order = 1;
+    assert(croquette_h_foreach(table, visit_log, &log) == C_Success && log.count == 7);
+
+    test_comment("Upgrading Past the Small Size (Every Key Kept)");
+    for(i = 8; i < 200; i++) {
+      sprintf(key, "small%d", i);
+      croquette_h_put(table, key, create_elem(key, i));
+    }
+    assert(croquette_h_size(table) == 199 && croquette_h_capacity(table) != 8);
+    elem = croquette_h_get(table, "small3");
+    assert(elem != NULL && elem->value == 33);
+    elem = croquette_h_get(table, "a-much-longer-small-map-key-6");
+    assert(elem != NULL && elem->value == 6);
+    assert(croquette_h_get(table, "a-much-longer-small-map-key-2") == NULL);
+    if(backends[b] == C_Backend_Compact) {
+      memset(&log, 0, sizeof(log));
+      croquette_h_foreach(table, visit_log, &log);
+      assert(log.count == 199 && log.last == 199);
+    }
+    assert(croquette_h_clear(table) == C_Success);
+    exercise_backend(table, 300, 3000);
+    croquette_delete(table);
+  }
+
+  test_comment("Reusing the Key Arena Across Removals (No Upgrade)");
+  config.backend = C_Backend_Chained;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(i = 0; i < 2000; i++) {
+    sprintf(key, "a-long-churning-key-number-%d", i);
+    croquette_h_put(table, key, create_elem(key, i));
+    if(i >= 4) {
+      sprintf(key, "a-long-churning-key-number-%d", i - 4);
+      assert(croquette_h_remove(table, key) == C_Success);
+    }
+  }
+  assert(croquette_h_size(table) == 4 && croquette_h_capacity(table) == 8);
+  elem = croquette_h_get(table, "a-long-churning-key-number-1997");
+  assert(elem != NULL && elem->value == 1997);
+  assert(croquette_h_clear(table) == C_Success);
+  exercise_backend(table, 6, 2000);
+  assert(croquette_h_capacity(table) == 8);
+  croquette_delete(table);
+
+  test_comment("Upgrading on Reserve (Pinned Capacity Kept as the Floor)");
+  config.initial_capacity = 16;
+  table = croquette_new_config(&config);
+  assert(table != NULL && croquette_h_pin_capacity(table) == C_Success);
+  croquette_h_put(table, "pinned", create_elem("pinned", 1));
+  assert(croquette_h_reserve(table, 1000) == C_Success && croquette_h_capacity(table) >= 1000);
+  elem = croquette_h_get(table, "pinned");
+  assert(elem != NULL && elem->value == 1);
+  assert(croquette_h_clear(table) == C_Success && croquette_h_capacity(table) >= 1000);
+  assert(croquette_h_unpin_capacity(table) == C_Success);
+  assert(croquette_h_clear(table) == C_Success && croquette_h_capacity(table) == 16);
+
+  // Test Teardown
+  croquette_delete(table);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Thread Safe Mode: Readers Never Miss Stable Keys While a Writer Resizes
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_thread_safe() {
+  // Test Setup
+  Croquette_Backend_e backends[] = {C_Backend_Chained, C_Backend_RobinHood, C_Backend_Swiss,
+                                    C_Backend_Cuckoo, C_Backend_Bucketized, C_Backend_Compact};
+  Croquette_Config_s config;
+  Element_s stable[100];
+  Element_s churn;
+  Reader_Args_s args[4];
+  pthread_t readers[4];
+  croquette_t *table = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int count = 0;
+  int setting = 0;
+  int b = 0;
+  int t = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  config.thread_safe = 1;
+  memset(&churn, 0, sizeof(churn));
+  for(i = 0; i < 100; i++) {
+    sprintf(stable[i].name, "stable%d", i);
+    stable[i].value = i;
+  }
+
+  // Testing
+  for(setting = 0; setting < 3; setting++) {
+    for(b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+      if(setting > 0 && backends[b] != C_Backend_Chained) {
+        continue;
+      }
+      test_comment(setting == 0 ? "Reading While Growing and Shrinking" :
+                   setting == 1 ? "Reading While Growing and Shrinking (Incremental Rehash)" :
+                                  "Reading While Growing and Shrinking (Small Map Upgrade)");
+      config.backend = backends[b];
+      config.rehash_step = (setting == 1) ? 4 : 0;
+      config.small_size = (setting == 2) ? 16 : 0;
+      count = (setting == 2) ? 8 : 100;  // A small map stays small until the churn upgrades it under the readers
+      table = croquette_new_config(&config);
+      assert(table != NULL);
+      for(i = 0; i < count; i++) {
+        croquette_h_put(table, stable[i].name, &stable[i]);
+      }
+      for(t = 0; t < 4; t++) {
+        args[t].table = table;
+        args[t].elems = stable;
+        args[t].count = count;
+        args[t].rounds = 200 * 100 / count;
+        args[t].misses = 0;
+        args[t].started = 0;
+        assert(pthread_create(&readers[t], NULL, reader_thread, &args[t]) == 0);
+      }
+      for(t = 0; t < 4; t++) {
+        while(!__atomic_load_n(&args[t].started, __ATOMIC_ACQUIRE)) {
+          sched_yield();
+        }
+      }
+      for(i = 0; i < 20000; i++) {
+        sprintf(key, "churn%d", i % 3000);
+        if((i / 3000) % 2 == 0) {
+          croquette_h_put(table, key, &churn);
+        }
+        else {
+          croquette_h_remove(table, key);
+        }
+      }
+      for(t = 0; t < 4; t++) {
+        assert(pthread_join(readers[t], NULL) == 0);
+        assert(args[t].misses == 0);
+      }
+      for(i = 0; i < count; i++) {
+        assert(croquette_h_get(table, stable[i].name) == &stable[i]);
+      }
+      croquette_delete(table);
+    }
+  }
+
+  // Test Teardown
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Segmented Croquettes: Routing, Totals Across Segments and Parallel Writers
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_segments() {
+  // Test Setup
+  Croquette_Backend_e backends[] = {C_Backend_Chained, C_Backend_RobinHood, C_Backend_Swiss,
+                                    C_Backend_Cuckoo, C_Backend_Bucketized, C_Backend_Compact};
+  int bad_segments[] = {-1, 3, 2048};
+  Croquette_Config_s config;
+  Croquette_Stats_s stats;
+  Visit_Log_s log;
+  Element_s elems[1000];
+  Element_s stable[100];
+  Writer_Args_s writers[4];
+  Reader_Args_s readers[2];
+  pthread_t threads[6];
+  croquette_t *table = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int b = 0;
+  int t = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  for(i = 0; i < 1000; i++) {
+    sprintf(elems[i].name, "key%d", i);
+    elems[i].value = i;
+  }
+  for(i = 0; i < 100; i++) {
+    sprintf(stable[i].name, "stable%d", i);
+    stable[i].value = i;
+  }
+
+  // Testing
+  test_comment("Rejecting Segment Counts that are not Powers of Two up to C_Max_Segments");
+  for(i = 0; i < sizeof(bad_segments) / sizeof(bad_segments[0]); i++) {
+    config.segments = bad_segments[i];
+    assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  }
+  config.segments = 8;
+  config.backend = C_Backend_Swiss;
+  config.rehash_step = 4;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.rehash_step = 0;
+
+  for(b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+    test_comment("Spreading Keys over Segments and Totalling Across Them");
+    config.backend = backends[b];
+    config.segments = 8;
+    config.initial_capacity = 64;
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    assert(croquette_h_isEmpty(table) == 1 && croquette_h_capacity(table) >= 64);
+    for(i = 0; i < 1000; i++) {
+      assert(croquette_h_put(table, elems[i].name, &elems[i]) == C_Success);
+    }
+    assert(croquette_h_size(table) == 1000 && croquette_h_isEmpty(table) == 0);
+    for(i = 0; i < 1000; i++) {
+      assert(croquette_h_get(table, elems[i].name) == &elems[i]);
+    }
+    assert(croquette_h_containsValue(table, &elems[999]) == 1);
+    assert(croquette_h_putIfAbsent(table, elems[5].name, &elems[6]) == &elems[5]);
+    assert(croquette_h_stats(table, &stats) == C_Success);
+    assert(stats.size == 1000 && stats.inserts == 1000 && stats.capacity == croquette_h_capacity(table));
+
+    test_comment("Visiting Every Segment, and Stopping Early Across Segments");
+    memset(&log, 0, sizeof(log));
+    assert(croquette_h_foreach(table, visit_log, &log) == C_Success);
+    assert(log.count == 1000 && log.value_sum == 999L * 1000 / 2);
+    memset(&log, 0, sizeof(log));
+    log.stop_after = 700;
+    assert(croquette_h_foreach(table, visit_log, &log) == C_Success && log.count == 700);
+
+    test_comment("Removing, Reserving and Clearing Every Segment");
+    for(i = 0; i < 1000; i += 2) {
+      assert(croquette_h_remove(table, elems[i].name) == C_Success);
+    }
+    assert(croquette_h_size(table) == 500 && croquette_h_containsKey(table, elems[0].name) == 0);
+    assert(croquette_h_clear(table) == C_Success && croquette_h_size(table) == 0);
+    i = croquette_h_capacity(table);
+    assert(croquette_h_reserve(table, 4000) == C_Success && croquette_h_capacity(table) > i);
+    assert(croquette_h_shrink_to_fit(table) == C_Success && croquette_h_capacity(table) <= i);
+    croquette_delete(table);
+
+    config.do_free = C_Do_Free;
+    config.free_value = free_elem;
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    exercise_backend(table, 3000, 20000);
+    croquette_delete(table);
+    config.do_free = C_No_Free;
+    config.free_value = NULL;
+  }
+
+  test_comment("Parallel Writers on Different Keys Next to Readers of Stable Keys");
+  config.backend = C_Backend_Chained;
+  config.initial_capacity = 0;
+  for(config.segments = 1; config.segments <= 64; config.segments *= 8) {
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    for(i = 0; i < 100; i++) {
+      croquette_h_put(table, stable[i].name, &stable[i]);
+    }
+    for(t = 0; t < 4; t++) {
+      writers[t].table = table;
+      writers[t].elems = elems;
+      writers[t].id = t;
+      writers[t].count = 1000;
+      assert(pthread_create(&threads[t], NULL, writer_thread, &writers[t]) == 0);
+    }
+    for(t = 0; t < 2; t++) {
+      readers[t].table = table;
+      readers[t].elems = stable;
+      readers[t].count = 100;
+      readers[t].rounds = 100;
+      readers[t].misses = 0;
+      assert(pthread_create(&threads[4 + t], NULL, reader_thread, &readers[t]) == 0);
+    }
+    for(t = 0; t < 6; t++) {
+      assert(pthread_join(threads[t], NULL) == 0);
+    }
+    assert(readers[0].misses == 0 && readers[1].misses == 0);
+    assert(croquette_h_size(table) == 100 + 4 * 500);
+    for(t = 0; t < 4; t++) {
+      for(i = 0; i < 1000; i++) {
+        sprintf(key, "w%d_%d", t, i);
+        assert(croquette_h_get(table, key) == ((i % 2 == 0) ? &elems[i] : NULL));
+      }
+    }
+    croquette_delete(table);
+  }
+
+  // Test Teardown
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test Lock-Free Reads: Readers Never Miss Stable Keys While Writers Resize and Reclaim
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_lock_free_reads() {
+  // Test Setup
+  Croquette_Config_s config;
+  Element_s stable[100];
+  Element_s churn;
+  Reader_Args_s args[4];
+  pthread_t readers[4];
+  croquette_t *table = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int setting = 0;
+  int t = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  config.lock_free_reads = 1;
+  memset(&churn, 0, sizeof(churn));
+  for(i = 0; i < 100; i++) {
+    sprintf(stable[i].name, "stable%d", i);
+    stable[i].value = i;
+  }
+
+  // Testing
+  test_comment("Rejecting Backends and Modes that Move Entries Under Readers");
+  config.backend = C_Backend_Swiss;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.backend = C_Backend_Chained;
+  config.rehash_step = 4;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.rehash_step = 0;
+  config.small_size = 8;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.small_size = 0;
+
+  test_comment("Running the Backend Checks with Deferred Frees (malloc and Slab)");
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  for(setting = 0; setting < 2; setting++) {
+    config.allocator = (setting == 0) ? C_Alloc_Malloc : C_Alloc_Slab;
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    exercise_backend(table, 3000, 20000);
+    assert(croquette_h_put(table, "kept", create_elem("kept", 1)) == C_Success);
+    assert(croquette_h_reserve(table, 5000) == C_Success && croquette_h_capacity(table) >= 6000);
+    assert(((Element_s *)croquette_h_get(table, "kept"))->value == 1);
+    assert(croquette_h_shrink_to_fit(table) == C_Success && croquette_h_containsKey(table, "kept") == 1);
+    croquette_delete(table);
+  }
+  config.do_free = C_No_Free;
+  config.free_value = NULL;
+  config.allocator = C_Alloc_Malloc;
+
+  for(setting = 0; setting < 3; setting++) {
+    test_comment(setting == 0 ? "Reading Without Locks While Growing and Shrinking" :
+                 setting == 1 ? "Reading Without Locks While Growing and Shrinking (Power of Two)" :
+                                "Reading Without Locks While Growing and Shrinking (Segmented)");
+    config.capacity_mode = (setting == 1) ? C_Capacity_Pow2 : C_Capacity_Exact;
+    config.segments = (setting == 2) ? 4 : 0;
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    for(i = 0; i < 100; i++) {
+      croquette_h_put(table, stable[i].name, &stable[i]);
+    }
+    for(t = 0; t < 4; t++) {
+      args[t].table = table;
+      args[t].elems = stable;
+      args[t].count = 100;
+      args[t].rounds = 200;
+      args[t].misses = 0;
+      assert(pthread_create(&readers[t], NULL, reader_thread, &args[t]) == 0);
+    }
+    for(i = 0; i < 20000; i++) {
+      sprintf(key, "churn%d", i % 3000);
+      if((i / 3000) % 2 == 0) {
+        croquette_h_put(table, key, &churn);
+      }
+      else {
+        croquette_h_remove(table, key);
+      }
+      if(i % 5000 == 4999) {
+        croquette_h_put(table, stable[i % 100].name, &stable[i % 100]);
+      }
+    }
+    for(t = 0; t < 4; t++) {
+      assert(pthread_join(readers[t], NULL) == 0);
+      assert(args[t].misses == 0);
+    }
+    for(i = 0; i < 100; i++) {
+      assert(croquette_h_get(table, stable[i].name) == &stable[i]);
+    }
+    assert(croquette_h_clear(table) == C_Success && croquette_h_get(table, stable[0].name) == NULL);
+    croquette_delete(table);
+  }
+
+  // Test Teardown
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the Split-Ordered Backend: Non-Blocking Operations Stay Linearizable While it Grows
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_split_ordered() {
+  // Test Setup
+  Croquette_Config_s config;
+  Race_Args_s args[4];
+  Writer_Args_s writers[4];
+  pthread_t threads[4];
+  Element_s *elems = calloc(4 * 2000, sizeof(Element_s));
+  int *won = calloc(4 * 2000, sizeof(int));
+  croquette_t *table = NULL;
+  Visit_Log_s log;
+  char key[MAX_NAME_LEN] = {0};
+  int capacity = 0;
+  int phase = 0;
+  int setting = 0;
+  int winners = 0;
+  int t = 0;
+  int i = 0;
+
+  assert(elems != NULL && won != NULL);
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  config.backend = C_Backend_SplitOrdered;
+  for(i = 0; i < 4 * 2000; i++) {
+    sprintf(elems[i].name, "elem%d", i);
+    elems[i].value = i;
+  }
+
+  // Testing
+  test_comment("Rejecting a Small Map in Front of a Non-Blocking Backend");
+  config.small_size = 8;
+  assert(croquette_new_config(&config) == NULL && croquette_get_error() == C_Invalid_Config);
+  config.small_size = 0;
+
+  test_comment("Running the Backend Checks with Deferred Frees");
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  exercise_backend(table, 3000, 20000);
+  croquette_delete(table);
+  config.do_free = C_No_Free;
+  config.free_value = NULL;
+
+  test_comment("Growing by Reserve Only (Shrink to Fit and Clear Keep the Buckets)");
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  capacity = croquette_h_capacity(table);
+  assert(croquette_h_reserve(table, 5000) == C_Success && croquette_h_capacity(table) > capacity);
+  capacity = croquette_h_capacity(table);
+  for(i = 0; i < 1000; i++) {
+    assert(croquette_h_put(table, elems[i].name, &elems[i]) == C_Success);
+  }
+  assert(croquette_h_shrink_to_fit(table) == C_Success && croquette_h_capacity(table) == capacity);
+  memset(&log, 0, sizeof(log));
+  assert(croquette_h_foreach(table, visit_log, &log) == C_Success);
+  assert(log.count == 1000 && log.value_sum == 999L * 1000 / 2);
+  assert(croquette_h_containsValue(table, &elems[500]) == 1);
+  assert(croquette_h_putIfAbsent(table, elems[7].name, &elems[8]) == &elems[7]);
+  assert(croquette_h_clear(table) == C_Success && croquette_h_isEmpty(table) == 1);
+  assert(croquette_h_capacity(table) == capacity && croquette_h_get(table, elems[7].name) == NULL);
+  croquette_delete(table);
+
+  test_comment("Racing putIfAbsent: Exactly One Winner per Key, and its Value Stays");
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(t = 0; t < 4; t++) {
+    args[t].table = table;
+    args[t].elems = &elems[t * 2000];
+    args[t].won = &won[t * 2000];
+    args[t].count = 2000;
+    assert(pthread_create(&threads[t], NULL, race_thread, &args[t]) == 0);
+  }
+  for(t = 0; t < 4; t++) {
+    assert(pthread_join(threads[t], NULL) == 0);
+  }
+  assert(croquette_h_size(table) == 2000);
+  for(i = 0; i < 2000; i++) {
+    sprintf(key, "race%d", i);
+    winners = 0;
+    for(t = 0; t < 4; t++) {
+      if(won[t * 2000 + i]) {
+        winners++;
+        assert(croquette_h_get(table, key) == &elems[t * 2000 + i]);
+      }
+    }
+    assert(winners == 1);
+  }
+  croquette_delete(table);
+
+  test_comment("Reading Ordered Inserts and Removes Only in Their Order");
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(t = 0; t < 3; t++) {
+    args[t].table = table;
+    args[t].phase = &phase;
+    args[t].count = 3000;
+    args[t].violations = 0;
+    assert(pthread_create(&threads[t], NULL, order_reader, &args[t]) == 0);
+  }
+  for(i = 0; i < 3000; i++) {
+    sprintf(key, "order%d", i);
+    assert(croquette_h_put(table, key, &elems[i]) == C_Success);
+  }
+  __atomic_store_n(&phase, 1, __ATOMIC_SEQ_CST);
+  for(i = 0; i < 3000; i++) {
+    sprintf(key, "order%d", i);
+    assert(croquette_h_remove(table, key) == C_Success);
+  }
+  __atomic_store_n(&phase, 2, __ATOMIC_SEQ_CST);
+  for(t = 0; t < 3; t++) {
+    assert(pthread_join(threads[t], NULL) == 0);
+    assert(args[t].violations == 0);
+  }
+  assert(croquette_h_isEmpty(table) == 1);
+  croquette_delete(table);
+
+  for(setting = 0; setting < 2; setting++) {
+    test_comment(setting == 0 ? "Writing from Several Threads While the Buckets Double" :
+                                "Writing from Several Threads While the Buckets Double (Segmented)");
+    config.initial_capacity = 1;
+    config.segments = (setting == 1) ? 4 : 0;
+    table = croquette_new_config(&config);
+    assert(table != NULL);
+    for(t = 0; t < 4; t++) {
+      writers[t].table = table;
+      writers[t].elems = elems;
+      writers[t].id = t;
+      writers[t].count = 2000;
+      assert(pthread_create(&threads[t], NULL, writer_thread, &writers[t]) == 0);
+    }
+    for(t = 0; t < 4; t++) {
+      assert(pthread_join(threads[t], NULL) == 0);
+    }
+    assert(croquette_h_size(table) == 4 * 1000);
+    for(t = 0; t < 4; t++) {
+      for(i = 0; i < 2000; i++) {
+        sprintf(key, "w%d_%d", t, i);
+        assert(croquette_h_get(table, key) == ((i % 2 == 0) ? &elems[i] : NULL));
+      }
+    }
+    croquette_delete(table);
+  }
+  config.initial_capacity = C_Default_Capacity;
+  config.segments = 0;
+
+  test_comment("Replacing and Removing the Same Keys from Several Threads (Deferred Frees)");
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+  table = croquette_new_config(&config);
+  assert(table != NULL);
+  for(t = 0; t < 4; t++) {
+    args[t].table = table;
+    args[t].count = 16;
+    args[t].rounds = 20000;
+    assert(pthread_create(&threads[t], NULL, update_thread, &args[t]) == 0);
+  }
+  for(t = 0; t < 4; t++) {
+    assert(pthread_join(threads[t], NULL) == 0);
+  }
+  assert(croquette_h_size(table) <= 16);
+  croquette_delete(table);
+
+  // Test Teardown
+  free(elems);
+  free(won);
+  return Test_Success;
+}
+
+/**
+ * @brief Function to Test the Sharded Facade: Shards Resize on Their Own and Whole-Map Functions Fan Out
+ *
+ * @return Test_Success or Test_Failure
+ */
+static int test_croquette_sharded() {
+  // Test Setup
+  Croquette_Config_s config;
+  Croquette_Stats_s stats;
+  Croquette_Stats_s total;
+  Element_s *elem = NULL;
+  croquette_t *table = NULL;
+  char key[MAX_NAME_LEN] = {0};
+  int resized = 0;
+  int shard = 0;
+  int i = 0;
+
+  croquette_config_init(&config);
+  config.value_compare = compare_elem;
+  config.do_free = C_Do_Free;
+  config.free_value = free_elem;
+
+  // Testing
+  test_comment("Rejecting Shard Counts that are not a Power of Two from 1 to C_Max_Segments");
+  assert(croquette_sharded_new(8, NULL) == NULL && croquette_get_error() == C_Invalid_Config);
+  assert(croquette_sharded_new(0, &config) == NULL && croquette_get_error() == C_Invalid_Config);
+  assert(croquette_sharded_new(-4, &config) == NULL && croquette_get_error() == C_Invalid_Config);
+  assert(croquette_sharded_new(6, &config) == NULL && croquette_get_error() == C_Invalid_Config);
+  assert(croquette_sharded_new(2 * C_Max_Segments, &config) == NULL && croquette_get_error() == C_Invalid_Config);
+
+  test_comment("Reporting an Unsharded Croquette as One Shard");
+  table = croquette_new_config(&config);
+  assert(table != NULL && croquette_h_shard_count(table) == 1);
+  assert(croquette_h_put(table, "one", create_elem("one", 1)) == C_Success);
+  assert(croquette_h_shard_stats(table, 0, &stats) == C_Success && stats.size == 1);
+  assert(croquette_h_shard_stats(table, 1, &stats) == C_Error && croquette_get_error() == C_Invalid_Index);
+  croquette_delete(table);
+
+  test_comment("Routing Keys to 8 Shards, Each with its Own Slab and Incremental Rehash");
+  config.allocator = C_Alloc_Slab;
+  config.rehash_step = 4;
+  config.initial_capacity = 64;
+  table = croquette_sharded_new(8, &config);
+  assert(table != NULL && croquette_h_shard_count(table) == 8 && config.segments == 0);
+  for(i = 0; i < 8000; i++) {
+    sprintf(key, "shard%d", i);
+    assert(croquette_h_put(table, key, create_elem(key, i)) == C_Success);
+  }
+  memset(&total, 0, sizeof(total));
+  for(shard = 0; shard < 8; shard++) {
+    assert(croquette_h_shard_stats(table, shard, &stats) == C_Success);
+    assert(stats.size > 0 && stats.size < 8000 / 4);
+    resized += (stats.capacity > 64 / 8);
+    total.size += stats.size;
+    total.capacity += stats.capacity;
+    total.inserts += stats.inserts;
+  }
+  assert(resized == 8);
+  assert(total.size == croquette_h_size(table) && total.size == 8000 && total.inserts == 8000);
+  assert(total.capacity == croquette_h_capacity(table));
+  assert(croquette_h_shard_stats(table, 8, &stats) == C_Error && croquette_get_error() == C_Invalid_Index);
+
+  test_comment("Fanning Out containsValue, remove and clear Across the Shards");
+  elem = croquette_h_get(table, "shard4321");
+  assert(elem != NULL && elem->value == 4321 && croquette_h_containsValue(table, elem) == 1);
+  assert(croquette_h_remove(table, "shard4321") == C_Success && croquette_h_size(table) == 7999);
+  assert(croquette_h_clear(table) == C_Success && croquette_h_isEmpty(table) == 1);
+  for(shard = 0; shard < 8; shard++) {
+    assert(croquette_h_shard_stats(table, shard, &stats) == C_Success && stats.size == 0);
+  }
+  croquette_delete(table);
+
+  // Test Teardown
+  return Test_Success;
+}